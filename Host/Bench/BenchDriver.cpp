@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#include "fw_log.h"
+#include "fw_assert.h"
+#include "BenchInterface.h"
+#include "BenchDriver.h"
+
+FW_DEFINE_THIS_FILE("BenchDriver.cpp")
+
+namespace APP {
+
+#undef ADD_EVT
+#define ADD_EVT(e_) #e_,
+
+static char const * const internalEvtName[] = {
+    "BENCH_INTERNAL_EVT_START",
+    BENCH_INTERNAL_EVT
+};
+
+static char const * const interfaceEvtName[] = {
+    "BENCH_INTERFACE_EVT_START",
+    BENCH_INTERFACE_EVT
+};
+
+extern constexpr EvtSet EVT_SET(BENCH)(NULL, 0, internalEvtName, ARRAY_COUNT(internalEvtName),
+                                       interfaceEvtName, ARRAY_COUNT(interfaceEvtName));
+
+static char const * const scenarioName[] = {
+    "pingpong",
+    "fanout",
+    "region",
+    "xthread"
+};
+
+char const *BenchDriver::GetScenarioName(BenchScenario scenario) {
+    FW_ASSERT(scenario < ARRAY_COUNT(scenarioName));
+    return scenarioName[scenario];
+}
+
+BenchDriver::BenchDriver() :
+    Active((QStateHandler)&BenchDriver::InitialPseudoState, BENCH, "BENCH"),
+    m_scenario(BENCH_PING_PONG), m_roundCount(0), m_round(0), m_pending(0), m_startNs(0) {}
+
+void BenchDriver::SendRound() {
+    switch (m_scenario) {
+        case BENCH_PING_PONG: {
+            Send(new BenchPingReq(), BENCH_PONG);
+            m_pending = 1;
+            break;
+        }
+        case BENCH_FAN_OUT: {
+            for (uint32_t i = 0; i < BENCH_FAN_COUNT; i++) {
+                Send(new BenchPingReq(), BENCH_FAN + i);
+            }
+            m_pending = BENCH_FAN_COUNT;
+            break;
+        }
+        case BENCH_REGION: {
+            for (uint32_t i = 0; i < BENCH_ROUTE_REG_COUNT; i++) {
+                Send(new BenchPingReq(), BENCH_ROUTE_REG + i);
+            }
+            m_pending = BENCH_ROUTE_REG_COUNT;
+            break;
+        }
+        case BENCH_XTHREAD: {
+            Send(new BenchPingReq(), BENCH_XTHREAD_REG);
+            m_pending = 1;
+            break;
+        }
+        default: FW_ASSERT(0); break;
+    }
+}
+
+QState BenchDriver::InitialPseudoState(BenchDriver * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN(&BenchDriver::Root);
+}
+
+QState BenchDriver::Root(BenchDriver * const me, QEvt const * const e) {
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+        case Q_EXIT_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+        case Q_INIT_SIG: {
+            return Q_TRAN(&BenchDriver::Idle);
+        }
+    }
+    return Q_SUPER(&QHsm::top);
+}
+
+QState BenchDriver::Idle(BenchDriver * const me, QEvt const * const e) {
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+        case Q_EXIT_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+        case BENCH_START_REQ: {
+            EVENT(e);
+            BenchStartReq const &req = static_cast<BenchStartReq const &>(*e);
+            me->m_scenario = req.GetScenario();
+            me->m_roundCount = req.GetRoundCount();
+            return Q_TRAN(&BenchDriver::Running);
+        }
+        case BENCH_STOP_REQ: {
+            EVENT(e);
+            QF::stop();
+            return Q_HANDLED();
+        }
+    }
+    return Q_SUPER(&BenchDriver::Root);
+}
+
+QState BenchDriver::Running(BenchDriver * const me, QEvt const * const e) {
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            EVENT(e);
+            // Each round trip produces two events (request and response).
+            me->m_stat.Reset(me->m_roundCount * BENCH_FAN_COUNT * 2);
+            me->m_round = 0;
+            me->m_startNs = GetNs();
+            me->SendRound();
+            return Q_HANDLED();
+        }
+        case Q_EXIT_SIG: {
+            EVENT(e);
+            me->Recall();
+            return Q_HANDLED();
+        }
+        case BENCH_START_REQ:
+        case BENCH_STOP_REQ: {
+            EVENT(e);
+            me->Defer(e);
+            return Q_HANDLED();
+        }
+        case BENCH_PING_RSP: {
+            uint64_t dispatchNs = GetNs();
+            EVENT(e);
+            BenchPingRsp const &rsp = static_cast<BenchPingRsp const &>(*e);
+            me->m_stat.Add(rsp.GetReqPostNs(), rsp.GetReqDispatchNs());
+            me->m_stat.Add(rsp.GetPostNs(), dispatchNs);
+            FW_ASSERT(me->m_pending > 0);
+            if (--me->m_pending == 0) {
+                if (++me->m_round < me->m_roundCount) {
+                    me->SendRound();
+                } else {
+                    me->m_stat.Report(GetScenarioName(me->m_scenario), GetNs() - me->m_startNs);
+                    me->Raise(new Evt(DONE));
+                }
+            }
+            return Q_HANDLED();
+        }
+        case DONE: {
+            EVENT(e);
+            return Q_TRAN(&BenchDriver::Idle);
+        }
+    }
+    return Q_SUPER(&BenchDriver::Root);
+}
+
+} // namespace APP
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef BENCH_DRIVER_H
+#define BENCH_DRIVER_H
+
+#include "qpcpp.h"
+#include "fw_active.h"
+#include "fw_evt.h"
+#include "bench_hsmn.h"
+#include "BenchInterface.h"
+#include "BenchStat.h"
+
+using namespace QP;
+using namespace FW;
+
+namespace APP {
+
+// Runs benchmark scenarios requested by BENCH_START_REQ, one at a time.
+// BENCH_STOP_REQ stops the framework (QF::run() returns) after all pending scenarios are done.
+class BenchDriver : public Active {
+public:
+    BenchDriver();
+    static char const *GetScenarioName(BenchScenario scenario);
+
+protected:
+    static QState InitialPseudoState(BenchDriver * const me, QEvt const * const e);
+    static QState Root(BenchDriver * const me, QEvt const * const e);
+        static QState Idle(BenchDriver * const me, QEvt const * const e);
+        static QState Running(BenchDriver * const me, QEvt const * const e);
+
+    void SendRound();
+
+    BenchScenario m_scenario;
+    uint32_t m_roundCount;
+    uint32_t m_round;
+    uint32_t m_pending;         // Number of BENCH_PING_RSP outstanding in current round.
+    uint64_t m_startNs;
+    LatencyStat m_stat;
+
+#define BENCH_INTERNAL_EVT \
+    ADD_EVT(DONE)
+
+#undef ADD_EVT
+#define ADD_EVT(e_) e_,
+
+    enum {
+        BENCH_INTERNAL_EVT_START = INTERNAL_EVT_START(BENCH),
+        BENCH_INTERNAL_EVT
+    };
+};
+
+} // namespace APP
+
+#endif // BENCH_DRIVER_H
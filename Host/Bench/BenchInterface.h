@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef BENCH_INTERFACE_H
+#define BENCH_INTERFACE_H
+
+#include "fw_def.h"
+#include "fw_evt.h"
+#include "bench_hsmn.h"
+#include "BenchStat.h"
+
+using namespace QP;
+using namespace FW;
+
+namespace APP {
+
+#define BENCH_INTERFACE_EVT \
+    ADD_EVT(BENCH_START_REQ) \
+    ADD_EVT(BENCH_STOP_REQ) \
+    ADD_EVT(BENCH_PING_REQ) \
+    ADD_EVT(BENCH_PING_RSP)
+
+#undef ADD_EVT
+#define ADD_EVT(e_) e_,
+
+enum {
+    BENCH_INTERFACE_EVT_START = INTERFACE_EVT_START(BENCH),
+    BENCH_INTERFACE_EVT
+};
+
+enum BenchScenario {
+    BENCH_PING_PONG,        // One event in flight between two active objects.
+    BENCH_FAN_OUT,          // One event to each of BENCH_FAN_COUNT active objects per round.
+    BENCH_REGION,           // One event to each of BENCH_ROUTE_REG_COUNT regions of the same active object per round.
+    BENCH_XTHREAD,          // One event in flight to a region of an extended thread.
+    BENCH_SCENARIO_COUNT
+};
+
+class BenchStartReq : public Evt {
+public:
+    BenchStartReq(BenchScenario scenario, uint32_t roundCount) :
+        Evt(BENCH_START_REQ, BENCH), m_scenario(scenario), m_roundCount(roundCount) {}
+    BenchScenario GetScenario() const { return m_scenario; }
+    uint32_t GetRoundCount() const { return m_roundCount; }
+private:
+    BenchScenario m_scenario;
+    uint32_t m_roundCount;
+};
+
+class BenchStopReq : public Evt {
+public:
+    BenchStopReq() :
+        Evt(BENCH_STOP_REQ, BENCH) {}
+};
+
+// Timestamps are taken when an event is constructed (right before it is posted) and when it is dispatched.
+class BenchPingReq : public Evt {
+public:
+    BenchPingReq() :
+        Evt(BENCH_PING_REQ), m_postNs(GetNs()) {}
+    uint64_t GetPostNs() const { return m_postNs; }
+private:
+    uint64_t m_postNs;
+};
+
+class BenchPingRsp : public Evt {
+public:
+    BenchPingRsp(uint64_t reqPostNs, uint64_t reqDispatchNs) :
+        Evt(BENCH_PING_RSP), m_reqPostNs(reqPostNs), m_reqDispatchNs(reqDispatchNs), m_postNs(GetNs()) {}
+    uint64_t GetReqPostNs() const { return m_reqPostNs; }
+    uint64_t GetReqDispatchNs() const { return m_reqDispatchNs; }
+    uint64_t GetPostNs() const { return m_postNs; }
+private:
+    uint64_t m_reqPostNs;
+    uint64_t m_reqDispatchNs;
+    uint64_t m_postNs;
+};
+
+} // namespace APP
+
+#endif // BENCH_INTERFACE_H
@@ -0,0 +1,255 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host benchmark of the event framework. It measures event throughput, post-to-dispatch
+// latency and event pool usage for a set of messaging patterns, using the same event pools
+// as the target (see Fw::Init()).
+//
+// Usage: fw_bench [-n roundCount] [pingpong|fanout|region|xthread ...]
+// All scenarios are run if none is specified.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "qpcpp.h"
+#include "fw.h"
+#include "fw_log.h"
+#include "fw_prof.h"
+#include "fw_assert.h"
+#include "bench_hsmn.h"
+#include "BenchInterface.h"
+#include "BenchDriver.h"
+#include "BenchTarget.h"
+
+FW_DEFINE_THIS_FILE("BenchMain.cpp")
+
+using namespace FW;
+using namespace APP;
+
+// Reports event pool usage, and event sizes per signal when built with -DFW_POOL_STAT=ON.
+// The format is the same as "sys pool" on the target so it can be passed to PoolSize.py.
+static void ReportPool() {
+    printf("Event pools (min free is since startup):\n");
+    printf("%-4s %2s %6s %6s %8s %8s %10s %6s\n", "", "id", "size", "count", "min free", "max used", "alloc", "fail");
+    for (uint8_t id = 1; id <= Fw::GetPoolCount(); id++) {
+        Fw::PoolUsage usage;
+        Fw::GetPoolUsage(id, usage);
+        printf("pool %2u %6u %6u %8u %8u %10u %6u\n", id, usage.blockSize, usage.blockCount, usage.minFree,
+               usage.blockCount - usage.minFree, usage.allocCount, usage.failCount);
+    }
+    Payload::Usage payload;
+    Payload::GetUsage(payload);
+    printf("payload %6u %6u %8u %8u %10u %6u\n", Payload::BUF_SIZE, Payload::GetBufCount(), payload.minFree,
+           Payload::GetBufCount() - payload.minFree, payload.allocCount, payload.failCount);
+#ifdef ENABLE_FW_POOL_STAT
+    printf("used=%u/%u dropped=%u\n", PoolStat::GetUsedCount(), PoolStat::GetTotalCount(), PoolStat::GetDropCount());
+    printf("%-3s %-28s %6s %6s %10s\n", "", "event", "min", "max", "count");
+    for (uint32_t i = 0; i < PoolStat::GetTotalCount(); i++) {
+        QSignal sig;
+        PoolStat::Stat stat;
+        if (PoolStat::Get(i, sig, stat)) {
+            printf("sig %-28s %6u %6u %10u\n", Log::GetEvtName(sig), stat.m_minSize, stat.m_maxSize, stat.m_count);
+            printf("%-3s", "");
+            for (uint32_t b = 0; b < PoolStat::Stat::BIN_COUNT; b++) {
+                if (stat.GetBin(b)) {
+                    printf(" %u-%u:%u", PoolStat::Stat::GetBinLow(b), PoolStat::Stat::GetBinHigh(b), stat.GetBin(b));
+                }
+            }
+            printf("\n");
+        }
+    }
+#endif
+}
+
+// Reports the framework RAM footprint of each HSM (see ActiveT and RegionT), in the same format as "sys ram".
+static void ReportRam() {
+    uint32_t total = 0;
+    printf("Framework RAM per HSM:\n");
+    printf("%2s %-24s %6s %5s %8s %4s\n", "", "hsm", "ram", "defer", "reminder", "seq");
+    for (Hsmn hsmn = HSM_UNDEF + 1; hsmn < MAX_HSM_COUNT; hsmn++) {
+        Hsm *hsm = Fw::GetHsm(hsmn);
+        if (hsm && hsm->GetRamSize()) {
+            printf("%2u %-24s %6u %5u %8u %4u\n", hsmn, hsm->GetName(), hsm->GetRamSize(), hsm->GetDeferQueueCount(),
+                   hsm->GetReminderQueueCount(), hsm->GetEvtSeqCount());
+            total += hsm->GetRamSize();
+        }
+    }
+    printf("total=%u\n", total);
+}
+
+// Reports the number of events dispatched to each HSM across all scenarios.
+static void ReportDispatch() {
+    printf("Dispatch count per HSM:\n");
+    for (Hsmn hsmn = HSM_UNDEF + 1; hsmn < MAX_HSM_COUNT; hsmn++) {
+        Hsm *hsm = Fw::GetHsm(hsmn);
+        if (hsm) {
+            printf("  %2u %-20s %10u\n", hsmn, hsm->GetName(), hsm->GetDispatchCount());
+        }
+    }
+    Fw::NotInQStat stat = Fw::GetNotInQStat();
+    printf("PostNotInQ: posted=%u coalesced=%u scanned=%u\n", stat.posted, stat.coalesced, stat.scanned);
+}
+
+// Reports event queue high-water marks, and post-to-dispatch latency (ns) when built with -DFW_LATENCY=ON.
+static void ReportQueue() {
+    printf("Event queues (max used is since startup):\n");
+    for (uint8_t prio = 1; prio <= QF_MAX_ACTIVE; prio++) {
+        uint32_t size, maxUsed;
+        if (Fw::GetQueueUsage(prio, size, maxUsed)) {
+            Hsm *hsm = Fw::GetActiveHsm(prio);
+            printf("  prio %2u %-18s size=%-3u max used=%u\n", prio, hsm ? hsm->GetName() : "?", size, maxUsed);
+#ifdef ENABLE_FW_LATENCY
+            LatencyHist hist;
+            Fw::GetLatency(prio, hist);
+            printf("    latency (ns) count=%u avg=%u p50<%u p99<%u max=%u\n", hist.GetCount(), hist.GetAvg(),
+                   hist.GetPercentile(50), hist.GetPercentile(99), hist.GetMax());
+#endif
+        }
+    }
+}
+
+// Reports dispatch time per (HSM, signal) in ns when built with -DFW_PROF=ON.
+static void ReportProf() {
+#ifdef ENABLE_FW_PROF
+    printf("Dispatch profile (ns) used=%u dropped=%u:\n", Prof::GetUsedCount(), Prof::GetDropCount());
+    printf("  %-18s %-28s %10s %8s %8s %8s\n", "hsm", "event", "count", "avg", "min", "max");
+    for (uint32_t i = 0; i < Prof::GetTotalCount(); i++) {
+        Hsmn hsmn;
+        QSignal sig;
+        Prof::Stat stat;
+        if (Prof::Get(i, hsmn, sig, stat)) {
+            printf("  %-18s %-28s %10u %8u %8u %8u\n", Log::GetHsmName(hsmn), Log::GetEvtName(sig),
+                   stat.m_count, stat.GetAvg(), stat.m_min, stat.m_max);
+        }
+    }
+#endif
+}
+
+// Event names of all HSMs in flash, indexed by HSMN (see fw_evtSet.h). Each HSM in BENCH_HSM defines its event set
+// via DEFINE_EVT_NAME() or DEFINE_NO_EVT_NAME(). A missing or duplicate definition is a link error.
+Q_ASSERT_COMPILE(static_cast<uint32_t>(HSM_COUNT) <= MAX_HSM_COUNT);
+
+#undef ADD_HSM
+#define ADD_HSM(hsmn_, count_) extern EvtSet const EVT_SET(hsmn_);
+namespace APP {
+BENCH_HSM
+}
+
+#undef ADD_HSM
+#define ADD_HSM(hsmn_, count_) table.Add(hsmn_, &EVT_SET(hsmn_));
+static constexpr EvtSetTable MakeEvtSetTable() {
+    EvtSetTable table;
+    BENCH_HSM
+    return table;
+}
+
+namespace FW {
+extern constexpr EvtSetTable evtSetTable = MakeEvtSetTable();
+}
+
+static BenchDriver benchDriver;
+static BenchPong benchPong(BENCH_PONG, "BENCH_PONG");
+static BenchPong benchFan[BENCH_FAN_COUNT] = {
+    {BENCH_FAN, "BENCH_FAN0"}, {BENCH_FAN + 1, "BENCH_FAN1"}, {BENCH_FAN + 2, "BENCH_FAN2"}, {BENCH_FAN + 3, "BENCH_FAN3"}
+};
+static BenchRoute benchRoute;
+static BenchXThread benchXThread;
+
+Q_ASSERT_COMPILE(BENCH_FAN_COUNT == 4);
+
+static void Usage(char const *prog) {
+    printf("Usage: %s [-n roundCount] [", prog);
+    for (uint32_t i = 0; i < BENCH_SCENARIO_COUNT; i++) {
+        printf("%s%s", (i == 0) ? "" : "|", BenchDriver::GetScenarioName(static_cast<BenchScenario>(i)));
+    }
+    printf(" ...]\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t roundCount = 10000;
+    bool selected[BENCH_SCENARIO_COUNT] = {};
+    bool anySelected = false;
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc)) {
+            roundCount = strtoul(argv[++i], NULL, 0);
+            continue;
+        }
+        uint32_t s;
+        for (s = 0; s < BENCH_SCENARIO_COUNT; s++) {
+            if (strcmp(argv[i], BenchDriver::GetScenarioName(static_cast<BenchScenario>(s))) == 0) {
+                break;
+            }
+        }
+        if (s == BENCH_SCENARIO_COUNT) {
+            Usage(argv[0]);
+            return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        }
+        selected[s] = true;
+        anySelected = true;
+    }
+    if (roundCount == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    Fw::Init();
+
+    benchDriver.Start(PRIO_BENCH);
+    benchPong.Start(PRIO_BENCH_PONG);
+    for (uint32_t i = 0; i < BENCH_FAN_COUNT; i++) {
+        benchFan[i].Start(PRIO_BENCH_FAN - i);
+    }
+    benchRoute.Start(PRIO_BENCH_ROUTE);
+    benchXThread.Start(PRIO_BENCH_XTHREAD);
+    ReportRam();
+
+    printf("Rounds per scenario=%u\n", roundCount);
+    for (uint32_t s = 0; s < BENCH_SCENARIO_COUNT; s++) {
+        if (!anySelected || selected[s]) {
+            Fw::Post(new BenchStartReq(static_cast<BenchScenario>(s), roundCount));
+        }
+    }
+    Fw::Post(new BenchStopReq());
+
+    QF::run();
+    ReportPool();
+    ReportDispatch();
+    ReportQueue();
+    ReportProf();
+    return 0;
+}
@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#include "fw_log.h"
+#include "fw_assert.h"
+#include "BenchInterface.h"
+#include "BenchTarget.h"
+
+FW_DEFINE_THIS_FILE("BenchTarget.cpp")
+
+namespace APP {
+
+// Targets only use events defined by BenchDriver.
+DEFINE_NO_EVT_NAME(BENCH_PONG);
+DEFINE_NO_EVT_NAME(BENCH_FAN);
+DEFINE_NO_EVT_NAME(BENCH_ROUTE);
+DEFINE_NO_EVT_NAME(BENCH_ROUTE_REG);
+DEFINE_NO_EVT_NAME(BENCH_XTHREAD_REG);
+
+BenchPong::BenchPong(Hsmn hsmn, char const *name) :
+    Active((QStateHandler)&BenchPong::InitialPseudoState, hsmn, name) {}
+
+QState BenchPong::InitialPseudoState(BenchPong * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN(&BenchPong::Root);
+}
+
+QState BenchPong::Root(BenchPong * const me, QEvt const * const e) {
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+        case Q_EXIT_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+        case BENCH_PING_REQ: {
+            uint64_t dispatchNs = GetNs();
+            EVENT(e);
+            BenchPingReq const &req = static_cast<BenchPingReq const &>(*e);
+            me->SendCfm(new BenchPingRsp(req.GetPostNs(), dispatchNs), req);
+            return Q_HANDLED();
+        }
+    }
+    return Q_SUPER(&QHsm::top);
+}
+
+BenchReg::BenchReg(Hsmn hsmn, char const *name) :
+    Region((QStateHandler)&BenchReg::InitialPseudoState, hsmn, name) {}
+
+QState BenchReg::InitialPseudoState(BenchReg * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN(&BenchReg::Root);
+}
+
+QState BenchReg::Root(BenchReg * const me, QEvt const * const e) {
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+        case Q_EXIT_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+        case BENCH_PING_REQ: {
+            uint64_t dispatchNs = GetNs();
+            EVENT(e);
+            BenchPingReq const &req = static_cast<BenchPingReq const &>(*e);
+            me->SendCfm(new BenchPingRsp(req.GetPostNs(), dispatchNs), req);
+            return Q_HANDLED();
+        }
+    }
+    return Q_SUPER(&QHsm::top);
+}
+
+// Must match the initializer list of m_reg below.
+Q_ASSERT_COMPILE(BENCH_ROUTE_REG_COUNT == 4);
+
+BenchRoute::BenchRoute() :
+    Active((QStateHandler)&BenchRoute::InitialPseudoState, BENCH_ROUTE, "BENCH_ROUTE"),
+    m_reg{{BENCH_ROUTE_REG, "BENCH_ROUTE_REG0"}, {BENCH_ROUTE_REG + 1, "BENCH_ROUTE_REG1"},
+          {BENCH_ROUTE_REG + 2, "BENCH_ROUTE_REG2"}, {BENCH_ROUTE_REG + 3, "BENCH_ROUTE_REG3"}} {}
+
+QState BenchRoute::InitialPseudoState(BenchRoute * const me, QEvt const * const e) {
+    (void)e;
+    return Q_TRAN(&BenchRoute::Root);
+}
+
+QState BenchRoute::Root(BenchRoute * const me, QEvt const * const e) {
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            EVENT(e);
+            for (uint32_t i = 0; i < ARRAY_COUNT(me->m_reg); i++) {
+                me->m_reg[i].Init(me);
+            }
+            return Q_HANDLED();
+        }
+        case Q_EXIT_SIG: {
+            EVENT(e);
+            return Q_HANDLED();
+        }
+    }
+    return Q_SUPER(&QHsm::top);
+}
+
+BenchXThread::BenchXThread() :
+    XThread(), m_reg(BENCH_XTHREAD_REG, "BENCH_XTHREAD_REG") {}
+
+void BenchXThread::OnRun() {
+    m_reg.Init(this);
+}
+
+} // namespace APP
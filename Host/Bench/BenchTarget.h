@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef BENCH_TARGET_H
+#define BENCH_TARGET_H
+
+#include "qpcpp.h"
+#include "fw_active.h"
+#include "fw_region.h"
+#include "fw_xthread.h"
+#include "fw_evt.h"
+#include "bench_hsmn.h"
+
+using namespace QP;
+using namespace FW;
+
+namespace APP {
+
+// Active object replying to each BENCH_PING_REQ with a BENCH_PING_RSP.
+class BenchPong : public Active {
+public:
+    BenchPong(Hsmn hsmn, char const *name);
+
+protected:
+    static QState InitialPseudoState(BenchPong * const me, QEvt const * const e);
+    static QState Root(BenchPong * const me, QEvt const * const e);
+};
+
+// Region replying to each BENCH_PING_REQ with a BENCH_PING_RSP.
+class BenchReg : public Region {
+public:
+    BenchReg(Hsmn hsmn, char const *name);
+
+protected:
+    static QState InitialPseudoState(BenchReg * const me, QEvt const * const e);
+    static QState Root(BenchReg * const me, QEvt const * const e);
+};
+
+// Active object containing BenchReg regions. Events to the regions are routed by Active::dispatch().
+class BenchRoute : public Active {
+public:
+    BenchRoute();
+
+protected:
+    static QState InitialPseudoState(BenchRoute * const me, QEvt const * const e);
+    static QState Root(BenchRoute * const me, QEvt const * const e);
+
+    BenchReg m_reg[BENCH_ROUTE_REG_COUNT];
+};
+
+// Extended thread containing a single BenchReg region.
+class BenchXThread : public XThread {
+public:
+    BenchXThread();
+
+protected:
+    void OnRun();
+
+    BenchReg m_reg;
+};
+
+} // namespace APP
+
+#endif // BENCH_TARGET_H
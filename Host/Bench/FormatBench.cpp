@@ -0,0 +1,171 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host benchmark of Format (fw_format.h) against the C library snprintf() for formats used in the log path.
+// It reports the time per call and the peak stack usage, measured by running each formatter on a thread
+// with a painted stack. Note the host C library is glibc rather than newlib-nano as on the target.
+//
+// Usage: format_bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "fw_def.h"
+#include "fw_macro.h"
+#include "fw_format.h"
+#include "BenchStat.h"
+
+using namespace FW;
+using namespace APP;
+
+enum {
+    BUF_LEN = 512,                  // Same as Log::BUF_LEN.
+    STACK_SIZE = 64 * 1024,
+    PAINT = 0xA5,
+};
+
+enum Case {
+    CASE_DEBUG,         // Log::Debug() header and message.
+    CASE_HEX,           // Log::PrintBufLine().
+    CASE_FLOAT,         // Fixed-point float.
+    CASE_TABLE,         // Console table row.
+    CASE_COUNT
+};
+static char const * const caseName[CASE_COUNT] = { "debug", "hex", "float", "table" };
+
+// Prevents the compiler from optimizing away the output.
+static volatile uint32_t sink;
+
+static uint32_t FormatFw(Case c, char *buf) {
+    switch (c) {
+        case CASE_DEBUG: return Format::Print(buf, BUF_LEN, "%lu %s(%u): %sstate=%s count=%d", 123456UL, "SYSTEM", 12u, "", "Started", -42);
+        case CASE_HEX: return Format::Print(buf, BUF_LEN, "[0x%.8lx] %.2x %.2x %.2x %.2x", 0x20001000UL, 0x12u, 0xabu, 0x00u, 0xffu);
+        case CASE_FLOAT: return Format::Print(buf, BUF_LEN, "T=%6.2f H=%6.2f", 23.456, -1.5);
+        default: return Format::Print(buf, BUF_LEN, "%2d %-24s %10lu", 7, "CONSOLE_UART1", 4000000000UL);
+    }
+}
+
+static uint32_t FormatLibc(Case c, char *buf) {
+    switch (c) {
+        case CASE_DEBUG: return snprintf(buf, BUF_LEN, "%lu %s(%u): %sstate=%s count=%d", 123456UL, "SYSTEM", 12u, "", "Started", -42);
+        case CASE_HEX: return snprintf(buf, BUF_LEN, "[0x%.8lx] %.2x %.2x %.2x %.2x", 0x20001000UL, 0x12u, 0xabu, 0x00u, 0xffu);
+        case CASE_FLOAT: return snprintf(buf, BUF_LEN, "T=%6.2f H=%6.2f", 23.456, -1.5);
+        default: return snprintf(buf, BUF_LEN, "%2d %-24s %10lu", 7, "CONSOLE_UART1", 4000000000UL);
+    }
+}
+
+typedef uint32_t (*FormatFunc)(Case c, char *buf);
+
+static double MeasureNs(FormatFunc func, Case c, uint32_t iterations) {
+    char buf[BUF_LEN];
+    uint32_t sum = 0;
+    uint64_t t0 = GetNs();
+    for (uint32_t i = 0; i < iterations; i++) {
+        sum += func(c, buf);
+    }
+    uint64_t t1 = GetNs();
+    sink = sum + buf[0];
+    return static_cast<double>(t1 - t0) / iterations;
+}
+
+struct StackArg {
+    FormatFunc func;
+    Case c;
+};
+
+static void *StackThread(void *arg) {
+    StackArg const *a = static_cast<StackArg const *>(arg);
+    char buf[BUF_LEN];
+    sink = a->func(a->c, buf) + buf[0];
+    return NULL;
+}
+
+// Returns the peak stack usage in bytes of a thread calling func once, excluding the output buffer.
+static uint32_t MeasureStack(FormatFunc func, Case c) {
+    static uint8_t stack[STACK_SIZE] __attribute__((aligned(64)));
+    memset(stack, PAINT, sizeof(stack));
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, sizeof(stack));
+    StackArg arg = { func, c };
+    pthread_t thread;
+    if (pthread_create(&thread, &attr, StackThread, &arg) != 0) {
+        printf("pthread_create failed\n");
+        exit(1);
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+    // The stack grows downward. The lowest modified byte marks the peak.
+    uint32_t i = 0;
+    while ((i < sizeof(stack)) && (stack[i] == PAINT)) {
+        i++;
+    }
+    return sizeof(stack) - i;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 200000;
+    if (iterations == 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    // Checks both produce the same output.
+    for (uint32_t c = 0; c < CASE_COUNT; c++) {
+        char fw[BUF_LEN], libc[BUF_LEN];
+        FormatFw(static_cast<Case>(c), fw);
+        FormatLibc(static_cast<Case>(c), libc);
+        if (strcmp(fw, libc) != 0) {
+            printf("Output mismatch (%s): \"%s\" vs \"%s\"\n", caseName[c], fw, libc);
+            return 1;
+        }
+    }
+    // Baseline stack usage of the thread itself.
+    uint32_t base = MeasureStack([](Case, char *) -> uint32_t { return 0; }, CASE_DEBUG);
+    printf("Time per call (ns) and peak stack (bytes, excluding %u-byte buffer), %u iterations\n", BUF_LEN, iterations);
+    printf("%-6s %10s %10s %10s %10s\n", "case", "Format", "snprintf", "stack", "stack");
+    for (uint32_t c = 0; c < CASE_COUNT; c++) {
+        Case cs = static_cast<Case>(c);
+        double fwNs = MeasureNs(FormatFw, cs, iterations);
+        double libcNs = MeasureNs(FormatLibc, cs, iterations);
+        uint32_t fwStack = MeasureStack(FormatFw, cs) - base;
+        uint32_t libcStack = MeasureStack(FormatLibc, cs) - base;
+        printf("%-6s %10.1f %10.1f %10u %10u\n", caseName[c], fwNs, libcNs, fwStack, libcStack);
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host benchmark of Heap (fw_heap.h) against the C library malloc() for a random mix of allocations and
+// frees. It reports the time per call (average, 99th percentile and maximum) and, for Heap, the peak usage
+// and fragmentation at the end of the run. Block contents are checked on free to detect heap corruption.
+// Note the host C library is glibc rather than newlib-nano as on the target. When built with -DFW_HEAP_MALLOC=ON,
+// malloc() is routed to Heap::GetSys() instead. The sample buffers then come from the system arena as well, which
+// limits the iteration count to about 100000 (the default then).
+//
+// Usage: heap_bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "fw_def.h"
+#include "fw_macro.h"
+#include "fw_heap.h"
+#include "BenchStat.h"
+
+using namespace FW;
+using namespace APP;
+
+enum {
+    ARENA_SIZE = 256 * 1024,
+    SLOT_COUNT = 512,           // Maximum number of live blocks.
+    MIN_ALLOC = 8,
+    MAX_ALLOC_LOG2 = 10,        // Sizes are log-uniform from MIN_ALLOC to 1 KB.
+};
+
+struct Slot {
+    uint8_t *ptr;
+    uint32_t size;
+};
+
+// Returns a pseudo-random number (xorshift32) so both allocators see the same sequence.
+static uint32_t Rand(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static uint32_t RandSize(uint32_t &state) {
+    uint32_t log2 = 3 + Rand(state) % (MAX_ALLOC_LOG2 - 2);
+    uint32_t size = (1u << log2) + Rand(state) % (1u << log2);
+    return LESS(size, 1u << MAX_ALLOC_LOG2);
+}
+
+static void Report(char const *name, std::vector<uint32_t> &sample) {
+    if (sample.empty()) {
+        return;
+    }
+    uint64_t sum = 0;
+    for (uint32_t s : sample) {
+        sum += s;
+    }
+    std::sort(sample.begin(), sample.end());
+    printf("  %-8s count=%-8zu avg=%-6.1f p99=%-6u max=%u (ns)\n", name, sample.size(),
+           static_cast<double>(sum) / sample.size(), sample[sample.size() * 99 / 100], sample.back());
+}
+
+class Allocator {
+public:
+    virtual ~Allocator() {}
+    virtual void *Alloc(size_t size) = 0;
+    virtual void Free(void *ptr) = 0;
+    // Called before the remaining blocks are freed at the end of a run.
+    virtual void Snapshot() {}
+};
+
+static void ReportHeap(Heap &heap) {
+    Heap::Stat stat;
+    heap.GetStat(stat);
+    printf("  used=%u peak=%u free=%u largest=%u free blocks=%u frag=%u%%\n", stat.usedSize, stat.peakUsed,
+           stat.freeSize, stat.largestFree, stat.freeBlockCount, stat.GetFragPercent());
+}
+
+class LibcAllocator : public Allocator {
+public:
+    void *Alloc(size_t size) { return malloc(size); }
+    void Free(void *ptr) { free(ptr); }
+#ifdef ENABLE_FW_HEAP_MALLOC
+    void Snapshot() { ReportHeap(Heap::GetSys()); }
+#endif
+};
+
+class HeapAllocator : public Allocator {
+public:
+    explicit HeapAllocator(Heap &heap) : m_heap(heap) {}
+    void *Alloc(size_t size) { return m_heap.Alloc(size); }
+    void Free(void *ptr) { m_heap.Free(ptr); }
+    void Snapshot() { ReportHeap(m_heap); }
+private:
+    Heap &m_heap;
+};
+
+// Returns false if block contents were corrupted.
+static bool Run(char const *name, Allocator &a, uint32_t iterations) {
+    printf("%s:\n", name);
+    static Slot slot[SLOT_COUNT];
+    memset(slot, 0, sizeof(slot));
+    std::vector<uint32_t> allocNs, freeNs;
+    allocNs.reserve(iterations);
+    freeNs.reserve(iterations);
+    uint32_t state = 0x12345678;
+    uint32_t failCount = 0;
+    bool ok = true;
+    for (uint32_t i = 0; i < iterations + SLOT_COUNT; i++) {
+        if (i == iterations) {
+            a.Snapshot();
+        }
+        // Frees everything at the end.
+        uint32_t s = (i < iterations) ? (Rand(state) % SLOT_COUNT) : (i - iterations);
+        Slot &sl = slot[s];
+        if (sl.ptr) {
+            for (uint32_t j = 0; j < sl.size; j++) {
+                if (sl.ptr[j] != static_cast<uint8_t>(s)) {
+                    ok = false;
+                    break;
+                }
+            }
+            uint64_t t0 = GetNs();
+            a.Free(sl.ptr);
+            uint64_t t1 = GetNs();
+            freeNs.push_back(static_cast<uint32_t>(t1 - t0));
+            sl.ptr = NULL;
+        } else if (i < iterations) {
+            uint32_t size = RandSize(state);
+            uint64_t t0 = GetNs();
+            sl.ptr = static_cast<uint8_t *>(a.Alloc(size));
+            uint64_t t1 = GetNs();
+            allocNs.push_back(static_cast<uint32_t>(t1 - t0));
+            if (sl.ptr) {
+                sl.size = size;
+                memset(sl.ptr, static_cast<uint8_t>(s), size);
+            } else {
+                failCount++;
+            }
+        }
+    }
+    printf("  failed=%u%s\n", failCount, ok ? "" : " CORRUPTED");
+    Report("alloc", allocNs);
+    Report("free", freeNs);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+#ifdef ENABLE_FW_HEAP_MALLOC
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 100000;
+#else
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000000;
+#endif
+    if (iterations == 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    static uint64_t stor[ARENA_SIZE / sizeof(uint64_t)];
+    static Heap heap("bench", stor, sizeof(stor));
+    printf("Iterations=%u live blocks<=%u sizes=%u-%u\n", iterations, SLOT_COUNT, MIN_ALLOC, 1u << MAX_ALLOC_LOG2);
+
+    LibcAllocator libc;
+    HeapAllocator fw(heap);
+#ifdef ENABLE_FW_HEAP_MALLOC
+    bool ok = Run("malloc (sys heap)", libc, iterations);
+#else
+    bool ok = Run("malloc", libc, iterations);
+#endif
+    ok = Run("Heap", fw, iterations) && ok;
+
+    Heap::Stat stat;
+    heap.GetStat(stat);
+    printf("Heap size=%u peak=%u alloc=%u fail=%u\n", stat.size, stat.peakUsed, stat.allocCount, stat.failCount);
+    // All blocks are freed, so the arena must be one free block again.
+    if ((stat.usedSize != 0) || (stat.freeBlockCount != 1) || (stat.freeSize != stat.size)) {
+        printf("Heap not fully coalesced\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host benchmark of the cost of a LOG() call in a hot path when the log is disabled for the HSM at runtime.
+// It compares a direct call to Log::Debug() (the previous expansion of LOG()), the LOG() macro with its inline
+// checks, and LOG() compiled out by FW_LOG_LEVEL.
+// When built with -DLOG_DEFER=ON or -DLOG_BATCH=ON, it also measures an enabled LOG() with a drain HSM set and
+// drains the output to the default interfaces the way the drain HSM does on the target. One interface is never
+// read out, so it only takes what fits in its FIFO. The other must still receive all output.
+//
+// Usage: log_bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "qpcpp.h"
+#include "fw.h"
+#include "fw_hsm.h"
+#include "fw_log.h"
+#include "BenchStat.h"
+
+using namespace FW;
+using namespace APP;
+
+enum {
+    BENCH_HSMN = 1,
+#ifdef ENABLE_LOG_DRAIN
+    BENCH_INF,          // Default interface that is read out after each drain.
+    BENCH_INF_STALLED,  // Default interface that is never read out.
+    BENCH_DRAIN,        // Drain HSM. It is not registered, so notifications posted to it are discarded.
+#endif
+};
+
+// Provides GetHsmn() for the log macros, like an HSM.
+class BenchHsm {
+public:
+    BenchHsm() : m_hsm(BENCH_HSMN, "BENCH_HSM", NULL, m_hsmStor) {}
+    Hsmn GetHsmn() const { return m_hsm.GetHsmn(); }
+    Hsm *GetHsm() { return &m_hsm; }
+private:
+    HsmStor<> m_hsmStor;
+    Hsm m_hsm;
+};
+
+// Prevents the compiler from optimizing away the sample data. Also used by LogBenchOff.cpp.
+volatile int32_t sink;
+
+static void __attribute__((noinline)) RunCall(BenchHsm * const me, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        int32_t x = sink;
+        Log::Debug(Log::TYPE_LOG, me->GetHsmn(), "Accel data = %d %d %d", x, x + 1, x + 2);
+    }
+}
+
+static void __attribute__((noinline)) RunMacro(BenchHsm * const me, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        int32_t x = sink;
+        LOG("Accel data = %d %d %d", x, x + 1, x + 2);
+    }
+}
+
+// Defined in LogBenchOff.cpp, which is built with FW_LOG_LEVEL 3.
+void RunCompiledOut(BenchHsm * const me, uint32_t iterations);
+
+typedef void (*RunFunc)(BenchHsm * const me, uint32_t iterations);
+
+static double MeasureNs(RunFunc func, BenchHsm *me, uint32_t iterations) {
+    uint64_t t0 = GetNs();
+    func(me, iterations);
+    uint64_t t1 = GetNs();
+    return static_cast<double>(t1 - t0) / iterations;
+}
+
+#ifdef ENABLE_LOG_DRAIN
+
+enum {
+    DRAIN_BURST = 16,   // LOG() calls between two drains.
+    INF_FIFO_ORDER = 12,
+};
+
+static uint8_t infStor[1 << INF_FIFO_ORDER];
+static Fifo infFifo(infStor, INF_FIFO_ORDER);
+static uint8_t stalledStor[1 << INF_FIFO_ORDER];
+static Fifo stalledFifo(stalledStor, INF_FIFO_ORDER);
+
+// Writes output pending in the log to the default interfaces, like the drain HSM does upon LOG_DRAIN.
+static void DrainLog() {
+#ifdef ENABLE_LOG_DEFER
+    while (Log::Drain()) {}
+#endif
+#ifdef ENABLE_LOG_BATCH
+    Log::Flush();
+#endif
+}
+
+// Reads out the interface FIFO like an interface HSM. Returns the number of bytes read.
+static uint32_t ReadInf(Fifo &fifo) {
+    uint8_t buf[256];
+    uint32_t total = 0;
+    uint32_t count;
+    while ((count = fifo.Read(buf, sizeof(buf))) != 0) {
+        total += count;
+    }
+    return total;
+}
+
+// Measures the time of an enabled LOG() with a drain HSM set, and drains the output after each burst.
+static void RunDrain(BenchHsm * const me, uint32_t rounds) {
+    Log::AddInterface(BENCH_INF, &infFifo, QP::Q_USER_SIG, true);
+    Log::AddInterface(BENCH_INF_STALLED, &stalledFifo, QP::Q_USER_SIG, true);
+    Log::ResetTruncCount();
+    Log::On(BENCH_HSMN);
+    Log::SetDrain(BENCH_DRAIN, QP::Q_USER_SIG);
+    uint64_t logNs = 0;
+    uint64_t drainNs = 0;
+    uint32_t infLen = 0;
+    for (uint32_t r = 0; r < rounds; r++) {
+        uint64_t t0 = GetNs();
+        for (uint32_t i = 0; i < DRAIN_BURST; i++) {
+            int32_t x = sink;
+            LOG("Accel data = %d %d %d", x, x + 1, x + 2);
+        }
+        uint64_t t1 = GetNs();
+        DrainLog();
+        uint64_t t2 = GetNs();
+        infLen += ReadInf(infFifo);
+        logNs += t1 - t0;
+        drainNs += t2 - t1;
+    }
+    Log::SetDrain(HSM_UNDEF, 0);
+    infLen += ReadInf(infFifo);
+    Log::Off(BENCH_HSMN);
+    Log::RemoveInterface(BENCH_INF);
+    Log::RemoveInterface(BENCH_INF_STALLED);
+    uint32_t count = rounds * DRAIN_BURST;
+    printf("Time per enabled LOG() with drain (ns), %u calls\n", count);
+    printf("  log         %6.2f\n", static_cast<double>(logNs) / count);
+    printf("  drain       %6.2f\n", static_cast<double>(drainNs) / count);
+    printf("Interface bytes=%u truncated=%u\n", infLen, Log::GetTruncCount(BENCH_INF));
+    printf("Stalled interface bytes=%u truncated=%u\n", stalledFifo.GetUsedCount(), Log::GetTruncCount(BENCH_INF_STALLED));
+#ifdef ENABLE_LOG_DEFER
+    printf("Deferred drops = %u\n", Log::GetDeferDropCount());
+#endif
+#ifdef ENABLE_LOG_BATCH
+    printf("Batch drops = %u\n", Log::GetBatchDropCount());
+#endif
+}
+
+#endif // ENABLE_LOG_DRAIN
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 10000000;
+    if (iterations == 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    Fw::Init();
+    static BenchHsm benchHsm;
+    // The HSM is never dispatched, so it does not need an active object.
+    Fw::Add(BENCH_HSMN, benchHsm.GetHsm(), reinterpret_cast<QP::QActive *>(&benchHsm));
+    Log::SetVerbosity(Log::MAX_VERBOSITY);
+    Log::Off(BENCH_HSMN);
+    printf("Time per disabled LOG() (ns), %u iterations\n", iterations);
+    printf("  call        %6.2f\n", MeasureNs(RunCall, &benchHsm, iterations));
+    printf("  inline      %6.2f\n", MeasureNs(RunMacro, &benchHsm, iterations));
+    printf("  compiled out %5.2f\n", MeasureNs(RunCompiledOut, &benchHsm, iterations));
+#ifdef ENABLE_LOG_DRAIN
+    RunDrain(&benchHsm, LESS(iterations / DRAIN_BURST, 100000U));
+#endif
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host benchmark of Map (linear) against HashMap (open addressing) with Hsmn keys, as used for
+// hsmn-to-region routing in Active::dispatch(), sequence matching in SeqRec and interface lookup in Log.
+// Each map is filled to 3/4 of its capacity with scattered keys.
+//
+// Usage: map_bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fw_def.h"
+#include "fw_map.h"
+#include "fw_hashmap.h"
+#include "BenchStat.h"
+
+using namespace FW;
+using namespace APP;
+
+enum {
+    MAX_ENTRY = 64,
+    REPEAT = 50,            // Operations per timed block, to amortize the timer overhead.
+};
+
+struct Result {
+    double hitNs;       // GetByKey() of a saved key.
+    double missNs;      // GetByKey() of an unsaved key.
+    double updateNs;    // ClearByKey() followed by Save().
+    double countNs;     // GetUsedCount().
+};
+
+// Prevents the compiler from optimizing away lookups.
+static volatile uint32_t sink;
+
+template <class MapType>
+static void Measure(uint32_t entryCount, uint32_t iterations, Result &result) {
+    KeyValue<Hsmn, uint32_t> stor[MAX_ENTRY];
+    MapType map(stor, entryCount, KeyValue<Hsmn, uint32_t>(HSM_UNDEF, 0));
+    Hsmn keys[MAX_ENTRY];
+    uint32_t usedCount = entryCount * 3 / 4;
+    // Scattered distinct keys. Odd keys are saved and even keys are used for misses.
+    for (uint32_t i = 0; i < entryCount; i++) {
+        keys[i] = static_cast<Hsmn>(((i * 37) % 127) * 2 + 1);
+    }
+    for (uint32_t i = 0; i < usedCount; i++) {
+        map.Save(KeyValue<Hsmn, uint32_t>(keys[i], i));
+    }
+    uint64_t hitTotal = 0, missTotal = 0, updateTotal = 0, countTotal = 0;
+    uint32_t sum = 0;
+    for (uint32_t n = 0; n < iterations; n++) {
+        uint64_t t0 = GetNs();
+        for (uint32_t r = 0; r < REPEAT; r++) {
+            for (uint32_t i = 0; i < usedCount; i++) {
+                sum += map.GetByKey(keys[i])->GetValue();
+            }
+        }
+        uint64_t t1 = GetNs();
+        for (uint32_t r = 0; r < REPEAT; r++) {
+            for (uint32_t i = 0; i < usedCount; i++) {
+                sum += (map.GetByKey(static_cast<Hsmn>(keys[i] + 1)) != NULL);
+            }
+        }
+        uint64_t t2 = GetNs();
+        for (uint32_t r = 0; r < REPEAT; r++) {
+            for (uint32_t i = 0; i < usedCount; i++) {
+                map.ClearByKey(keys[i]);
+                map.Save(KeyValue<Hsmn, uint32_t>(keys[i], i));
+            }
+        }
+        uint64_t t3 = GetNs();
+        for (uint32_t r = 0; r < REPEAT; r++) {
+            for (uint32_t i = 0; i < usedCount; i++) {
+                sum += map.GetUsedCount();
+            }
+        }
+        uint64_t t4 = GetNs();
+        hitTotal += t1 - t0;
+        missTotal += t2 - t1;
+        updateTotal += t3 - t2;
+        countTotal += t4 - t3;
+    }
+    if (map.GetUsedCount() != usedCount) {
+        printf("Unexpected used count %u\n", map.GetUsedCount());
+        exit(1);
+    }
+    sink = sum;
+    double ops = static_cast<double>(iterations) * REPEAT * usedCount;
+    result.hitNs = hitTotal / ops;
+    result.missNs = missTotal / ops;
+    result.updateNs = updateTotal / ops;
+    result.countNs = countTotal / ops;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 2000;
+    if (iterations == 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    printf("Average time per operation (ns), maps 3/4 full, %u iterations\n", iterations);
+    printf("%7s %-8s %8s %8s %8s %8s\n", "entries", "map", "hit", "miss", "update", "count");
+    uint32_t const entryCounts[] = { 8, 16, 64 };
+    for (uint32_t i = 0; i < ARRAY_COUNT(entryCounts); i++) {
+        Result linear, hash;
+        Measure<Map<Hsmn, uint32_t>>(entryCounts[i], iterations, linear);
+        Measure<HashMap<Hsmn, uint32_t>>(entryCounts[i], iterations, hash);
+        printf("%7u %-8s %8.1f %8.1f %8.1f %8.1f\n", entryCounts[i], "Map",
+               linear.hitNs, linear.missNs, linear.updateNs, linear.countNs);
+        printf("%7u %-8s %8.1f %8.1f %8.1f %8.1f\n", entryCounts[i], "HashMap",
+               hash.hitNs, hash.missNs, hash.updateNs, hash.countNs);
+    }
+    return 0;
+}
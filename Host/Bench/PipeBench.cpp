@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host benchmark of Pipe bulk copies. Pipe::Write() and Pipe::Read() run entirely within a
+// critical section, so their duration approximates the interrupt-disabled time on the target.
+// It compares Fifo (trivially copyable, copied with memcpy) against a pipe of a byte-sized type
+// with a user-defined assignment operator (copied element by element as before).
+//
+// Usage: pipe_bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "qpcpp.h"
+#include "fw.h"
+#include "fw_pipe.h"
+#include "BenchStat.h"
+
+using namespace FW;
+using namespace APP;
+
+// Byte-sized type which is not trivially copyable.
+class Byte {
+public:
+    Byte() : m_val(0) {}
+    Byte(Byte const &b) : m_val(b.m_val) {}
+    Byte &operator=(Byte const &b) { m_val = b.m_val; return *this; }
+private:
+    uint8_t m_val;
+};
+
+enum {
+    PIPE_ORDER = 12,        // 4KB
+};
+
+static uint8_t fifoStor[1 << PIPE_ORDER];
+static Byte bytePipeStor[1 << PIPE_ORDER];
+static uint8_t fifoBuf[2048];
+static Byte byteBuf[2048];
+
+// Returns average ns per Write() and Read() of count elements.
+// Each pass fills up the pipe and then drains it, so that timer overhead is amortized over many calls.
+template <class Type>
+static void Measure(Pipe<Type> &pipe, Type *buf, uint32_t count, uint32_t iterations, double &writeNs, double &readNs) {
+    uint64_t writeTotal = 0;
+    uint64_t readTotal = 0;
+    uint32_t callCount = 0;
+    uint32_t callPerPass = (pipe.GetBufSize() - 1) / count;
+    for (uint32_t i = 0; i < iterations; i++) {
+        // Offset the indices so that some writes/reads wrap around.
+        pipe.Reset();
+        pipe.IncWriteIndex(i * 17);
+        pipe.IncReadIndex(i * 17);
+        uint32_t written = 0;
+        uint32_t read = 0;
+        uint64_t t0 = GetNs();
+        for (uint32_t j = 0; j < callPerPass; j++) {
+            written += pipe.Write(buf, count);
+        }
+        uint64_t t1 = GetNs();
+        for (uint32_t j = 0; j < callPerPass; j++) {
+            read += pipe.Read(buf, count);
+        }
+        uint64_t t2 = GetNs();
+        if ((written != count * callPerPass) || (read != written)) {
+            printf("Unexpected count %u %u\n", written, read);
+            exit(1);
+        }
+        writeTotal += t1 - t0;
+        readTotal += t2 - t1;
+        callCount += callPerPass;
+    }
+    writeNs = static_cast<double>(writeTotal) / callCount;
+    readNs = static_cast<double>(readTotal) / callCount;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 2000;
+    if (iterations == 0) {
+        printf("Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+    // Initializes the critical section used by Pipe.
+    Fw::Init();
+    Fifo fifo(fifoStor, PIPE_ORDER);
+    Pipe<Byte> bytePipe(bytePipeStor, PIPE_ORDER);
+    for (uint32_t i = 0; i < sizeof(fifoBuf); i++) {
+        fifoBuf[i] = i;
+    }
+    printf("Average time per call within critical section (ns), %u iterations\n", iterations);
+    printf("%6s %12s %12s %8s %12s %12s %8s\n", "bytes", "loop write", "memcpy write", "speedup",
+           "loop read", "memcpy read", "speedup");
+    for (uint32_t count = 64; count <= 2048; count *= 2) {
+        double loopWrite, loopRead, fifoWrite, fifoRead;
+        Measure(bytePipe, byteBuf, count, iterations, loopWrite, loopRead);
+        Measure(fifo, fifoBuf, count, iterations, fifoWrite, fifoRead);
+        printf("%6u %12.1f %12.1f %7.1fx %12.1f %12.1f %7.1fx\n", count,
+               loopWrite, fifoWrite, loopWrite / fifoWrite, loopRead, fifoRead, loopRead / fifoRead);
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host stress benchmark of event allocation from concurrent producers. It compares the lock-free small event
+// pool (LfPool) with the medium pool, which is a QF pool guarded by the QF critical section. "ISR" threads
+// allocate and free without blocking, as ISRs do on the target, alongside "thread" producers. Host threads run in
+// parallel on multiple cores, which exercises the compare-and-swap paths harder than preemption on the target.
+// Each event is filled with a pattern that is checked before it is freed, to detect a block handed out twice.
+//
+// Usage: pool_bench [iterations per producer] [ISR producers] [thread producers]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "qpcpp.h"
+#include "fw.h"
+#include "BenchStat.h"
+
+using namespace QP;
+using namespace FW;
+using namespace APP;
+
+enum {
+    MAX_PRODUCER = 8,
+    HOLD_COUNT = 1,         // Events held at once by a producer. The medium pool has only 8 blocks.
+    SMALL_SIZE = 32,
+    MEDIUM_SIZE = 64,
+};
+
+struct Producer {
+    pthread_t thread;
+    char const *kind;
+    uint8_t id;
+    uint32_t size;
+    uint32_t iterations;
+    std::atomic<bool> const *start;
+    std::vector<uint32_t> allocNs;
+    bool ok;
+};
+
+static void *ProducerMain(void *arg) {
+    Producer &p = *static_cast<Producer *>(arg);
+    p.allocNs.reserve(p.iterations);
+    p.ok = true;
+    while (!p.start->load(std::memory_order_acquire)) {
+    }
+    QEvt *held[HOLD_COUNT];
+    for (uint32_t i = 0; i < p.iterations; i++) {
+        for (uint32_t h = 0; h < HOLD_COUNT; h++) {
+            uint64_t t0 = GetNs();
+            QEvt *e = Fw::NewEvt(p.size);
+            uint64_t t1 = GetNs();
+            p.allocNs.push_back(static_cast<uint32_t>(t1 - t0));
+            // The QEvt header has been initialized by NewEvt(). Only the bytes after it are filled.
+            e->sig = static_cast<QSignal>(i);
+            memset(reinterpret_cast<uint8_t *>(e) + sizeof(QEvt), p.id, p.size - sizeof(QEvt));
+            held[h] = e;
+        }
+        for (uint32_t h = 0; h < HOLD_COUNT; h++) {
+            uint8_t const *b = reinterpret_cast<uint8_t const *>(held[h]) + sizeof(QEvt);
+            for (uint32_t j = 0; j < p.size - sizeof(QEvt); j++) {
+                if (b[j] != p.id) {
+                    p.ok = false;
+                    break;
+                }
+            }
+            if (held[h]->sig != static_cast<QSignal>(i)) {
+                p.ok = false;
+            }
+            QF::gc(held[h]);
+        }
+    }
+    return NULL;
+}
+
+static void Report(char const *name, std::vector<uint32_t> &sample) {
+    if (sample.empty()) {
+        return;
+    }
+    uint64_t sum = 0;
+    for (uint32_t s : sample) {
+        sum += s;
+    }
+    std::sort(sample.begin(), sample.end());
+    printf("  %-8s count=%-8zu avg=%-6.1f p99=%-6u max=%u (ns)\n", name, sample.size(),
+           static_cast<double>(sum) / sample.size(), sample[sample.size() * 99 / 100], sample.back());
+}
+
+// Returns false if a block was corrupted or not all events were allocated.
+static bool Run(char const *name, uint8_t poolId, uint32_t size, uint32_t iterations, uint32_t isrCount,
+                uint32_t threadCount) {
+    static Producer producer[MAX_PRODUCER];
+    std::atomic<bool> start(false);
+    uint32_t count = isrCount + threadCount;
+    Fw::ResetPoolUsage();
+    for (uint32_t i = 0; i < count; i++) {
+        Producer &p = producer[i];
+        p.kind = (i < isrCount) ? "isr" : "thread";
+        p.id = static_cast<uint8_t>(i + 1);
+        p.size = size;
+        p.iterations = iterations;
+        p.start = &start;
+        p.allocNs.clear();
+        pthread_create(&p.thread, NULL, ProducerMain, &p);
+    }
+    uint64_t t0 = GetNs();
+    start.store(true, std::memory_order_release);
+    std::vector<uint32_t> isrNs, threadNs;
+    bool ok = true;
+    for (uint32_t i = 0; i < count; i++) {
+        Producer &p = producer[i];
+        pthread_join(p.thread, NULL);
+        std::vector<uint32_t> &ns = (i < isrCount) ? isrNs : threadNs;
+        ns.insert(ns.end(), p.allocNs.begin(), p.allocNs.end());
+        ok = ok && p.ok;
+    }
+    uint64_t elapsedNs = GetNs() - t0;
+    Fw::PoolUsage usage;
+    Fw::GetPoolUsage(poolId, usage);
+    uint32_t expected = count * iterations * HOLD_COUNT;
+    printf("%s (block=%u count=%u):\n", name, usage.blockSize, usage.blockCount);
+    printf("  alloc=%u fail=%u minFree=%u %.0f alloc/s%s\n", usage.allocCount, usage.failCount, usage.minFree,
+           expected * 1e9 / elapsedNs, ok ? "" : " CORRUPTED");
+    Report("isr", isrNs);
+    Report("thread", threadNs);
+    return ok && (usage.allocCount == expected) && (usage.failCount == 0);
+}
+
+// Allocates every block of the pool at once, which asserts if any was leaked, then frees them.
+static void Drain(uint8_t poolId, uint32_t size) {
+    Fw::PoolUsage usage;
+    Fw::GetPoolUsage(poolId, usage);
+    std::vector<QEvt *> evt;
+    for (uint32_t i = 0; i < usage.blockCount; i++) {
+        evt.push_back(Fw::NewEvt(size));
+    }
+    for (QEvt *e : evt) {
+        QF::gc(e);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000000;
+    uint32_t isrCount = (argc > 2) ? strtoul(argv[2], NULL, 0) : 2;
+    uint32_t threadCount = (argc > 3) ? strtoul(argv[3], NULL, 0) : 2;
+    if ((iterations == 0) || (isrCount + threadCount == 0) || (isrCount + threadCount > MAX_PRODUCER)) {
+        printf("Usage: %s [iterations] [isrCount] [threadCount] (at most %u producers)\n", argv[0], MAX_PRODUCER);
+        return 1;
+    }
+    Fw::Init();
+    printf("Iterations=%u per producer, isr=%u thread=%u\n", iterations, isrCount, threadCount);
+    bool ok = Run("LfPool", 1, SMALL_SIZE, iterations, isrCount, threadCount);
+    ok = Run("QF pool", 2, MEDIUM_SIZE, iterations, isrCount, threadCount) && ok;
+    Drain(1, SMALL_SIZE);
+    Drain(2, MEDIUM_SIZE);
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
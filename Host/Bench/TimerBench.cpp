@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host benchmark of the tick cost of QF::tickX_() against TimerWheel (fw_timerwheel.h) with 10 to 500 armed
+// periodic timers of random periods. Both post to the queue of an active object that is never run, which is
+// drained after each tick outside the measurement. The number of expiries of every timer is checked against the
+// number expected from its period.
+//
+// Usage: timer_bench [ticks]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "qpcpp.h"
+#include "fw.h"
+#include "fw_timerwheel.h"
+#include "BenchStat.h"
+
+using namespace QP;
+using namespace FW;
+using namespace APP;
+
+enum {
+    MAX_TIMER = 500,
+    MIN_PERIOD = 100,
+    MAX_PERIOD = 5000,
+    QUEUE_LEN = 128,        // QEQueueCtr is 8-bit.
+    BENCH_PRIO = 1,
+    TIMER_SIG = Q_USER_SIG,
+};
+
+static uint32_t const TIMER_COUNT[] = { 10, 50, 100, 200, 500 };
+
+// Active object that only holds the event queue.
+class BenchAct : public QActive {
+public:
+    BenchAct() : QActive(Q_STATE_CAST(&BenchAct::InitialPseudoState)) {}
+protected:
+    static QState InitialPseudoState(BenchAct * const me, QEvt const * const e) {
+        (void)e;
+        return Q_TRAN(&BenchAct::Idle);
+    }
+    static QState Idle(BenchAct * const me, QEvt const * const e) {
+        (void)me;
+        (void)e;
+        return Q_SUPER(&QHsm::top);
+    }
+};
+
+static BenchAct benchAct;
+static QEvt const *queueStor[QUEUE_LEN];
+
+struct BenchTimeEvt : public QTimeEvt {
+    BenchTimeEvt() : QTimeEvt(&benchAct, TIMER_SIG, 0U) {}
+};
+struct BenchEvt : public QEvt {
+    BenchEvt() : QEvt(TIMER_SIG, QEvt::STATIC_EVT) {}
+};
+
+static BenchTimeEvt timeEvt[MAX_TIMER];
+static TimerWheel::Entry entry[MAX_TIMER];
+static BenchEvt entryEvt[MAX_TIMER];
+static uint32_t period[MAX_TIMER];
+static uint32_t first[MAX_TIMER];
+static uint32_t expiry[MAX_TIMER];
+
+static uint32_t Rand(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Returns false if an event is not from one of the count timers.
+static bool Drain(QEvt const *base, size_t stride, uint32_t count) {
+    QEvt const *e;
+    bool ok = true;
+    while ((e = benchAct.m_eQueue.get(0U)) != NULL) {
+        uint32_t i = static_cast<uint32_t>((reinterpret_cast<uint8_t const *>(e) -
+                                            reinterpret_cast<uint8_t const *>(base)) / stride);
+        if (i < count) {
+            expiry[i]++;
+        } else {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Returns false if the expiry count of any timer is wrong.
+static bool Check(uint32_t count, uint32_t ticks) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t expected = (first[i] <= ticks) ? (1 + (ticks - first[i]) / period[i]) : 0;
+        if (expiry[i] != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the average time per tick in ns, or a negative value on failure.
+static double RunQf(uint32_t count, uint32_t ticks) {
+    memset(expiry, 0, sizeof(expiry));
+    for (uint32_t i = 0; i < count; i++) {
+        timeEvt[i].armX(first[i], period[i]);
+    }
+    uint64_t totalNs = 0;
+    bool ok = true;
+    for (uint32_t t = 0; t < ticks; t++) {
+        uint64_t t0 = GetNs();
+        QF::TICK_X(0U, nullptr);
+        totalNs += GetNs() - t0;
+        ok = Drain(timeEvt, sizeof(BenchTimeEvt), count) && ok;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        timeEvt[i].disarm();
+    }
+    // Lets QF unlink the disarmed time events.
+    QF::TICK_X(0U, nullptr);
+    Drain(timeEvt, sizeof(BenchTimeEvt), count);
+    return (ok && Check(count, ticks)) ? static_cast<double>(totalNs) / ticks : -1.0;
+}
+
+static double RunWheel(uint32_t count, uint32_t ticks) {
+    static TimerWheel wheel;
+    memset(expiry, 0, sizeof(expiry));
+    for (uint32_t i = 0; i < count; i++) {
+        wheel.Arm(entry[i], first[i], period[i]);
+    }
+    uint64_t totalNs = 0;
+    bool ok = true;
+    for (uint32_t t = 0; t < ticks; t++) {
+        uint64_t t0 = GetNs();
+        wheel.Tick();
+        totalNs += GetNs() - t0;
+        ok = Drain(entryEvt, sizeof(BenchEvt), count) && ok;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        ok = wheel.Disarm(entry[i]) && ok;
+    }
+    return (ok && Check(count, ticks)) ? static_cast<double>(totalNs) / ticks : -1.0;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t ticks = (argc > 1) ? strtoul(argv[1], NULL, 0) : 100000;
+    if (ticks == 0) {
+        printf("Usage: %s [ticks]\n", argv[0]);
+        return 1;
+    }
+    Fw::Init();
+    benchAct.start(BENCH_PRIO, queueStor, QUEUE_LEN, NULL, 0);
+    uint32_t state = 0x12345678;
+    for (uint32_t i = 0; i < MAX_TIMER; i++) {
+        entry[i].act = &benchAct;
+        entry[i].evt = &entryEvt[i];
+        period[i] = MIN_PERIOD + Rand(state) % (MAX_PERIOD - MIN_PERIOD + 1);
+        first[i] = 1 + Rand(state) % period[i];
+    }
+    printf("Time per tick (ns) with periodic timers of %u-%u ticks, %u ticks\n", MIN_PERIOD, MAX_PERIOD, ticks);
+    printf("%8s %10s %10s\n", "timers", "QF", "wheel");
+    bool ok = true;
+    for (uint32_t count : TIMER_COUNT) {
+        double qfNs = RunQf(count, ticks);
+        double wheelNs = RunWheel(count, ticks);
+        printf("%8u %10.1f %10.1f\n", count, qfNs, wheelNs);
+        ok = ok && (qfNs >= 0) && (wheelNs >= 0);
+    }
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef BENCH_HSMN_H
+#define BENCH_HSMN_H
+
+#include "fw_def.h"
+
+namespace APP {
+
+#define BENCH_HSM \
+    ADD_HSM(BENCH, 1) \
+    ADD_HSM(BENCH_PONG, 1) \
+    ADD_HSM(BENCH_FAN, 4) \
+    ADD_HSM(BENCH_ROUTE, 1) \
+    ADD_HSM(BENCH_ROUTE_REG, 4) \
+    ADD_HSM(BENCH_XTHREAD_REG, 1)
+
+#undef ADD_HSM
+#define ADD_HSM(hsmn_, count_) hsmn_, hsmn_##_COUNT = count_, hsmn_##_LAST = hsmn_ + count_ - 1,
+
+enum {
+    BENCH_HSM_START = FW::HSM_UNDEF,
+    BENCH_HSM
+    HSM_COUNT
+};
+
+// Higher value corresponds to higher priority.
+// Priorities are not enforced by the host port. They only need to be unique.
+enum
+{
+    PRIO_BENCH_XTHREAD  = 20,
+    PRIO_BENCH_ROUTE    = 19,
+    PRIO_BENCH_FAN      = 15,   // Uses BENCH_FAN_COUNT priorities down from here.
+    PRIO_BENCH_PONG     = 11,
+    PRIO_BENCH          = 10,
+};
+
+} // namespace APP
+
+#endif // BENCH_HSMN_H
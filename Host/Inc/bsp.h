@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host (POSIX) replacement of Inc/bsp.h. It provides the same BSP interface as the target
+// so that framework sources compile unchanged. Do not add Inc/ to the host include path.
+
+#ifndef BSP_H
+#define BSP_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include "qpcpp.h"
+
+#define BSP_TICKS_PER_SEC            (1000)
+#define BSP_MSEC_PER_TICK            (1000 / BSP_TICKS_PER_SEC)
+#define BSP_MSEC_TO_TICK(ms_)        ((ms_) / BSP_MSEC_PER_TICK)
+
+#define BSP_FAST_TICKS_PER_SEC       (10000)
+
+// Timer tick rates
+#define TICK_RATE_BSP       0       // Timer tick driven by QF::run() at a rate of BSP_TICKS_PER_SEC.
+#define TICK_RATE_FAST      1       // Ticked BSP_FAST_TICKS_PER_SEC / BSP_TICKS_PER_SEC times per TICK_RATE_BSP tick,
+                                    // so it has the resolution of TICK_RATE_BSP on the host.
+#define BSP_USEC_PER_TICK(tickRate_) \
+    (((tickRate_) == TICK_RATE_FAST) ? (1000000 / BSP_FAST_TICKS_PER_SEC) : (1000000 / BSP_TICKS_PER_SEC))
+
+// Newlib reentrancy shim. On the target each Active/XThread owns a newlib struct _reent
+// which is switched in QXK_onContextSw(). glibc keeps per-thread state in TLS already,
+// so an empty placeholder is sufficient.
+struct _reent {};
+#define _REENT_INIT(var_)   _reent()
+extern struct _reent *const _global_impure_ptr;
+
+void BspInit();
+void BspWrite(char const *buf, uint32_t len);
+extern "C" uint32_t GetSystemMs();
+extern "C" void DelayMs(uint32_t ms);
+uint32_t GetIdleCnt();
+// There is no DWT on the host. It returns the monotonic clock in nanoseconds instead.
+uint32_t GetCycleCount();
+
+// Extended threads run on pthread stacks on the host, so the usage of their stack storage is not meaningful.
+#define BSP_STACK_PAINT     (0xDEADBEEFU)
+uint32_t BspGetStackUsed(void const *base, uint32_t size);
+
+// Both tick rates are always driven on the host.
+inline void BspStartTick(uint8_t tickRate) { (void)tickRate; }
+
+// Lock for data shared among threads only (see Inc/bsp.h). The ceiling is not used on the host.
+class BspLock {
+public:
+    explicit BspLock(uint8_t ceiling = QF_MAX_ACTIVE) { (void)ceiling; pthread_mutex_init(&m_mutex, NULL); }
+    void Lock() { pthread_mutex_lock(&m_mutex); }
+    void Unlock() { pthread_mutex_unlock(&m_mutex); }
+private:
+    pthread_mutex_t m_mutex;
+};
+
+#endif // BSP_H
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// Host (POSIX) BSP. See Host/Inc/bsp.h.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "qpcpp.h"
+#include "bsp.h"
+#include "fw_timer.h"
+
+using namespace QP;
+
+// Placeholder of the global newlib reentrancy structure used by active objects without their own.
+static struct _reent globalImpure;
+struct _reent *const _global_impure_ptr = &globalImpure;
+
+void BspInit() {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+void BspWrite(char const *buf, uint32_t len) {
+    fwrite(buf, 1, len, stdout);
+}
+
+uint32_t GetSystemMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint32_t>(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+uint32_t GetCycleCount() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint32_t>(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+void DelayMs(uint32_t ms) {
+    struct timespec ts = { static_cast<time_t>(ms / 1000), static_cast<long>((ms % 1000) * 1000000) };
+    nanosleep(&ts, NULL);
+}
+
+// There is no idle loop on the host.
+uint32_t GetIdleCnt() {
+    return 0;
+}
+
+uint32_t BspGetStackUsed(void const *base, uint32_t size) {
+    uint32_t const *p = static_cast<uint32_t const *>(base);
+    uint32_t count = size / sizeof(uint32_t);
+    uint32_t i = 0;
+    while ((i < count) && (p[i] == BSP_STACK_PAINT)) {
+        i++;
+    }
+    return size - i * sizeof(uint32_t);
+}
+
+namespace QP {
+
+void QF::onStartup(void) {
+    QF_setTickRate(BSP_TICKS_PER_SEC);
+}
+
+void QF::onCleanup(void) {
+    fflush(stdout);
+}
+
+void QF_onClockTick(void) {
+    QF::TICK_X(TICK_RATE_BSP, nullptr);
+    FW_TIMER_TICK(TICK_RATE_BSP);
+    for (uint32_t i = 0; i < (BSP_FAST_TICKS_PER_SEC / BSP_TICKS_PER_SEC); i++) {
+        QF::TICK_X(TICK_RATE_FAST, nullptr);
+        FW_TIMER_TICK(TICK_RATE_FAST);
+    }
+}
+
+} // namespace QP
+
+extern "C" Q_NORETURN Q_onAssert(char const * const module, int_t const loc) {
+    fflush(stdout);
+    fprintf(stderr, "ASSERT FAILED in %s at line %d\n", module, static_cast<int>(loc));
+    abort();
+}
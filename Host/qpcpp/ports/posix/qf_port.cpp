@@ -0,0 +1,305 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// QF/C++ port for the POSIX host build. See qf_port.hpp for an overview.
+
+#define QP_IMPL           // this is QP implementation
+#include "qf_port.hpp"    // QF port
+#include "qf_pkg.hpp"     // QF package-scope interface
+#include "qassert.h"      // QP embedded systems-friendly assertions
+#include <atomic>
+#include <cerrno>
+#include <ctime>
+
+Q_DEFINE_THIS_MODULE("qf_port")
+
+namespace QP {
+
+// Global objects ============================================================
+pthread_mutex_t QF_pThreadMutex_;
+
+// Local objects =============================================================
+typedef void *(*ThreadEntry)(void *arg);
+
+static ThreadEntry l_threadEntry[QF_MAX_ACTIVE + 1U];    // indexed by prio
+static pthread_t l_thread[QF_MAX_ACTIVE + 1U];            // indexed by prio
+static bool l_threadCreated[QF_MAX_ACTIVE + 1U];         // indexed by prio
+static std::atomic<bool> l_isRunning;
+static long l_tickPeriodNs = 1000000L;                   // default 1ms.
+static QXThreadHandler l_xthreadHandler[QF_MAX_ACTIVE + 1U]; // indexed by prio
+static thread_local QXThread *l_currXThread;             // extended thread of the calling pthread.
+
+static void *activeThreadEntry(void *arg) {
+    QF::thread_(static_cast<QActive *>(arg));
+    return nullptr;
+}
+
+static void *xthreadEntry(void *arg) {
+    QXThread *thr = static_cast<QXThread *>(arg);
+    l_currXThread = thr;
+    l_xthreadHandler[thr->m_prio](thr);
+    return nullptr;
+}
+
+// Must be called in a critical section.
+static void createThread(std::uint_fast8_t const prio) {
+    Q_REQUIRE((prio <= QF_MAX_ACTIVE) && !l_threadCreated[prio]);
+    int err = pthread_create(&l_thread[prio], nullptr, l_threadEntry[prio], QF::active_[prio]);
+    Q_ASSERT(err == 0);
+    l_threadCreated[prio] = true;
+}
+
+static void registerThread(std::uint_fast8_t const prio, ThreadEntry entry) {
+    QF_CRIT_STAT_
+    QF_CRIT_E_();
+    l_threadEntry[prio] = entry;
+    // Like QXK, threads only start running once QF::run() has been called.
+    if (l_isRunning) {
+        createThread(prio);
+    }
+    QF_CRIT_X_();
+}
+
+static void addNs(struct timespec &ts, long ns) {
+    ts.tv_nsec += ns;
+    while (ts.tv_nsec >= 1000000000L) {
+        ts.tv_nsec -= 1000000000L;
+        ++ts.tv_sec;
+    }
+}
+
+//****************************************************************************
+void QF_enterCriticalSection_(void) {
+    pthread_mutex_lock(&QF_pThreadMutex_);
+}
+
+void QF_leaveCriticalSection_(void) {
+    pthread_mutex_unlock(&QF_pThreadMutex_);
+}
+
+void QF_setTickRate(std::uint32_t ticksPerSec) {
+    Q_REQUIRE(ticksPerSec != 0U);
+    l_tickPeriodNs = static_cast<long>(1000000000UL / ticksPerSec);
+}
+
+//****************************************************************************
+void QF::init(void) {
+    // The framework nests critical sections, hence a recursive mutex.
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&QF_pThreadMutex_, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    QF_maxPool_      = 0U;
+    QF_subscrList_   = nullptr;
+    QF_maxPubSignal_ = 0;
+
+    bzero(&timeEvtHead_[0], sizeof(timeEvtHead_));
+    bzero(&active_[0],      sizeof(active_));
+    bzero(&l_threadEntry[0], sizeof(l_threadEntry));
+    bzero(&l_threadCreated[0], sizeof(l_threadCreated));
+    l_isRunning = false;
+}
+
+//****************************************************************************
+int_t QF::run(void) {
+    onStartup(); // application-specific startup callback
+
+    QF_CRIT_STAT_
+    QF_CRIT_E_();
+    l_isRunning = true;
+    for (std::uint_fast8_t p = 1U; p <= QF_MAX_ACTIVE; ++p) {
+        if (l_threadEntry[p] != nullptr) {
+            createThread(p);
+        }
+    }
+    QF_CRIT_X_();
+
+    // The main thread drives the clock tick, in place of the SysTick ISR.
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (l_isRunning) {
+        addNs(next, l_tickPeriodNs);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr) == EINTR) {}
+        QF_onClockTick();
+    }
+    onCleanup(); // application-specific cleanup callback
+    return 0;
+}
+
+//****************************************************************************
+// AO and extended threads are not joined. The application is expected to exit
+// once QF::run() returns.
+void QF::stop(void) {
+    l_isRunning = false;
+}
+
+//****************************************************************************
+void QF::thread_(QActive *act) {
+    for (;;) {
+        QEvt const *e = act->get_(); // wait for event
+        act->dispatch(e, act->m_prio); // dispatch to the AO's state machine
+        gc(e); // check if the event is garbage, and collect it if so
+    }
+}
+
+//****************************************************************************
+void QActive::start(std::uint_fast8_t const prio,
+                    QEvt const * * const qSto, std::uint_fast16_t const qLen,
+                    void * const stkSto, std::uint_fast16_t const stkSize,
+                    void const * const par)
+{
+    // The stack storage is not used since each AO has its own pthread.
+    static_cast<void>(stkSto);
+    static_cast<void>(stkSize);
+    Q_REQUIRE_ID(200, (0U < prio) && (prio <= QF_MAX_ACTIVE));
+
+    m_eQueue.init(qSto, qLen); // initialize QEQueue of this AO
+    pthread_cond_init(&m_osObject, nullptr);
+    m_prio    = static_cast<std::uint8_t>(prio); // prio of the AO
+    QF::add_(this);  // make QF aware of this AO
+
+    this->init(par, m_prio); // take the top-most initial tran. (virtual)
+    registerThread(prio, &activeThreadEntry);
+}
+
+//****************************************************************************
+// QXThread emulation. Each extended thread runs its thread handler in its own
+// pthread and blocks on its condition variable in queueGet().
+QXThread::QXThread(QXThreadHandler const handler,
+                   std::uint_fast8_t const tickRate) noexcept
+  : QActive(Q_STATE_CAST(handler)),
+    m_timeEvt(this, static_cast<enum_t>(Q_USER_SIG),
+                    static_cast<std::uint_fast8_t>(tickRate))
+{
+    m_state.act = nullptr; // mark as extended thread
+}
+
+void QXThread::init(void const * const e,
+                    std::uint_fast8_t const qs_id) noexcept
+{
+    static_cast<void>(e); // unused parameter
+    static_cast<void>(qs_id); // unused parameter
+    Q_ERROR_ID(110);
+}
+
+void QXThread::dispatch(QEvt const * const e,
+                        std::uint_fast8_t const qs_id) noexcept
+{
+    static_cast<void>(e); // unused parameter
+    static_cast<void>(qs_id); // unused parameter
+    Q_ERROR_ID(120);
+}
+
+void QXThread::start(std::uint_fast8_t const prio,
+                     QEvt const * * const qSto, std::uint_fast16_t const qLen,
+                     void * const stkSto, std::uint_fast16_t const stkSize,
+                     void const * const par)
+{
+    static_cast<void>(stkSto);
+    static_cast<void>(stkSize);
+    static_cast<void>(par);
+    Q_REQUIRE_ID(200, (0U < prio) && (prio <= QF_MAX_ACTIVE)
+        && (m_state.act == nullptr));
+
+    if (qSto != nullptr) {
+        m_eQueue.init(qSto, qLen);
+    }
+    pthread_cond_init(&m_osObject, nullptr);
+    m_prio    = static_cast<std::uint8_t>(prio);
+    QF::add_(this); // make QF aware of this extended thread
+    // Extended threads provide their thread function in place of
+    // the top-most initial transition 'm_temp.act'.
+    l_xthreadHandler[prio] = m_temp.thr;
+    registerThread(prio, &xthreadEntry);
+}
+
+bool QXThread::post_(QEvt const * const e,
+                     std::uint_fast16_t const margin) noexcept
+{
+    return QActive::post_(e, margin);
+}
+
+void QXThread::postLIFO(QEvt const * const e) noexcept {
+    QActive::postLIFO(e);
+}
+
+QEvt const *QXThread::queueGet(std::uint_fast16_t const nTicks) noexcept {
+    QXThread * const thr = l_currXThread;
+    Q_REQUIRE_ID(500, thr != nullptr);
+
+    QF_CRIT_STAT_
+    QF_CRIT_E_();
+    if (nTicks == QXTHREAD_NO_TIMEOUT) {
+        while (thr->m_eQueue.m_frontEvt == nullptr) {
+            pthread_cond_wait(&thr->m_osObject, &QF_pThreadMutex_);
+        }
+    } else {
+        // Condition variables use CLOCK_REALTIME by default.
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        addNs(deadline, static_cast<long>(nTicks) * l_tickPeriodNs);
+        while (thr->m_eQueue.m_frontEvt == nullptr) {
+            if (pthread_cond_timedwait(&thr->m_osObject, &QF_pThreadMutex_, &deadline) == ETIMEDOUT) {
+                break;
+            }
+        }
+    }
+    QEvt const *e = nullptr;
+    if (thr->m_eQueue.m_frontEvt != nullptr) {
+        e = thr->get_(); // does not block since the queue is not empty.
+    }
+    QF_CRIT_X_();
+    return e;
+}
+
+bool QXThread::delay(std::uint_fast16_t const nTicks) noexcept {
+    Q_REQUIRE_ID(800, l_currXThread != nullptr);
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    addNs(next, static_cast<long>(nTicks) * l_tickPeriodNs);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr) == EINTR) {}
+    return true;
+}
+
+bool QXThread::delayCancel(void) noexcept {
+    return false;
+}
+
+} // namespace QP
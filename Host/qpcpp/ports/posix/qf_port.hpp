@@ -0,0 +1,125 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+// QF/C++ port for the POSIX host build (see Host/CMakeLists.txt).
+//
+// Each active object and each extended thread (QXThread) runs in its own pthread.
+// Like QXK on the target, no thread runs until QF::run() is called, so events posted
+// during initialization are queued the same way.
+// Thread priorities are not enforced. The host port is for functional testing and
+// for measuring framework overhead, not for reproducing target timing.
+
+#ifndef QF_PORT_HPP
+#define QF_PORT_HPP
+
+// POSIX event queue, per-thread object and thread types.
+#define QF_EQUEUE_TYPE          QEQueue
+#define QF_OS_OBJECT_TYPE       pthread_cond_t
+// m_thread holds the newlib thread-local-storage pointer in the framework (see fw_active.cpp).
+// The host port keeps its pthread handles separately.
+#define QF_THREAD_TYPE          void*
+
+// The following must match the arm-cm port.
+#define QF_MAX_TICK_RATE        2U
+#define QF_MAX_ACTIVE           32U
+#define QF_MAX_EPOOL            4
+
+// QF critical section. The framework relies on critical sections being nestable
+// (e.g. Fw::PostNotInQ() posts within a critical section), which BASEPRI save/restore
+// provides on the target. A recursive mutex provides the same on the host.
+#define QF_CRIT_STAT_TYPE       std::uint_fast8_t
+#define QF_CRIT_ENTRY(stat_)    ((stat_) = 0U, QP::QF_enterCriticalSection_())
+#define QF_CRIT_EXIT(stat_)     (static_cast<void>(stat_), QP::QF_leaveCriticalSection_())
+#define QF_CRIT_EXIT_NOP()      (static_cast<void>(0))
+#define QF_INT_DISABLE()        QP::QF_enterCriticalSection_()
+#define QF_INT_ENABLE()         QP::QF_leaveCriticalSection_()
+
+#include <cstdint>      // exact-width types
+#include <pthread.h>    // POSIX-thread API
+
+namespace QP {
+
+void QF_enterCriticalSection_(void);
+void QF_leaveCriticalSection_(void);
+
+// Sets the rate at which QF::run() calls QF_onClockTick().
+void QF_setTickRate(std::uint32_t ticksPerSec);
+
+// Clock tick callback (provided by the application, see Host/Src/bsp.cpp).
+void QF_onClockTick(void);
+
+extern pthread_mutex_t QF_pThreadMutex_; // mutex for QF critical section
+
+} // namespace QP
+
+#include "qep_port.hpp" // QEP port
+#include "qequeue.hpp"  // POSIX needs event-queue
+#include "qmpool.hpp"   // POSIX needs memory-pool
+#include "qf.hpp"       // QF platform-independent public interface
+#include "qxthread.hpp" // Extended threads emulated with pthreads (see qf_port.cpp)
+
+//****************************************************************************
+// interface used only inside QF implementation, but not in applications
+
+#ifdef QP_IMPL
+
+    // QF scheduler locking (not used since every AO has its own pthread).
+    #define QF_SCHED_STAT_
+    #define QF_SCHED_LOCK_(dummy) (static_cast<void>(0))
+    #define QF_SCHED_UNLOCK_()    (static_cast<void>(0))
+
+    // Event queue operations.
+    #define QACTIVE_EQUEUE_WAIT_(me_) \
+        while ((me_)->m_eQueue.m_frontEvt == nullptr) \
+            pthread_cond_wait(&(me_)->m_osObject, &QF_pThreadMutex_)
+
+    #define QACTIVE_EQUEUE_SIGNAL_(me_) \
+        pthread_cond_signal(&(me_)->m_osObject)
+
+    // Native QF event pool operations.
+    #define QF_EPOOL_TYPE_  QMPool
+    #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) \
+        (p_).init((poolSto_), (poolSize_), (evtSize_))
+    #define QF_EPOOL_EVENT_SIZE_(p_)  ((p_).getBlockSize())
+    #define QF_EPOOL_GET_(p_, e_, m_, qs_id_) \
+        ((e_) = static_cast<QEvt *>((p_).get((m_), (qs_id_))))
+    #define QF_EPOOL_PUT_(p_, e_, qs_id_) ((p_).put((e_), (qs_id_)))
+
+#endif // QP_IMPL
+
+#endif // QF_PORT_HPP
@@ -46,12 +46,22 @@
 #include "stm32l475e_iot01.h"
 #include "stm32l4xx_it.h"
 
+// Uncomment the following to stop SysTick while idle and wake up by LPTIM1 at the next timer deadline, entering
+// STOP2 (or STOP1, see BspStop2Lock()) when allowed (see BspDeepSleepLock()). See TicklessIdle() in bsp.cpp.
+//#define ENABLE_BSP_TICKLESS
+
 #define BSP_TICKS_PER_SEC            (1000)
 #define BSP_MSEC_PER_TICK            (1000 / BSP_TICKS_PER_SEC)
 #define BSP_MSEC_TO_TICK(ms_)        ((ms_) / BSP_MSEC_PER_TICK)
 
+#define BSP_FAST_TICKS_PER_SEC       (10000)
+
 // Timer tick rates
 #define TICK_RATE_BSP       0       // Timer tick driven by SysTick_Handler() at a rate of BSP_TICKS_PER_SEC.
+#define TICK_RATE_FAST      1       // Timer tick driven by TIM6_DAC_IRQHandler() at a rate of BSP_FAST_TICKS_PER_SEC.
+Q_ASSERT_COMPILE(TICK_RATE_FAST < QF_MAX_TICK_RATE);
+#define BSP_USEC_PER_TICK(tickRate_) \
+    (((tickRate_) == TICK_RATE_FAST) ? (1000000 / BSP_FAST_TICKS_PER_SEC) : (1000000 / BSP_TICKS_PER_SEC))
 
 enum KernelUnawareISRs { // see NOTE00
     // ...
@@ -63,6 +73,7 @@ Q_ASSERT_COMPILE(MAX_KERNEL_UNAWARE_CMSIS_PRI <= (int)QF_AWARE_ISR_CMSIS_PRI);
 // Lower numerical value indicates higher priority.
 enum KernelAwareISRs {
     SYSTICK_PRIO            = QF_AWARE_ISR_CMSIS_PRI,
+    TIM6_PRIO               = QF_AWARE_ISR_CMSIS_PRI,       // TICK_RATE_FAST
     DMA1_CHANNEL4_PRIO      = QF_AWARE_ISR_CMSIS_PRI + 1,   // I2C2/USART1 TX DMA
     DMA1_CHANNEL5_PRIO      = QF_AWARE_ISR_CMSIS_PRI + 1,   // I2C2/USART1 RX DMA
     USART1_IRQ_PRIO         = QF_AWARE_ISR_CMSIS_PRI + 1,   // USART1 IRQ
@@ -83,6 +94,7 @@ enum KernelAwareISRs {
     EXTI4_PRIO              = QF_AWARE_ISR_CMSIS_PRI + 10,
     EXTI9_5_PRIO            = QF_AWARE_ISR_CMSIS_PRI + 10,
     EXTI15_10_PRIO          = QF_AWARE_ISR_CMSIS_PRI + 10,
+    LPTIM1_PRIO             = QF_AWARE_ISR_CMSIS_PRI + 10,  // Tickless idle wakeup
     // ...
     MAX_KERNEL_AWARE_CMSIS_PRI // keep always last
 };
@@ -96,4 +108,103 @@ extern "C" uint32_t GetSystemMs();
 extern "C" void DelayMs(uint32_t ms);
 uint32_t GetIdleCnt();
 
+// Returns the DWT cycle counter (core clock cycles). It wraps around every 2^32 cycles.
+inline uint32_t GetCycleCount() { return DWT->CYCCNT; }
+
+// Lock for data shared among threads only (e.g. heap arenas, see fw_heap.h). It locks the QXK scheduler up to
+// a priority ceiling, which must be at least the highest priority of all users. Interrupts stay enabled, so it
+// must not be used in ISRs.
+class BspLock {
+public:
+    explicit BspLock(uint8_t ceiling = QF_MAX_ACTIVE) : m_ceiling(ceiling), m_stat(0) {}
+    void Lock();
+    void Unlock();
+private:
+    uint8_t m_ceiling;
+    QP::QSchedStatus m_stat;
+};
+
+// Starts the clock driving tickRate if it is stopped. Called by FW::Timer when it is armed. TIM6 runs only while
+// timers are armed at TICK_RATE_FAST, and stops itself on a tick when none is (see BspFastTickDone()). Time events
+// at TICK_RATE_FAST not armed via FW::Timer (e.g. QXThread timeouts) must call it too.
+void BspStartTick(uint8_t tickRate);
+// Called by TIM6_DAC_IRQHandler() after processing a tick of TICK_RATE_FAST. entryCycle is GetCycleCount() on
+// entry to the ISR.
+void BspFastTickDone(uint32_t entryCycle);
+
+// Jitter of TICK_RATE_FAST. Intervals between consecutive TIM6 ISR entries are compared against the nominal tick
+// period, so they include interrupt latency caused by critical sections and higher priority ISRs.
+struct BspFastTickStat {
+    uint32_t periodNs;          // Nominal tick period.
+    uint32_t tickCount;         // Ticks processed.
+    uint32_t startCount;        // Times TIM6 has been started.
+    uint32_t intervalCount;     // Intervals measured. The first tick after TIM6 starts is not measured.
+    int32_t minErrNs;           // Shortest interval minus periodNs.
+    int32_t maxErrNs;           // Longest interval minus periodNs.
+    uint32_t avgErrNs;          // Mean absolute difference of intervals from periodNs.
+    uint32_t maxIsrNs;          // Longest tick processing (QF::tickX_() and timer wheel).
+};
+// Since startup or BspResetFastTickStat().
+void BspGetFastTickStat(BspFastTickStat &stat);
+void BspResetFastTickStat();
+
+// Pattern that unused stack is filled with, by QXK_stackInit_() for extended threads and by BspInit() for the main
+// stack, which active objects and ISRs run on.
+#define BSP_STACK_PAINT     (0xDEADBEEFU)
+// Returns the high-water mark in bytes of a descending stack of size bytes at base, by scanning up from base for the
+// first word not equal to BSP_STACK_PAINT. It returns size if the stack has overflowed (or has not been painted).
+uint32_t BspGetStackUsed(void const *base, uint32_t size);
+// Main stack from _estack down to _estack - _Min_Stack_Size (see the linker script).
+void BspGetMainStackUsage(uint32_t &size, uint32_t &maxUsed);
+
+// CPU time per QF priority, measured in DWT cycles by QXK_onContextSw() on every switch among active objects,
+// extended threads and the idle loop (priority 0). Time in ISRs is charged to the thread they preempt. The idle
+// loop does not count time in sleep or STOP modes, in which the DWT counter stops.
+struct BspCpuTime {
+    uint64_t cycle;             // Run time.
+    uint32_t switchCount;       // Times switched in.
+};
+// Since startup or BspResetCpuTime(). The calling thread is counted up to the call.
+void BspGetCpuTime(uint8_t prio, BspCpuTime &time);
+// Elapsed time in cycles, by the system tick, since startup or BspResetCpuTime().
+uint64_t BspGetCpuElapsed();
+void BspResetCpuTime();
+
+// Prevents tickless idle from entering STOP1/STOP2, in which peripheral clocks are stopped. It is needed by drivers
+// that must keep running while the CPU is idle (a non-circular DMA transfer in flight already prevents them).
+// Calls nest.
+void BspDeepSleepLock();
+void BspDeepSleepUnlock();
+// Limits tickless idle to STOP1. It is needed by drivers running a circular DMA transfer while idle whose peripheral
+// can only wake up the CPU from STOP1, e.g. UART reception with USART wakeup from Stop mode (see UartIn). Calls nest.
+void BspStop2Lock();
+void BspStop2Unlock();
+
+#ifdef ENABLE_BSP_TICKLESS
+// Interrupts that end tickless idle, grouped by subsystem.
+enum BspWakeReason {
+    BSP_WAKE_TIMER,         // LPTIM1 at the timer deadline.
+    BSP_WAKE_TICK,          // SysTick, when the idle period is short.
+    BSP_WAKE_GPIO,          // EXTI (buttons, Wifi, sensors).
+    BSP_WAKE_UART,
+    BSP_WAKE_DMA,
+    BSP_WAKE_BUS,           // I2C and SPI.
+    BSP_WAKE_OTHER,
+    BSP_WAKE_COUNT
+};
+struct BspIdleStat {
+    uint32_t stopMs;                        // Time in STOP1 or STOP2.
+    uint32_t sleepMs;                       // Time in sleep with SysTick stopped when STOP modes are not allowed.
+    uint32_t stopCount;
+    uint32_t sleepCount;
+    uint32_t shortCount;                    // Idle entries with the next tick due too soon, which sleep with SysTick.
+    uint32_t wakeCount[BSP_WAKE_COUNT];
+    uint32_t awakeMs[BSP_WAKE_COUNT];       // Run time from each wakeup until idle again.
+};
+// Since startup or BspResetIdleStat().
+void BspGetIdleStat(BspIdleStat &stat);
+void BspResetIdleStat();
+char const *BspGetWakeName(uint8_t reason);
+#endif
+
 #endif // BSP_H
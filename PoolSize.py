@@ -0,0 +1,146 @@
+import math
+import re
+import sys
+
+#Recommends event pool sizes and counts for Fw (see EVT_SIZE_xxx and EVT_COUNT_xxx in fw.h) from the output of
+#"sys pool" (or Host/build/fw_bench) captured after a representative run. Signal lines are only present when
+#ENABLE_FW_POOL_STAT is defined in fw_poolstat.h. Without them the current pool sizes are kept.
+#
+#Usage: python PoolSize.py <capture file> [pool count (default 3)] [margin in percent (default 25)]
+
+ALIGN = 4           #Block sizes are rounded up to the alignment of the event pools.
+MIN_COUNT = 2       #Minimum number of blocks per pool.
+
+def RoundUp(v, align):
+    return (v + align - 1) // align * align
+
+#Return (pools, sigs). pools is a list of dict sorted by block size. sigs is a list of (name, size, count).
+#A signal followed by a histogram line ("low-high:count" per non-empty bin) gets one entry per bin, sized by the
+#upper bound of the bin capped at the max size of the signal. Otherwise all its allocations take the max size.
+#Counts may therefore be fractional.
+def Parse(fileName):
+    pools = []
+    sigs = []
+    last = None
+    f = open(fileName, 'rt')
+    for line in f:
+        token = line.split()
+        if len(token) == 8 and token[0] == 'pool':
+            v = [int(t) for t in token[1:]]
+            pools.append({'id': v[0], 'size': v[1], 'count': v[2], 'maxUsed': v[4], 'alloc': v[5], 'fail': v[6]})
+            last = None
+        elif len(token) == 5 and token[0] == 'sig' and re.match(r'^\d+$', token[3]):
+            last = (token[1], int(token[3]), int(token[4]))
+            sigs.append((last[0], RoundUp(last[1], ALIGN), last[2]))
+        elif last and token and all(re.match(r'^\d+-\d+:\d+$', t) for t in token):
+            sigs.pop()
+            bins = [[int(v) for v in t.split('-')[1].split(':')] for t in token]
+            #Bins saturate on target. Scale them so they add up to the total count of the signal.
+            total = sum(count for high, count in bins)
+            for high, count in bins:
+                sigs.append((last[0], RoundUp(min(high, last[1]), ALIGN), count * last[2] / total if total else 0))
+            last = None
+        else:
+            last = None
+    f.close()
+    pools.sort(key=lambda p: p['size'])
+    return pools, sigs
+
+#Return the index of the first pool whose block size fits size, or None.
+def FindPool(sizes, size):
+    for i, s in enumerate(sizes):
+        if size <= s:
+            return i
+    return None
+
+#Partition the distinct signal sizes into at most poolCount pools, minimizing the bytes wasted per allocation
+#(block size - event size) weighted by the allocation count of each signal.
+def ChooseSizes(sigs, poolCount):
+    weight = {}
+    for name, size, count in sigs:
+        weight[size] = weight.get(size, 0) + count
+    sizes = sorted(weight.keys())
+    n = len(sizes)
+    if n <= poolCount:
+        return sizes
+    #Waste of grouping sizes[i..j] into a block of sizes[j].
+    def Waste(i, j):
+        return sum(weight[sizes[k]] * (sizes[j] - sizes[k]) for k in range(i, j + 1))
+    INF = float('inf')
+    #best[p][j] = minimum waste covering sizes[0..j] with p pools, the last one ending at j.
+    best = [[INF] * n for _ in range(poolCount + 1)]
+    prev = [[-1] * n for _ in range(poolCount + 1)]
+    for j in range(n):
+        best[1][j] = Waste(0, j)
+    for p in range(2, poolCount + 1):
+        for j in range(n):
+            for i in range(j):
+                w = best[p - 1][i] + Waste(i + 1, j)
+                if w < best[p][j]:
+                    best[p][j] = w
+                    prev[p][j] = i
+    p = min(range(1, poolCount + 1), key=lambda k: best[k][n - 1])
+    result = []
+    j = n - 1
+    while p >= 1 and j >= 0:
+        result.append(sizes[j])
+        j = prev[p][j]
+        p -= 1
+    return sorted(result)
+
+#Estimate the peak number of blocks in use for each new pool. The peak of each current pool is split among the
+#new pools in proportion to the allocations of the signals it served.
+def EstimatePeak(pools, sigs, newSizes):
+    curSizes = [p['size'] for p in pools]
+    peak = [0.0] * len(newSizes)
+    for c, pool in enumerate(pools):
+        served = [(s, n) for name, s, n in sigs if FindPool(curSizes, s) == c]
+        total = sum(n for s, n in served)
+        if total == 0:
+            if pool['maxUsed'] == 0:
+                continue
+            #No signal information. Keep the peak in the new pool covering the current block size.
+            i = FindPool(newSizes, pool['size'])
+            if i is None:
+                print("Warning: pool {0} (size {1}) was used but no signal information covers it.".format(pool['id'], pool['size']))
+                i = len(newSizes) - 1
+            peak[i] += pool['maxUsed']
+            continue
+        for s, n in served:
+            peak[FindPool(newSizes, s)] += pool['maxUsed'] * n / total
+    return peak
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: python PoolSize.py <capture file> [pool count] [margin in percent]")
+        exit()
+    poolCount = int(sys.argv[2]) if len(sys.argv) > 2 else 3
+    margin = int(sys.argv[3]) if len(sys.argv) > 3 else 25
+    pools, sigs = Parse(sys.argv[1])
+    if not pools:
+        print("No pool lines found in", sys.argv[1])
+        exit()
+    for pool in pools:
+        if pool['fail']:
+            print("Warning: pool {0} (size {1}) failed {2} allocations. Its peak usage is underestimated."
+                  .format(pool['id'], pool['size'], pool['fail']))
+    newSizes = ChooseSizes(sigs, poolCount) if sigs else [p['size'] for p in pools]
+    peak = EstimatePeak(pools, sigs, newSizes)
+    newCounts = [max(MIN_COUNT, int(math.ceil(pk * (100 + margin) / 100.0))) for pk in peak]
+
+    curRam = sum(p['size'] * p['count'] for p in pools)
+    newRam = sum(s * c for s, c in zip(newSizes, newCounts))
+    print("Current:     " + ", ".join("{0}x{1}".format(p['size'], p['count']) for p in pools) + " = {0} bytes".format(curRam))
+    print("Recommended: " + ", ".join("{0}x{1}".format(s, c) for s, c in zip(newSizes, newCounts)) + " = {0} bytes".format(newRam))
+    print("(estimated peak in use: " + ", ".join("{0:.1f}".format(pk) for pk in peak) + ", margin {0}%)".format(margin))
+    if not sigs:
+        return
+    print("Signals per recommended pool:")
+    for i, size in enumerate(newSizes):
+        names = []
+        for name, s, n in sigs:
+            if FindPool(newSizes, s) == i and name not in names:
+                names.append(name)
+        print("  {0:5}: {1}".format(size, " ".join(names)))
+
+main()
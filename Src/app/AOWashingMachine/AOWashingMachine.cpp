@@ -65,6 +65,8 @@ static char const * const interfaceEvtName[] = {
     AO_WASHING_MACHINE_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(AO_WASHING_MACHINE);
+
 // Constants used within this file.
 static const uint16_t NORMAL_WASH_TIME_MS = 3000;
 static const uint16_t NORMAL_RINSE_TIME_MS = 3000;
@@ -94,9 +96,7 @@ AOWashingMachine::AOWashingMachine() :
        m_history(&FillingWash),
        m_washTimer(GetHsmn(), WASH_TIMEOUT),
        m_rinseTimer(GetHsmn(), RINSE_TIMEOUT),
-       m_spinTimer(GetHsmn(), SPIN_TIMEOUT) {
-    SET_EVT_NAME(AO_WASHING_MACHINE);
-}
+       m_spinTimer(GetHsmn(), SPIN_TIMEOUT) {}
 
 QState AOWashingMachine::InitialPseudoState(AOWashingMachine * const me, QEvt const * const e) {
     (void)e;
@@ -67,6 +67,8 @@ static char const * const interfaceEvtName[] = {
     "CMD_INPUT_CHAR_REQ",
 };
 
+DEFINE_EVT_NAME(CMD_INPUT);
+
 char const CmdInput::BS_SP_BS[]  = { BS, SP, BS, 0 };
 char const CmdInput::CR_LF[]     = { CR, LF, 0 };
 char const CmdInput::UP1[]   = { 0x41, 0x00 };
@@ -85,9 +87,7 @@ bool CmdInput::IsDown() {
 
 CmdInput::CmdInput(Hsmn hsmn, char const *name, Console &console) :
     Region((QStateHandler)&CmdInput::InitialPseudoState, hsmn, name),
-    m_console(console), m_stateTimer(GetHsmn(), STATE_TIMER) {
-    SET_EVT_NAME(CMD_INPUT);
-}
+    m_console(console), m_stateTimer(GetHsmn(), STATE_TIMER) {}
 
 QState CmdInput::InitialPseudoState(CmdInput * const me, QEvt const * const e) {
     (void)e;
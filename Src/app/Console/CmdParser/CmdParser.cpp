@@ -64,12 +64,12 @@ static char const * const interfaceEvtName[] = {
     "CMD_PARSER_STOP_REQ",
 };
 
+DEFINE_EVT_NAME(CMD_PARSER);
+
 CmdParser::CmdParser(Hsmn hsmn, char const *name) :
     Region((QStateHandler)&CmdParser::InitialPseudoState, hsmn, name),
     m_cmdStr(NULL), m_argv(NULL), m_argc(0), m_maxArgc(0), m_index(-1),
-    m_stateTimer(GetHsmn(), STATE_TIMER) {
-    SET_EVT_NAME(CMD_PARSER);
-}
+    m_stateTimer(GetHsmn(), STATE_TIMER) {}
 
 QState CmdParser::InitialPseudoState(CmdParser * const me, QEvt const * const e) {
     (void)e;
@@ -40,6 +40,7 @@
 #include <stdio.h>
 #include "app_hsmn.h"
 #include "fw_log.h"
+#include "fw_format.h"
 #include "fw_assert.h"
 #include "ConsoleInterface.h"
 #include "UartActInterface.h"
@@ -56,6 +57,8 @@ namespace APP {
 
 static char const * const timerEvtName[] = {
     "STATE_TIMER",
+    "CONSOLE_TIMER",
+    "LOG_DRAIN_TIMER",
 };
 
 static char const * const internalEvtName[] = {
@@ -63,6 +66,8 @@ static char const * const internalEvtName[] = {
     "FAILED",
     "CMD_RECV",
     "RAW_DISABLE",
+    "CONSOLE_CMD",
+    "LOG_DRAIN",
 };
 
 static char const * const interfaceEvtName[] = {
@@ -74,6 +79,8 @@ static char const * const interfaceEvtName[] = {
     "CONSOLE_RAW_ENABLE_REQ",
 };
 
+DEFINE_EVT_NAME(CONSOLE);
+
 enum {
     OUT_FIFO_ORDER = 13,
     IN_FIFO_ORDER = 10,
@@ -117,7 +124,7 @@ uint32_t Console::Print(char const *format, ...) {
     va_list arg;
     va_start(arg, format);
     char buf[Log::BUF_LEN];
-    uint32_t len = vsnprintf(buf, sizeof(buf), format, arg);
+    uint32_t len = Format::PrintV(buf, sizeof(buf), format, arg);
     va_end(arg);
     len = LESS(len, sizeof(buf) - 1);
     return Log::Write(m_outIfHsmn, buf, len);
@@ -127,7 +134,7 @@ uint32_t Console::PrintItem(uint32_t index, uint32_t minWidth, uint32_t itemPerL
     va_list arg;
     va_start(arg, format);
     char buf[Log::BUF_LEN];
-    vsnprintf(buf, sizeof(buf), format, arg);
+    Format::PrintV(buf, sizeof(buf), format, arg);
     va_end(arg);
     uint32_t result = Log::PrintItem(m_outIfHsmn, index, minWidth, itemPerLine, "%s", buf);
     return result;
@@ -294,8 +301,8 @@ Console::Console(Hsmn hsmn, char const *name, char const *cmdInputName, char con
     m_inFifo(GetInFifoStor(hsmn), IN_FIFO_ORDER),
     m_argc(0), m_rootCmdFunc(NULL), m_lastCmdFunc(NULL), m_msgSeq(""), m_evtSeq(HSM_UNDEF),
     m_stateTimer(GetHsmn(), STATE_TIMER),
-    m_consoleTimer(GetHsmn(), CONSOLE_TIMER) {
-    SET_EVT_NAME(CONSOLE);
+    m_consoleTimer(GetHsmn(), CONSOLE_TIMER),
+    m_logDrainTimer(GetHsmn(), LOG_DRAIN_TIMER), m_logDrainPending(false) {
     FW_ASSERT((hsmn >= CONSOLE) && (hsmn <= CONSOLE_LAST));
 }
 
@@ -480,6 +487,13 @@ QState Console::Started(Console * const me, QEvt const * const e) {
             // Add other interface types here.
             FW_ASSERT(writeReqSig);
             Log::AddInterface(me->m_outIfHsmn, &me->m_outFifo, writeReqSig, me->m_isDefault);
+#ifdef ENABLE_LOG_DRAIN
+            // As the lowest priority active object, the default console formats deferred log records
+            // and flushes batched output.
+            if (me->m_isDefault) {
+                Log::SetDrain(me->GetHsmn(), LOG_DRAIN);
+            }
+#endif
             // Start input region.
             CmdInputStartReq req(me->GetCmdInputHsmn(), me->GetHsmn(), QEvt::STATIC_EVT);
             me->m_cmdInput.Dispatch(&req);
@@ -490,6 +504,14 @@ QState Console::Started(Console * const me, QEvt const * const e) {
         }
         case Q_EXIT_SIG: {
             EVENT(e);
+#ifdef ENABLE_LOG_DRAIN
+            if (me->m_isDefault) {
+                // Writes out pending records and output immediately.
+                Log::SetDrain(HSM_UNDEF, 0);
+            }
+            me->m_logDrainTimer.Stop();
+            me->m_logDrainPending = false;
+#endif
             Log::RemoveInterface(me->m_outIfHsmn);
             return Q_HANDLED();
         }
@@ -519,6 +541,43 @@ QState Console::Started(Console * const me, QEvt const * const e) {
             }
             return Q_HANDLED();
         }
+#ifdef ENABLE_LOG_DRAIN
+        // Must not log here, as each log record would trigger another drain.
+        case LOG_DRAIN:
+        case LOG_DRAIN_TIMER: {
+            bool wait = false;
+            if (e->sig == LOG_DRAIN_TIMER) {
+                me->m_logDrainPending = false;
+            }
+#ifdef ENABLE_LOG_DEFER
+            uint32_t count = LOG_DRAIN_COUNT;
+            while (count && !Log::IsDeferEmpty() && (me->GetLogRoom() >= Log::BUF_LEN)) {
+                Log::Drain();
+                count--;
+            }
+            if (!Log::IsDeferEmpty()) {
+                if (count) {
+                    // Waits for room in the output FIFO.
+                    wait = true;
+                } else {
+                    me->Send(new Evt(LOG_DRAIN), me->GetHsmn());
+                }
+            }
+#endif
+#ifdef ENABLE_LOG_BATCH
+            // Staged output is flushed once per timeout, or immediately when it reaches the threshold.
+            if ((e->sig == LOG_DRAIN_TIMER) || Log::IsBatchReady()) {
+                Log::Flush();
+            }
+            wait |= !Log::IsBatchEmpty();
+#endif
+            if (wait && !me->m_logDrainPending) {
+                me->m_logDrainTimer.Start(LOG_DRAIN_TIMEOUT_MS);
+                me->m_logDrainPending = true;
+            }
+            return Q_HANDLED();
+        }
+#endif
         default: {
             QSignal sig = e->sig;
             if ((sig == CONSOLE_TIMER) ||
@@ -44,7 +44,9 @@
 #include "fw_timer.h"
 #include "fw_evt.h"
 #include "fw_pipe.h"
+#include "fw_spscpipe.h"
 #include "fw_seqrec.h"
+#include "fw_log.h"
 #include "app_hsmn.h"
 #include "CmdInput.h"
 #include "CmdParser.h"
@@ -63,7 +65,7 @@ public:
 
     // Helper functions for use by console commands.
     Hsmn GetOutIfHsmn() const { return m_outIfHsmn; }
-    Fifo &GetInFifo() { return m_inFifo; }
+    SpscFifo &GetInFifo() { return m_inFifo; }
     uint32_t PutChar(char c);
     uint32_t PutCharN(char c, uint32_t count);
     uint32_t PutStr(char const *str);
@@ -105,6 +107,12 @@ protected:
     Hsmn GetCmdParserHsmn() { return CMD_PARSER + GetInst(); }
     bool IsUart() { return (m_ifHsmn >= UART_ACT) && (m_ifHsmn  <= UART_ACT_LAST); }
     // Add other interface type check here.
+#ifdef ENABLE_LOG_BATCH
+    // Formatted log records go to the staging buffer.
+    uint32_t GetLogRoom() { return Log::GetBatchAvailCount(); }
+#else
+    uint32_t GetLogRoom() { return m_outFifo.GetAvailCount(); }
+#endif
     void Banner();
     void Prompt();
     CmdStatus RunCmd(char const **argv, uint32_t argc, CmdHandler const *cmd, uint32_t cmdCount);
@@ -125,11 +133,13 @@ protected:
         MAX_ARGC = 8,
         MAX_VAR = 8,
         CHAR_LOOP_COUNT = 10,   // Maximum no. of characters to process in a loop.
+        LOG_DRAIN_COUNT = 4,    // Maximum no. of deferred log records to format per LOG_DRAIN.
+        LOG_DRAIN_TIMEOUT_MS = 10,  // Batch interval of log output, and retry interval when there is no room for a record.
     };
 
     // FIFO storage is defined in cpp to allow custom memory location.
     Fifo m_outFifo;
-    Fifo m_inFifo;
+    SpscFifo m_inFifo;
     char m_cmdStr[CmdInput::MAX_LEN];
     char const *m_argv[MAX_ARGC];
     uint32_t m_argc;
@@ -141,12 +151,15 @@ protected:
 
     Timer m_stateTimer;
     Timer m_consoleTimer;       // General timer for command handlers.
+    Timer m_logDrainTimer;
+    bool m_logDrainPending;     // True if m_logDrainTimer is running.
 
 public:
     // Timer and internal events are public for use by command handlers which are not member functions of Console.
     enum {
         STATE_TIMER = TIMER_EVT_START(CONSOLE),
         CONSOLE_TIMER,          // General timeout event for command handlers.
+        LOG_DRAIN_TIMER,
     };
 
     enum {
@@ -155,6 +168,7 @@ public:
         CMD_RECV,
         RAW_DISABLE,
         CONSOLE_CMD,            // Sent to command handlers to indicate the execution of a new command.
+        LOG_DRAIN,              // Deferred log records or batched output are pending (see Log::SetDrain()).
     };
 
     class Failed : public ErrorEvt {
@@ -159,12 +159,41 @@ static CmdStatus Ver(Console &console, Evt const *e) {
     return CMD_DONE;
 }
 
+static CmdStatus Stat(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            Console::ConsoleCmd const &cmd = static_cast<Console::ConsoleCmd const &>(*e);
+            if ((cmd.Argc() > 1) && STRING_EQUAL(cmd.Argv(1), "reset")) {
+                Log::ResetTruncCount();
+                console.Print("Log counts reset\n\r");
+                break;
+            }
+            console.Print("Truncated writes:\n\r");
+            for (Hsmn hsmn = 0; hsmn < HSM_COUNT; hsmn++) {
+                uint32_t count = Log::GetTruncCount(hsmn);
+                if (count) {
+                    console.Print("%-20s %lu\n\r", Log::GetHsmName(hsmn), count);
+                }
+            }
+#ifdef ENABLE_LOG_BATCH
+            console.Print("Batch drops = %lu\n\r", Log::GetBatchDropCount());
+#endif
+#ifdef ENABLE_LOG_DEFER
+            console.Print("Deferred drops = %lu\n\r", Log::GetDeferDropCount());
+#endif
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
 static CmdStatus List(Console &console, Evt const *e);
 static CmdHandler const cmdHandler[] = {
     { "show",       Show,       "Show config", 0 },
     { "on",         On,         "Enable log", 0 },
     { "off",        Off,        "Disable log", 0 },
     { "ver",        Ver,        "Set verbosity", 0 },
+    { "stat",       Stat,       "Truncation counts [reset]", 0 },
     { "?",          List,       "List commands", 0 },
 };
 
@@ -64,11 +64,11 @@ static char const * const interfaceEvtName[] = {
     DEMO_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(DEMO);
+
 Demo::Demo() :
     Active((QStateHandler)&Demo::InitialPseudoState, DEMO, "DEMO"),
-    m_stateTimer(GetHsmn(), STATE_TIMER), m_inEvt(QEvt::STATIC_EVT) {
-    SET_EVT_NAME(DEMO);
-}
+    m_stateTimer(GetHsmn(), STATE_TIMER), m_inEvt(QEvt::STATIC_EVT) {}
 
 QState Demo::InitialPseudoState(Demo * const me, QEvt const * const e) {
     (void)e;
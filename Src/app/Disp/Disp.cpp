@@ -100,12 +100,12 @@ static char const * const interfaceEvtName[] = {
     DISP_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(DISP);
+
 Disp::Disp(QP::QStateHandler const initial, Hsmn hsmn, char const *name) :
     Region(initial, hsmn, name),
     m_cursorX(0), m_cursorY(0), m_textcolor(COLOR565_BLACK), m_textbgcolor(COLOR565_WHITE),
-    m_textsize(1), m_wrap(true), m_gfxFont(NULL) {
-    SET_EVT_NAME(DISP);
-}
+    m_textsize(1), m_wrap(true), m_gfxFont(NULL) {}
 
 // Fills a memory buffer of dimension colxrow pixels with a rectangle of size wxh pixels at location (x, y).
 // The fill color is specified by color. Each pixel has two bytes.
@@ -64,6 +64,8 @@ static char const * const interfaceEvtName[] = {
     GPIO_IN_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(GPIO_IN);
+
 // The order below must match that in app_hsmn.h.
 static char const * const hsmName[] = {
     "USER_BTN",
@@ -204,7 +206,6 @@ GpioIn::GpioIn() :
     m_config(NULL), m_client(HSM_UNDEF), m_debouncing(true),
     m_stateTimer(GetHsmn(), STATE_TIMER), m_pulseTimer(GetHsmn(), PULSE_TIMER),
     m_holdTimer(GetHsmn(), HOLD_TIMER) {
-    SET_EVT_NAME(GPIO_IN);
     uint32_t i;
     for (i = 0; i < ARRAY_COUNT(CONFIG); i++) {
         if (CONFIG[i].hsmn == GetHsmn()) {
@@ -45,6 +45,8 @@ FW_DEFINE_THIS_FILE("GpioInAct.cpp")
 
 namespace APP {
 
+DEFINE_NO_EVT_NAME(GPIO_IN_ACT);
+
 GpioInAct::GpioInAct() :
     Active((QStateHandler)&GpioInAct::InitialPseudoState, GPIO_IN_ACT, "GPIO_IN_ACT") {}
 
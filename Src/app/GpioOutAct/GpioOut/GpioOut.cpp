@@ -67,6 +67,8 @@ static char const * const interfaceEvtName[] = {
     GPIO_OUT_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(GPIO_OUT);
+
 // The order below must match that in app_hsmn.h.
 static char const * const hsmName[] = {
     "USER_LED",
@@ -188,7 +190,6 @@ GpioOut::GpioOut() :
     FW::Region((QStateHandler)&GpioOut::InitialPseudoState, GetCurrHsmn(), GetCurrName()),
     m_config(NULL), m_currPattern(NULL), m_intervalIndex(0), m_isRepeat(false),
     m_intervalTimer(GetHsmn(), INTERVAL_TIMER) {
-    SET_EVT_NAME(GPIO_OUT);
     uint32_t i;
     for (i = 0; i < ARRAY_COUNT(CONFIG); i++) {
         if (CONFIG[i].hsmn == GetHsmn()) {
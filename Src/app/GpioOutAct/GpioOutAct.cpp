@@ -45,6 +45,8 @@ FW_DEFINE_THIS_FILE("GpioOutAct.cpp")
 
 namespace APP {
 
+DEFINE_NO_EVT_NAME(GPIO_OUT_ACT);
+
 GpioOutAct::GpioOutAct() :
     Active((QStateHandler)&GpioOutAct::InitialPseudoState, GPIO_OUT_ACT, "GPIO_OUT_ACT") {}
 
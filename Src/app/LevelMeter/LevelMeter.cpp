@@ -36,10 +36,10 @@
  * Email - admin@galliumstudio.com
  ******************************************************************************/
 
-#include <stdio.h>
 #include <math.h>
 #include "app_hsmn.h"
 #include "fw_log.h"
+#include "fw_format.h"
 #include "fw_assert.h"
 #include "DispInterface.h"
 #include "SensorInterface.h"
@@ -70,6 +70,8 @@ static char const * const interfaceEvtName[] = {
     LEVEL_METER_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(LEVEL_METER);
+
 LevelMeter::LevelMeter() :
     Active((QStateHandler)&LevelMeter::InitialPseudoState, LEVEL_METER, "LEVEL_METER"),
     m_accelGyroPipe(m_accelGyroStor, ACCEL_GYRO_PIPE_ORDER),
@@ -77,9 +79,7 @@ LevelMeter::LevelMeter() :
     m_pitch(0.0), m_roll(0.0), m_pitchThres(45.0), m_rollThres(45.0),
     m_humidity(0.0), m_temperature(0.0), m_inEvt(QEvt::STATIC_EVT), m_msgSeq(""),
     m_stateTimer(GetHsmn(), STATE_TIMER),
-    m_reportTimer(GetHsmn(), REPORT_TIMER) {
-    SET_EVT_NAME(LEVEL_METER);
-}
+    m_reportTimer(GetHsmn(), REPORT_TIMER) {}
 
 QState LevelMeter::InitialPseudoState(LevelMeter * const me, QEvt const * const e) {
     (void)e;
@@ -365,24 +365,24 @@ QState LevelMeter::Redrawing(LevelMeter * const me, QEvt const * const e) {
             char buf[30];
 
             Log::FloatToStr(val, sizeof(val), me->m_pitch,  6,  2);
-            snprintf(buf, sizeof(buf), "P= %s", val);
+            Format::Print(buf, sizeof(buf), "P= %s", val);
             me->Send(new DispDrawTextReq(buf, 10, 30, COLOR24_BLUE, COLOR24_GREEN, 4), ILI9341);
             Log::FloatToStr(val, sizeof(val), me->m_roll,  6,  2);
-            snprintf(buf, sizeof(buf), "R= %s", val);
+            Format::Print(buf, sizeof(buf), "R= %s", val);
             me->Send(new DispDrawTextReq(buf, 10, 90, COLOR24_BLUE, COLOR24_GREEN, 4), ILI9341);
 
             Log::FloatToStr(val, sizeof(val), me->m_pitchThres,  5,  2);
-            snprintf(buf, sizeof(buf), "PT= %s", val);
+            Format::Print(buf, sizeof(buf), "PT= %s", val);
             me->Send(new DispDrawTextReq(buf, 10, 150, COLOR24_BLACK, COLOR24_WHITE, 4), ILI9341);
             Log::FloatToStr(val, sizeof(val), me->m_rollThres,  5,  2);
-            snprintf(buf, sizeof(buf), "RT= %s", val);
+            Format::Print(buf, sizeof(buf), "RT= %s", val);
             me->Send(new DispDrawTextReq(buf, 10, 210, COLOR24_BLACK, COLOR24_WHITE, 4), ILI9341);
 
             Log::FloatToStr(val, sizeof(val), me->m_humidity,  5,  2);
-            snprintf(buf, sizeof(buf), "H= %s", val);
+            Format::Print(buf, sizeof(buf), "H= %s", val);
             me->Send(new DispDrawTextReq(buf, 10, 280, COLOR24_DARK_GRAY, COLOR24_WHITE, 2), ILI9341);
             Log::FloatToStr(val,  sizeof(val), me->m_temperature,  5,  2);
-            snprintf(buf, sizeof(buf), "T= %s", val);
+            Format::Print(buf, sizeof(buf), "T= %s", val);
             me->Send(new DispDrawTextReq(buf, 120, 280, COLOR24_DARK_GRAY, COLOR24_WHITE, 2), ILI9341);
 
             me->Send(new DispDrawEndReq(), ILI9341);
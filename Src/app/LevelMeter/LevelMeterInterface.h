@@ -42,6 +42,7 @@
 #include "fw_def.h"
 #include "fw_evt.h"
 #include "fw_msg.h"
+#include "fw_payload.h"
 #include "app_hsmn.h"
 #include "SensorMsgInterface.h"
 
@@ -104,20 +105,21 @@ public:
         ErrorEvt(LEVEL_METER_STOP_CFM, error, origin, reason) {}
 };
 
+// The message is accessed in place in the payload received by Node rather than copied. The payload is held
+// until this event is garbage collected.
 class LevelMeterControlReq : public MsgEvt {
 public:
     enum {
         TIMEOUT_MS = 300
     };
-    // Must pass 'm_msg' as reference to member object and NOT the parameter 'msg'.
-    LevelMeterControlReq(SensorControlReqMsg const &r) :
-        MsgEvt(LEVEL_METER_CONTROL_REQ, m_msg), m_msg(r) {
-        LEVEL_METER_INTERFACE_ASSERT(&GetMsgBase() == &m_msg);
+    LevelMeterControlReq(Payload *payload) :
+        MsgEvt(LEVEL_METER_CONTROL_REQ, payload->GetAs<SensorControlReqMsg>()) {
+        payload->AttachTo(this);
     }
-    float GetPitchThres() const { return m_msg.GetPitchThres(); }
-    float GetRollThres() const { return m_msg.GetRollThres(); }
+    float GetPitchThres() const { return GetMsg().GetPitchThres(); }
+    float GetRollThres() const { return GetMsg().GetRollThres(); }
 protected:
-    SensorControlReqMsg m_msg;
+    SensorControlReqMsg const &GetMsg() const { return static_cast<SensorControlReqMsg const &>(GetMsgBase()); }
 };
 
 class LevelMeterControlCfm : public ErrorMsgEvt {
@@ -146,14 +148,13 @@ protected:
     SensorDataIndMsg m_msg;
 };
 
+// See LevelMeterControlReq.
 class LevelMeterDataRsp : public ErrorMsgEvt {
 public:
-    LevelMeterDataRsp(SensorDataRspMsg const &r) :
-        ErrorMsgEvt(LEVEL_METER_DATA_RSP, m_msg), m_msg(r) {
-        LEVEL_METER_INTERFACE_ASSERT(&GetMsgBase() == &m_msg);
+    LevelMeterDataRsp(Payload *payload) :
+        ErrorMsgEvt(LEVEL_METER_DATA_RSP, payload->GetAs<SensorDataRspMsg>()) {
+        payload->AttachTo(this);
     }
-protected:
-    SensorDataRspMsg m_msg;
 };
 
 } // namespace APP
@@ -70,6 +70,8 @@ static char const * const interfaceEvtName[] = {
     NODE_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(NODE);
+
 bool Node::SendMsg(Msg &m, uint32_t len) {
     // For log.
     auto me = this;
@@ -103,13 +105,13 @@ bool Node::SendMsg(Msg &m, uint32_t len, char const *to, uint16_t seq) {
 
 MsgEvt *Node::HandleMsg(NodeParserMsgInd const &ind, Hsmn &to) {
     to = HSM_UNDEF;
-    if (auto m = CHECK_MSG_LOG(SensorControlReqMsg, ind)) {
+    if (CHECK_MSG_LOG(SensorControlReqMsg, ind)) {
         to = LEVEL_METER;
-        return new LevelMeterControlReq(*m);
+        return new LevelMeterControlReq(ind.GetPayload());
     }
-    if (auto m = CHECK_MSG_LOG(SensorDataRspMsg, ind)) {
+    if (CHECK_MSG_LOG(SensorDataRspMsg, ind)) {
         to = LEVEL_METER;
-        return new LevelMeterDataRsp(*m);
+        return new LevelMeterDataRsp(ind.GetPayload());
     }
     // @todo Add other message handling here.
     return nullptr;
@@ -122,7 +124,6 @@ Node::Node() :
     m_stateTimer(GetHsmn(), STATE_TIMER), m_retryTimer(GetHsmn(), RETRY_TIMER),
     m_pingReqTimer(GetHsmn(), PING_REQ_TIMER), m_pingCfmTimer(GetHsmn(), PING_CFM_TIMER),
     m_recoveryWaitTimer(GetHsmn(), RECOVERY_WAIT_TIMER) {
-    SET_EVT_NAME(NODE);
     STRBUF_COPY(m_srvId, "Srv");
     STRBUF_COPY(m_nodeId, MSG_UNDEF);
 }
@@ -44,6 +44,7 @@
 #include "fw_timer.h"
 #include "fw_evt.h"
 #include "fw_log.h"
+#include "fw_spscpipe.h"
 #include "app_hsmn.h"
 #include "NodeParser.h"
 #include "NodeParserInterface.h"
@@ -113,7 +114,7 @@ protected:
     uint8_t m_dataOutFifoStor[ROUND_UP_32(1 << DATA_OUT_FIFO_ORDER)] __attribute__((aligned(32)));
     uint8_t m_dataInFifoStor[ROUND_UP_32(1 << DATA_IN_FIFO_ORDER)] __attribute__((aligned(32)));
     Fifo m_dataOutFifo;
-    Fifo m_dataInFifo;
+    SpscFifo m_dataInFifo;
     char m_domain[NodeStartReq::DOMAIN_LEN];    // Server domain or IP address string.
     uint16_t m_port;                            // Server port.
     char m_srvId[SrvAuthCfmMsg::NODE_ID_LEN];   // Currently fixed to "Srv" in ctor.
@@ -66,12 +66,12 @@ static char const * const interfaceEvtName[] = {
     NODE_PARSER_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(NODE_PARSER);
+
 NodeParser::NodeParser() :
     Region((QStateHandler)&NodeParser::InitialPseudoState, NODE_PARSER, "NODE_PARSER"),
     m_manager(HSM_UNDEF), m_dataInFifo(nullptr), m_msgInd(nullptr), m_dataLen(0), m_msgIdx(0),
-    m_stateTimer(GetHsmn(), STATE_TIMER) {
-    SET_EVT_NAME(NODE_PARSER);
-}
+    m_stateTimer(GetHsmn(), STATE_TIMER) {}
 
 QState NodeParser::InitialPseudoState(NodeParser * const me, QEvt const * const e) {
     (void)e;
@@ -146,13 +146,16 @@ QState NodeParser::Started(NodeParser * const me, QEvt const * const e) {
           else ^WIFI_DATA_RSP
           */
             EVENT(e);
-            uint32_t readLen;
-            while ((readLen = LESS(me->m_dataLen, me->m_dataInFifo->GetUsedBlockCount()))) {
+            // Both blocks (if wrapped around) are copied directly from the fifo into the message buffer.
+            PipeSpan<uint8_t> span;
+            uint32_t readLen = me->m_dataInFifo->Peek(span, me->m_dataLen);
+            if (readLen) {
                 FW_ASSERT((me->m_msgIdx + readLen) <= NodeParserMsgInd::MAX_BUF_LEN);
-                memcpy(&me->m_msgInd->GetMsgBufMutable()[me->m_msgIdx],
-                       reinterpret_cast<uint8_t const*>(me->m_dataInFifo->GetReadAddr()), readLen);
-                INFO_BUF(reinterpret_cast<uint8_t const*>(me->m_dataInFifo->GetReadAddr()), readLen, 1, 0);
-                me->m_dataInFifo->IncReadIndex(readLen);
+                span.CopyTo(&me->m_msgInd->GetMsgBufMutable()[me->m_msgIdx], readLen);
+                for (uint32_t i = 0; i < span.GetBlockCount(); i++) {
+                    INFO_BUF(span.GetPtr(i), span.GetCount(i), 1, 0);
+                }
+                me->m_dataInFifo->Consume(readLen);
                 me->m_dataLen -= readLen;
                 me->m_msgIdx += readLen;
             }
@@ -178,9 +181,12 @@ QState NodeParser::HeaderWait(NodeParser * const me, QEvt const * const e) {
     switch (e->sig) {
         case Q_ENTRY_SIG: {
             EVENT(e);
-            me->m_msgInd = new NodeParserMsgInd();
+            Payload *payload = Payload::New();
+            me->m_msgInd = new NodeParserMsgInd(payload);
+            // m_msgInd now holds the only reference to the payload.
+            payload->Release();
             // m_msgInd will be filled in as data are received.
-            // It will either be sent upon completion or be freed upon exit of Started.
+            // It will either be sent upon completion or be freed upon exit of Started (along with its payload).
             me->m_dataLen = sizeof(Msg);
             me->m_msgIdx = 0;
             LOG("HeaderWait dataLen = %d", me->m_dataLen);
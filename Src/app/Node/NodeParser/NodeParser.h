@@ -64,7 +64,7 @@ protected:
             static QState BodyWait(NodeParser * const me, QEvt const * const e);
 
     Hsmn m_manager;                 // Managing HSM (i.e. Node)
-    Fifo *m_dataInFifo;             // FIFO carrying data from Wifi.
+    SpscFifo *m_dataInFifo;         // FIFO carrying data from Wifi.
     NodeParserMsgInd *m_msgInd;     // Saves partially received message event.
     uint32_t m_dataLen;             // No. of bytes of data to be received next.
     uint32_t m_msgIdx;              // Index to the msg buffer to write to next.
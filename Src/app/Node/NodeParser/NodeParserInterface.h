@@ -43,9 +43,11 @@
 #include "fw_macro.h"
 #include "fw_evt.h"
 #include "fw_pipe.h"
+#include "fw_spscpipe.h"
 #include "fw_assert.h"
 #include "app_hsmn.h"
 #include "fw_msg.h"
+#include "fw_payload.h"
 
 #define NODE_PARSER_INTERFACE_ASSERT(t_) ((t_) ? (void)0 : Q_onAssert("NodeParserInterface.h", (int_t)__LINE__))
 
@@ -79,11 +81,11 @@ public:
     enum {
         TIMEOUT_MS = 100
     };
-    NodeParserStartReq(Fifo *dataInFifo) :
+    NodeParserStartReq(SpscFifo *dataInFifo) :
         Evt(NODE_PARSER_START_REQ), m_dataInFifo(dataInFifo) {}
-    Fifo *GetDataInFifo() const { return m_dataInFifo; }
+    SpscFifo *GetDataInFifo() const { return m_dataInFifo; }
 private:
-    Fifo *m_dataInFifo;
+    SpscFifo *m_dataInFifo;
 };
 
 // Not used.
@@ -115,22 +117,27 @@ public:
         ErrorEvt(NODE_PARSER_ERROR_IND, error, origin, reason) {}
 };
 
+// The message is received into a payload buffer rather than the event itself, so the event is small and
+// the message can be passed on to other HSMs without copying (see LevelMeterControlReq).
 class NodeParserMsgInd : public Evt {
 public:
-    NodeParserMsgInd() :
-        Evt(NODE_PARSER_MSG_IND) {
+    // Holds a reference to payload until this event is garbage collected.
+    NodeParserMsgInd(Payload *payload) :
+        Evt(NODE_PARSER_MSG_IND), m_payload(payload) {
         NODE_PARSER_INTERFACE_ASSERT(IS_ALIGNED_4(MAX_BUF_LEN));
         NODE_PARSER_INTERFACE_ASSERT(MAX_BUF_LEN >= sizeof(Msg));
-        memset(m_msgBuf, 0, sizeof(m_msgBuf));
+        NODE_PARSER_INTERFACE_ASSERT(payload);
+        payload->AttachTo(this);
     }
     enum {
-        MAX_BUF_LEN = 2000      // Limited to max block size of event pools (see fw.h)
+        MAX_BUF_LEN = Payload::BUF_SIZE
     };
-    uint8_t *GetMsgBufMutable() { return reinterpret_cast<uint8_t *>(m_msgBuf); }
-    uint8_t const *GetMsgBuf() const { return reinterpret_cast<uint8_t const *>(m_msgBuf); }
-    char const *GetMsgType() const { return reinterpret_cast<Msg const *>(m_msgBuf)->GetType(); }
-    uint16_t GetMsgSeq() const { return reinterpret_cast<Msg const *>(m_msgBuf)->GetSeq(); }
-    uint32_t GetMsgLen() const { return reinterpret_cast<Msg const *>(m_msgBuf)->GetLen(); }
+    Payload *GetPayload() const { return m_payload; }
+    uint8_t *GetMsgBufMutable() { return m_payload->GetBufMutable(); }
+    uint8_t const *GetMsgBuf() const { return m_payload->GetBuf(); }
+    char const *GetMsgType() const { return GetMsg().GetType(); }
+    uint16_t GetMsgSeq() const { return GetMsg().GetSeq(); }
+    uint32_t GetMsgLen() const { return GetMsg().GetLen(); }
     bool IsMsgLenValid() const { return (GetMsgLen() >= sizeof(Msg)) && (GetMsgLen() <= MAX_BUF_LEN); }
     bool MatchMsgType(char const *type) const {
         NODE_PARSER_INTERFACE_ASSERT(type);
@@ -138,8 +145,8 @@ public:
     }
     bool MatchMsgLen(uint32_t len) const { return IsMsgLenValid() && (GetMsgLen() == len); }
 private:
-    // Ensures 4-byte aligned. This buffer will be casted into a message object.
-    uint32_t m_msgBuf[MAX_BUF_LEN/4];
+    Msg const &GetMsg() const { return m_payload->GetAs<Msg>(); }
+    Payload *m_payload;
 };
 
 } // namespace APP
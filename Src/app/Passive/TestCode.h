@@ -39,13 +39,13 @@
 #ifndef TESTCODE_H
 #define TESTCODE_H
 
-#include <stdio.h>
 #include <vector>
 #include <algorithm>
 #include <memory>
 #include "qpcpp.h"
 #include "periph.h"
 #include "fw_macro.h"
+#include "fw_format.h"
 #include "Console.h"
 #include "fw_assert.h"
 
@@ -68,7 +68,7 @@ public:
     uint32_t GetSeats() const { return m_seats; }
     uint32_t GetMpg() const { return m_mpg; }
     virtual void GetInfo(char *buf, uint32_t bufSize) const {
-        snprintf(buf, bufSize, "To be implemented in derived classes");
+        FW::Format::Print(buf, bufSize, "To be implemented in derived classes");
     }
     float RunningCost(float miles, float gasPrice) const {
         TEST_CODE_ASSERT(m_mpg);
@@ -103,7 +103,7 @@ public:
     ModelA(char const *vin) :
         Sedan(vin, 5, 35, false) {}
     void GetInfo(char *buf, uint32_t bufSize) const {
-        snprintf(buf, bufSize, "%s: ModelA sedan, seats=%lu, mpg=%lu, sporty=%d", m_vin, m_seats, m_mpg, m_sporty);
+        FW::Format::Print(buf, bufSize, "%s: ModelA sedan, seats=%lu, mpg=%lu, sporty=%d", m_vin, m_seats, m_mpg, m_sporty);
     }
 };
 
@@ -117,7 +117,7 @@ public:
         STRBUF_COPY(m_upgrade, upgrade);
     }
     void GetInfo(char *buf, uint32_t bufSize) const {
-        snprintf(buf, bufSize, "%s: ModelB SUV, seats=%lu, mpg=%lu, roofRack=%d, upgrade='%s'",
+        FW::Format::Print(buf, bufSize, "%s: ModelB SUV, seats=%lu, mpg=%lu, roofRack=%d, upgrade='%s'",
                 m_vin, m_seats, m_mpg, m_roofRack, m_upgrade);
     }
 private:
@@ -69,6 +69,8 @@ static char const * const interfaceEvtName[] = {
     SENSOR_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(SENSOR);
+
 // Define I2C and interrupt configurations.
 Sensor::Config const Sensor::CONFIG[] = {
     { SENSOR, I2C2, I2C2_EV_IRQn, I2C2_EV_PRIO, I2C2_ER_IRQn, I2C2_ER_PRIO,        // I2C INT
@@ -188,7 +190,6 @@ Sensor::Sensor(XThread &container) :
     m_sensorMag(m_config->magDrdyHsmn, m_hal),
     m_sensorHumidTemp(m_config->humidTempDrdyHsmn, m_hal),
     m_sensorPress(m_config->pressIntHsmn, m_hal), m_inEvt(QEvt::STATIC_EVT) {
-    SET_EVT_NAME(SENSOR);
     m_i2cSem.init(0,1);
 }
 
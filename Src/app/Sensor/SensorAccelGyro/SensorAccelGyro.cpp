@@ -36,6 +36,10 @@
  * Email - admin@galliumstudio.com
  ******************************************************************************/
 
+// Uncomment the following to compile out EVENT, LOG and INFO, including the per-sample LOG in the data path.
+// It must come before any include.
+//#define FW_LOG_LEVEL 3
+
 #include "app_hsmn.h"
 #include "fw_log.h"
 #include "fw_assert.h"
@@ -67,12 +71,12 @@ static char const * const interfaceEvtName[] = {
     SENSOR_ACCEL_GYRO_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(SENSOR_ACCEL_GYRO);
+
 SensorAccelGyro::SensorAccelGyro(Hsmn intHsmn, I2C_HandleTypeDef &hal) :
     Region((QStateHandler)&SensorAccelGyro::InitialPseudoState, SENSOR_ACCEL_GYRO, "SENSOR_ACCEL_GYRO"),
     m_intHsmn(intHsmn), m_pipe(NULL), m_inEvt(QEvt::STATIC_EVT),
-    m_stateTimer(GetHsmn(), STATE_TIMER) {
-    SET_EVT_NAME(SENSOR_ACCEL_GYRO);
-}
+    m_stateTimer(GetHsmn(), STATE_TIMER) {}
 
 QState SensorAccelGyro::InitialPseudoState(SensorAccelGyro * const me, QEvt const * const e) {
     (void)e;
@@ -42,6 +42,7 @@
 #include "fw_def.h"
 #include "fw_evt.h"
 #include "fw_pipe.h"
+#include "fw_spscpipe.h"
 #include "app_hsmn.h"
 
 using namespace QP;
@@ -85,7 +86,7 @@ public:
   int32_t m_gZ;
 };
 
-typedef Pipe<AccelGyroReport> AccelGyroPipe;
+typedef SpscPipe<AccelGyroReport> AccelGyroPipe;
 
 
 class SensorAccelGyroStartReq : public Evt {
@@ -67,12 +67,12 @@ static char const * const interfaceEvtName[] = {
     SENSOR_HUMID_TEMP_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(SENSOR_HUMID_TEMP);
+
 SensorHumidTemp::SensorHumidTemp(Hsmn drdyHsmn, I2C_HandleTypeDef &hal) :
     Region((QStateHandler)&SensorHumidTemp::InitialPseudoState, SENSOR_HUMID_TEMP, "SENSOR_HUMID_TEMP"),
     m_drdyHsmn(drdyHsmn), m_pipe(NULL), m_inEvt(QEvt::STATIC_EVT),
-    m_stateTimer(GetHsmn(), STATE_TIMER), m_pollTimer(GetHsmn(), POLL_TIMER) {
-    SET_EVT_NAME(SENSOR_HUMID_TEMP);
-}
+    m_stateTimer(GetHsmn(), STATE_TIMER), m_pollTimer(GetHsmn(), POLL_TIMER) {}
 
 QState SensorHumidTemp::InitialPseudoState(SensorHumidTemp * const me, QEvt const * const e) {
     (void)e;
@@ -66,11 +66,11 @@ static char const * const interfaceEvtName[] = {
     SENSOR_MAG_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(SENSOR_MAG);
+
 SensorMag::SensorMag(Hsmn drdyHsmn, I2C_HandleTypeDef &hal) :
     Region((QStateHandler)&SensorMag::InitialPseudoState, SENSOR_MAG, "SENSOR_MAG"),
-    m_drdyHsmn(drdyHsmn), m_hal(hal), m_stateTimer(GetHsmn(), STATE_TIMER), m_handle(NULL), m_inEvt(QEvt::STATIC_EVT) {
-    SET_EVT_NAME(SENSOR_MAG);
-}
+    m_drdyHsmn(drdyHsmn), m_hal(hal), m_stateTimer(GetHsmn(), STATE_TIMER), m_handle(NULL), m_inEvt(QEvt::STATIC_EVT) {}
 
 QState SensorMag::InitialPseudoState(SensorMag * const me, QEvt const * const e) {
     (void)e;
@@ -66,11 +66,11 @@ static char const * const interfaceEvtName[] = {
     SENSOR_PRESS_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(SENSOR_PRESS);
+
 SensorPress::SensorPress(Hsmn intHsmn, I2C_HandleTypeDef &hal) :
     Region((QStateHandler)&SensorPress::InitialPseudoState, SENSOR_PRESS, "SENSOR_PRESS"),
-    m_intHsmn(intHsmn), m_hal(hal), m_stateTimer(GetHsmn(), STATE_TIMER), m_handle(NULL), m_inEvt(QEvt::STATIC_EVT) {
-    SET_EVT_NAME(SENSOR_PRESS);
-}
+    m_intHsmn(intHsmn), m_hal(hal), m_stateTimer(GetHsmn(), STATE_TIMER), m_handle(NULL), m_inEvt(QEvt::STATIC_EVT) {}
 
 QState SensorPress::InitialPseudoState(SensorPress * const me, QEvt const * const e) {
     (void)e;
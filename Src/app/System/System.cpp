@@ -36,6 +36,7 @@
  * Email - admin@galliumstudio.com
  ******************************************************************************/
 
+#include "fw.h"
 #include "fw_log.h"
 #include "fw_assert.h"
 #include "app_hsmn.h"
@@ -92,12 +93,43 @@ static char const * const interfaceEvtName[] = {
     SYSTEM_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(SYSTEM);
+
 System::System() :
     Active((QStateHandler)&System::InitialPseudoState, SYSTEM, "SYSTEM"), m_maxIdleCnt(0), m_cpuUtilPercent(0), m_inEvt(QEvt::STATIC_EVT),
     m_stateTimer(GetHsmn(), STATE_TIMER), m_idleCntTimer(GetHsmn(), IDLE_CNT_TIMER),
     m_sensorDelayTimer(GetHsmn(), SENSOR_DELAY_TIMER),
-    m_testTimer(GetHsmn(), TEST_TIMER) {
-    SET_EVT_NAME(SYSTEM);
+    m_testTimer(GetHsmn(), TEST_TIMER), m_telemetryTimer(GetHsmn(), TELEMETRY_TIMER), m_telemElapsed(0) {
+    memset(m_telemCycle, 0, sizeof(m_telemCycle));
+}
+
+// Logs the framework RAM footprint of each HSM (see ActiveT and RegionT) at startup.
+// Members added by application classes and extended thread stacks are not included.
+void System::LogRam() {
+    auto me = this;
+    uint32_t total = 0;
+    for (Hsmn hsmn = HSM_UNDEF + 1; hsmn < MAX_HSM_COUNT; hsmn++) {
+        Hsm *hsm = Fw::GetHsm(hsmn);
+        if (hsm && hsm->GetRamSize()) {
+            LOG("ram %s %d defer=%d reminder=%d seq=%d", hsm->GetName(), hsm->GetRamSize(), hsm->GetDeferQueueCount(),
+                hsm->GetReminderQueueCount(), hsm->GetEvtSeqCount());
+            total += hsm->GetRamSize();
+        }
+    }
+    LOG("ram total %d", total);
+}
+
+// Returns the CPU load of prio in per mille since the last call, given the elapsed cycles since then.
+uint32_t System::SampleCpu(uint8_t prio, uint32_t elapsed) {
+    FW_ASSERT(prio <= QF_MAX_ACTIVE);
+    BspCpuTime time;
+    BspGetCpuTime(prio, time);
+    uint32_t cycle = static_cast<uint32_t>(time.cycle);
+    // Wraps around correctly as long as the interval is less than 2^32 cycles.
+    uint32_t delta = cycle - m_telemCycle[prio];
+    m_telemCycle[prio] = cycle;
+    // Clamped in case BspResetCpuTime() was called in between.
+    return elapsed ? static_cast<uint32_t>(LESS(static_cast<uint64_t>(delta) * 1000 / elapsed, 1000ULL)) : 0;
 }
 
 QState System::InitialPseudoState(System * const me, QEvt const * const e) {
@@ -447,11 +479,13 @@ QState System::Started(System * const me, QEvt const * const e) {
     switch (e->sig) {
         case Q_ENTRY_SIG: {
             EVENT(e);
+            me->LogRam();
             return Q_HANDLED();
         }
         case Q_EXIT_SIG: {
             EVENT(e);
             me->m_idleCntTimer.Stop();
+            me->m_telemetryTimer.Stop();
             return Q_HANDLED();
         }
         case IDLE_CNT_TIMER: {
@@ -474,6 +508,49 @@ QState System::Started(System * const me, QEvt const * const e) {
             }
             return Q_HANDLED();
         }
+        case SYSTEM_TELEMETRY_REQ: {
+            SystemTelemetryReq const &req = static_cast<SystemTelemetryReq const &>(*e);
+            if (req.GetEnable()) {
+                LOG("Telemetry enabled");
+                me->m_telemElapsed = static_cast<uint32_t>(BspGetCpuElapsed());
+                for (uint8_t prio = 0; prio <= QF_MAX_ACTIVE; prio++) {
+                    me->SampleCpu(prio, 0);
+                }
+                me->m_telemetryTimer.Restart(TELEMETRY_POLL_TIMEOUT_MS, Timer::PERIODIC);
+            } else {
+                LOG("Telemetry disabled");
+                me->m_telemetryTimer.Stop();
+            }
+            return Q_HANDLED();
+        }
+        // Reports event queue high-water marks (max used/size) and latencies (cycles) since reset ('sys lat reset').
+        case TELEMETRY_TIMER: {
+            uint32_t now = static_cast<uint32_t>(BspGetCpuElapsed());
+            uint32_t elapsed = now - me->m_telemElapsed;
+            me->m_telemElapsed = now;
+            uint32_t busy = 0;
+            for (uint8_t prio = 1; prio <= QF_MAX_ACTIVE; prio++) {
+                uint32_t cpu = me->SampleCpu(prio, elapsed);
+                busy += cpu;
+                uint32_t size, maxUsed;
+                if (!Fw::GetQueueUsage(prio, size, maxUsed)) {
+                    continue;
+                }
+                Hsm *hsm = Fw::GetActiveHsm(prio);
+#ifdef ENABLE_FW_LATENCY
+                LatencyHist hist;
+                Fw::GetLatency(prio, hist);
+                PRINT("TELEM %s q=%lu/%lu cpu=%lu.%lu%% n=%lu avg=%lu p99<%lu max=%lu\n\r", hsm ? hsm->GetName() : "?",
+                      maxUsed, size, cpu / 10, cpu % 10, hist.GetCount(), hist.GetAvg(), hist.GetPercentile(99),
+                      hist.GetMax());
+#else
+                PRINT("TELEM %s q=%lu/%lu cpu=%lu.%lu%%\n\r", hsm ? hsm->GetName() : "?", maxUsed, size, cpu / 10, cpu % 10);
+#endif
+            }
+            busy = LESS(busy, 1000UL);
+            PRINT("TELEM cpu busy=%lu.%lu%%\n\r", busy / 10, busy % 10);
+            return Q_HANDLED();
+        }
         // Hooks up USER_BTN to Traffic for testing. 
         case GPIO_IN_PULSE_IND: {
             EVENT(e);
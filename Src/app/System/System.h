@@ -69,6 +69,9 @@ protected:
             static QState Stopping2(System * const me, QEvt const * const e);
         static QState Started(System * const me, QEvt const * const e);
 
+    void LogRam();
+    // Returns the CPU load of prio in per mille since the last call, given the elapsed cycles since then.
+    uint32_t SampleCpu(uint8_t prio, uint32_t elapsed);
 
     uint32_t m_maxIdleCnt;
     uint32_t m_cpuUtilPercent;      // CPU utilization in percentage.
@@ -77,10 +80,15 @@ protected:
     Timer m_idleCntTimer;
     Timer m_sensorDelayTimer;
     Timer m_testTimer;
+    Timer m_telemetryTimer;
+    // CPU time per priority and elapsed time (low 32 bits of cycles) at the last telemetry report.
+    uint32_t m_telemCycle[QF_MAX_ACTIVE + 1];
+    uint32_t m_telemElapsed;
 
     enum {
         IDLE_CNT_INIT_TIMEOUT_MS = 200,
         IDLE_CNT_POLL_TIMEOUT_MS = 2000,
+        TELEMETRY_POLL_TIMEOUT_MS = 5000,
         SENSOR_DELAY_TIMEOUT_MS = 200,
     };
 
@@ -89,7 +97,8 @@ protected:
     ADD_EVT(STATE_TIMER) \
     ADD_EVT(IDLE_CNT_TIMER) \
     ADD_EVT(SENSOR_DELAY_TIMER) \
-    ADD_EVT(TEST_TIMER)
+    ADD_EVT(TEST_TIMER) \
+    ADD_EVT(TELEMETRY_TIMER)
 
 #define SYSTEM_INTERNAL_EVT \
     ADD_EVT(DONE) \
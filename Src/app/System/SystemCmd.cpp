@@ -37,7 +37,12 @@
  ******************************************************************************/
 
 #include <string.h>
+#include "fw.h"
+#include "fw_hsm.h"
 #include "fw_log.h"
+#include "fw_prof.h"
+#include "fw_heap.h"
+#include "fw_xthread.h"
 #include "fw_assert.h"
 #include "app_hsmn.h"
 #include "Console.h"
@@ -115,6 +120,329 @@ static CmdStatus Cpu(Console &console, Evt const *e) {
     return CMD_DONE;
 }
 
+// Lists the number of events dispatched to each HSM (active object or region) since reset.
+static CmdStatus Disp(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            bool reset = (ind.Argc() >= 2) && STRING_EQUAL(ind.Argv(1), "reset");
+            if (reset) {
+                Fw::ResetNotInQStat();
+            } else {
+                Fw::NotInQStat stat = Fw::GetNotInQStat();
+                console.Print("PostNotInQ posted=%lu coalesced=%lu scanned=%lu\n\r", stat.posted, stat.coalesced, stat.scanned);
+            }
+            for (Hsmn hsmn = HSM_UNDEF + 1; hsmn < MAX_HSM_COUNT; hsmn++) {
+                Hsm *hsm = Fw::GetHsm(hsmn);
+                if (hsm) {
+                    if (reset) {
+                        hsm->ResetDispatchCount();
+                    } else {
+                        console.Print("%2d %-24s %10lu\n\r", hsmn, hsm->GetName(), hsm->GetDispatchCount());
+                    }
+                }
+            }
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Lists the framework RAM footprint of each HSM and the capacities of its queues (see ActiveT and RegionT).
+// Members added by application classes and extended thread stacks are not included.
+static CmdStatus Ram(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            uint32_t total = 0;
+            console.Print("%2s %-24s %6s %5s %8s %4s\n\r", "", "hsm", "ram", "defer", "reminder", "seq");
+            for (Hsmn hsmn = HSM_UNDEF + 1; hsmn < MAX_HSM_COUNT; hsmn++) {
+                Hsm *hsm = Fw::GetHsm(hsmn);
+                if (hsm && hsm->GetRamSize()) {
+                    console.Print("%2d %-24s %6lu %5u %8u %4lu\n\r", hsmn, hsm->GetName(), hsm->GetRamSize(),
+                                  hsm->GetDeferQueueCount(), hsm->GetReminderQueueCount(), hsm->GetEvtSeqCount());
+                    total += hsm->GetRamSize();
+                }
+            }
+            console.Print("total=%lu\n\r", total);
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Lists the event queue high-water mark of each active object, and its post-to-dispatch latency histogram
+// (in cycles) if ENABLE_FW_LATENCY is defined in fw_latency.h. Bin n counts latencies below 2^(n+1).
+static CmdStatus Latency(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            if ((ind.Argc() >= 2) && STRING_EQUAL(ind.Argv(1), "reset")) {
+                Fw::ResetQueueUsage();
+#ifdef ENABLE_FW_LATENCY
+                Fw::ResetLatency();
+#endif
+                break;
+            }
+            for (uint8_t prio = 1; prio <= QF_MAX_ACTIVE; prio++) {
+                uint32_t size, maxUsed;
+                if (!Fw::GetQueueUsage(prio, size, maxUsed)) {
+                    continue;
+                }
+                Hsm *hsm = Fw::GetActiveHsm(prio);
+                console.Print("%2d %-20s queue=%lu/%lu\n\r", prio, hsm ? hsm->GetName() : "?", maxUsed, size);
+#ifdef ENABLE_FW_LATENCY
+                LatencyHist hist;
+                Fw::GetLatency(prio, hist);
+                console.Print("   count=%lu avg=%lu max=%lu\n\r", hist.GetCount(), hist.GetAvg(), hist.GetMax());
+                for (uint32_t i = 0; i < LatencyHist::BIN_COUNT; i++) {
+                    if (hist.GetBin(i)) {
+                        console.Print("   <2^%-2lu %10lu\n\r", i + 1, hist.GetBin(i));
+                    }
+                }
+#endif
+            }
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+static CmdStatus Telemetry(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            if (ind.Argc() < 2) {
+                console.Print("on - enable, off - disable\n\r");
+                break;
+            }
+            bool enable = STRING_EQUAL(ind.Argv(1), "on");
+            console.Send(new SystemTelemetryReq(enable), SYSTEM);
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Lists dispatch cycles per (HSM, signal) recorded by the profiler since reset. See ENABLE_FW_PROF in fw_prof.h.
+static CmdStatus Profile(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+#ifdef ENABLE_FW_PROF
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            if ((ind.Argc() >= 2) && STRING_EQUAL(ind.Argv(1), "reset")) {
+                Prof::Reset();
+                break;
+            }
+            console.Print("used=%lu/%lu dropped=%lu (cycles)\n\r", Prof::GetUsedCount(), Prof::GetTotalCount(),
+                          Prof::GetDropCount());
+            console.Print("%-20s %-28s %8s %8s %8s %8s\n\r", "hsm", "event", "count", "avg", "min", "max");
+            for (uint32_t i = 0; i < Prof::GetTotalCount(); i++) {
+                Hsmn hsmn;
+                QSignal sig;
+                Prof::Stat stat;
+                if (Prof::Get(i, hsmn, sig, stat)) {
+                    console.Print("%-20s %-28s %8lu %8lu %8lu %8lu\n\r", Log::GetHsmName(hsmn), Log::GetEvtName(sig),
+                                  stat.m_count, stat.GetAvg(), stat.m_min, stat.m_max);
+                }
+            }
+#else
+            console.PutStr("Profiler disabled. Define ENABLE_FW_PROF in fw_prof.h.\n\r");
+#endif
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Lists event pool usage, and event sizes per signal when ENABLE_FW_POOL_STAT is defined in fw_poolstat.h.
+// Each signal line is followed by its size histogram as "low-high:count" per non-empty bin.
+// The output can be captured and passed to PoolSize.py for recommended pool sizes.
+static CmdStatus Pool(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            if ((ind.Argc() >= 2) && STRING_EQUAL(ind.Argv(1), "reset")) {
+                Fw::ResetPoolUsage();
+                Payload::ResetUsage();
+#ifdef ENABLE_FW_POOL_STAT
+                PoolStat::Reset();
+#endif
+                break;
+            }
+            console.Print("%-4s %2s %6s %6s %8s %8s %10s %6s\n\r", "", "id", "size", "count", "min free", "max used", "alloc", "fail");
+            for (uint8_t id = 1; id <= Fw::GetPoolCount(); id++) {
+                Fw::PoolUsage usage;
+                Fw::GetPoolUsage(id, usage);
+                console.Print("pool %2u %6lu %6lu %8lu %8lu %10lu %6lu\n\r", id, usage.blockSize, usage.blockCount, usage.minFree,
+                              usage.blockCount - usage.minFree, usage.allocCount, usage.failCount);
+            }
+            Payload::Usage payload;
+            Payload::GetUsage(payload);
+            console.Print("payload %6u %6lu %8lu %8lu %10lu %6lu\n\r", Payload::BUF_SIZE, Payload::GetBufCount(), payload.minFree,
+                          Payload::GetBufCount() - payload.minFree, payload.allocCount, payload.failCount);
+#ifdef ENABLE_FW_POOL_STAT
+            console.Print("used=%lu/%lu dropped=%lu\n\r", PoolStat::GetUsedCount(), PoolStat::GetTotalCount(), PoolStat::GetDropCount());
+            console.Print("%-3s %-28s %6s %6s %10s\n\r", "", "event", "min", "max", "count");
+            for (uint32_t i = 0; i < PoolStat::GetTotalCount(); i++) {
+                QSignal sig;
+                PoolStat::Stat stat;
+                if (PoolStat::Get(i, sig, stat)) {
+                    console.Print("sig %-28s %6u %6u %10lu\n\r", Log::GetEvtName(sig), stat.m_minSize, stat.m_maxSize, stat.m_count);
+                    console.Print("%-3s", "");
+                    for (uint32_t b = 0; b < PoolStat::Stat::BIN_COUNT; b++) {
+                        if (stat.GetBin(b)) {
+                            console.Print(" %lu-%lu:%lu", PoolStat::Stat::GetBinLow(b), PoolStat::Stat::GetBinHigh(b), stat.GetBin(b));
+                        }
+                    }
+                    console.Print("\n\r");
+                }
+            }
+#endif
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Lists the usage of each heap arena (see fw_heap.h). The system arena is only present when malloc() is routed to it
+// (ENABLE_FW_HEAP_MALLOC) and has been used.
+static CmdStatus HeapUsage(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            bool reset = (ind.Argc() >= 2) && STRING_EQUAL(ind.Argv(1), "reset");
+            if (!reset) {
+                console.Print("%-8s %7s %7s %7s %7s %6s %5s %10s %6s\n\r", "heap", "size", "used", "peak", "largest", "blocks",
+                              "frag", "alloc", "fail");
+            }
+            for (Heap *heap = Heap::GetFirst(); heap; heap = heap->GetNext()) {
+                if (reset) {
+                    heap->ResetStat();
+                    continue;
+                }
+                Heap::Stat stat;
+                heap->GetStat(stat);
+                console.Print("%-8s %7lu %7lu %7lu %7lu %6lu %4lu%% %10lu %6lu\n\r", heap->GetName(), stat.size, stat.usedSize,
+                              stat.peakUsed, stat.largestFree, stat.freeBlockCount, stat.GetFragPercent(), stat.allocCount,
+                              stat.failCount);
+            }
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Lists the stack high-water mark of the main stack, which active objects and ISRs run on, and of each extended
+// thread (see BSP_STACK_PAINT in bsp.h).
+static CmdStatus Stack(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            uint32_t size, maxUsed;
+            BspGetMainStackUsage(size, maxUsed);
+            console.Print("%2s %-20s %8s %8s %8s\n\r", "pr", "name", "used", "size", "free");
+            console.Print("%2s %-20s %8lu %8lu %8lu\n\r", "", "main", maxUsed, size, size - maxUsed);
+            for (uint8_t prio = 1; prio <= QF_MAX_ACTIVE; prio++) {
+                XThread const *thread = XThread::Get(prio);
+                if (!thread) {
+                    continue;
+                }
+                thread->GetStackUsage(size, maxUsed);
+                Hsm *hsm = Fw::GetActiveHsm(prio);
+                console.Print("%2d %-20s %8lu %8lu %8lu\n\r", prio, hsm ? hsm->GetName() : "?", maxUsed, size,
+                              size - maxUsed);
+            }
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Lists CPU time of each active object and extended thread since reset (see BspCpuTime in bsp.h). Idle is the
+// elapsed time not used by any of them, so it includes ISRs that preempt the idle loop.
+static CmdStatus Top(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            if ((ind.Argc() >= 2) && STRING_EQUAL(ind.Argv(1), "reset")) {
+                BspResetCpuTime();
+                break;
+            }
+            uint64_t elapsed = BspGetCpuElapsed();
+            uint32_t cyclePerMs = SystemCoreClock / 1000;
+            uint64_t busy = 0;
+            console.Print("%2s %-20s %6s %10s %8s\n\r", "pr", "name", "cpu", "ms", "switches");
+            for (uint8_t prio = QF_MAX_ACTIVE; prio > 0; prio--) {
+                uint32_t size, maxUsed;
+                if (!Fw::GetQueueUsage(prio, size, maxUsed)) {
+                    continue;
+                }
+                BspCpuTime time;
+                BspGetCpuTime(prio, time);
+                busy += time.cycle;
+                uint32_t permille = elapsed ? static_cast<uint32_t>(time.cycle * 1000 / elapsed) : 0;
+                Hsm *hsm = Fw::GetActiveHsm(prio);
+                console.Print("%2d %-20s %3lu.%lu%% %10lu %8lu\n\r", prio, hsm ? hsm->GetName() : "?", permille / 10,
+                              permille % 10, static_cast<uint32_t>(time.cycle / cyclePerMs), time.switchCount);
+            }
+            uint64_t idle = (elapsed > busy) ? (elapsed - busy) : 0;
+            uint32_t permille = elapsed ? static_cast<uint32_t>(idle * 1000 / elapsed) : 0;
+            console.Print("%2d %-20s %3lu.%lu%% %10lu\n\r", 0, "idle", permille / 10, permille % 10,
+                          static_cast<uint32_t>(idle / cyclePerMs));
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Reports the jitter of TICK_RATE_FAST (see BspFastTickStat in bsp.h).
+static CmdStatus Tick(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            if ((ind.Argc() >= 2) && STRING_EQUAL(ind.Argv(1), "reset")) {
+                BspResetFastTickStat();
+                break;
+            }
+            BspFastTickStat stat;
+            BspGetFastTickStat(stat);
+            console.Print("period %lu ns, %lu ticks, %lu starts\n\r", stat.periodNs, stat.tickCount, stat.startCount);
+            console.Print("interval error min=%ld max=%ld avg=%lu ns over %lu\n\r", stat.minErrNs, stat.maxErrNs,
+                          stat.avgErrNs, stat.intervalCount);
+            console.Print("max isr %lu ns\n\r", stat.maxIsrNs);
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
+// Lists low-power idle residency and wakeups per reason (see ENABLE_BSP_TICKLESS in bsp.h).
+static CmdStatus Idle(Console &console, Evt const *e) {
+    switch (e->sig) {
+        case Console::CONSOLE_CMD: {
+#ifdef ENABLE_BSP_TICKLESS
+            Console::ConsoleCmd const &ind = static_cast<Console::ConsoleCmd const &>(*e);
+            if ((ind.Argc() >= 2) && STRING_EQUAL(ind.Argv(1), "reset")) {
+                BspResetIdleStat();
+                break;
+            }
+            BspIdleStat stat;
+            BspGetIdleStat(stat);
+            console.Print("stop  %10lu ms %8lu times\n\r", stat.stopMs, stat.stopCount);
+            console.Print("sleep %10lu ms %8lu times\n\r", stat.sleepMs, stat.sleepCount);
+            console.Print("short %10s    %8lu times\n\r", "", stat.shortCount);
+            console.Print("%-6s %8s %10s\n\r", "wakeup", "count", "awake ms");
+            for (uint8_t i = 0; i < BSP_WAKE_COUNT; i++) {
+                console.Print("%-6s %8lu %10lu\n\r", BspGetWakeName(i), stat.wakeCount[i], stat.awakeMs[i]);
+            }
+#else
+            console.PutStr("Tickless idle currently disabled.\n\r");
+#endif
+            break;
+        }
+    }
+    return CMD_DONE;
+}
+
 static CmdStatus Tensor(Console &console, Evt const *e) {
 #ifdef ENABLE_TENSOR
     switch (e->sig) {
@@ -154,6 +482,17 @@ static CmdHandler const cmdHandler[] = {
     { "stop",       Stop,       "Stop HSM", 0 },
     { "start",      Start,      "Start HSM", 0 },
     { "cpu",        Cpu,        "Report CPU util", 0 },
+    { "disp",       Disp,       "Dispatch and PostNotInQ counts (reset)", 0 },
+    { "lat",        Latency,    "Queue high-water and latency (reset)", 0 },
+    { "telem",      Telemetry,  "Periodic queue/latency/CPU report (on/off)", 0 },
+    { "prof",       Profile,    "Dispatch cycle profile (reset)", 0 },
+    { "pool",       Pool,       "Event pool usage (reset)", 0 },
+    { "ram",        Ram,        "Framework RAM per HSM", 0 },
+    { "heap",       HeapUsage,  "Heap arena usage (reset)", 0 },
+    { "stack",      Stack,      "Stack high-water per thread", 0 },
+    { "top",        Top,        "CPU time per active object and thread (reset)", 0 },
+    { "tick",       Tick,       "Fast tick jitter (reset)", 0 },
+    { "idle",       Idle,       "Low-power idle residency and wakeups (reset)", 0 },
     { "tensor",     Tensor,     "Tensorflow Lite demo", 0},
 };
 
@@ -53,7 +53,8 @@ namespace APP {
     ADD_EVT(SYSTEM_STOP_REQ) \
     ADD_EVT(SYSTEM_STOP_CFM) \
     ADD_EVT(SYSTEM_RESTART_REQ) \
-    ADD_EVT(SYSTEM_CPU_UTIL_REQ)
+    ADD_EVT(SYSTEM_CPU_UTIL_REQ) \
+    ADD_EVT(SYSTEM_TELEMETRY_REQ)
 
 #undef ADD_EVT
 #define ADD_EVT(e_) e_,
@@ -110,6 +111,16 @@ private:
     bool m_enable;
 };
 
+// Enables or disables the periodic report of event queue high-water marks and latencies.
+class SystemTelemetryReq : public Evt {
+public:
+    SystemTelemetryReq(bool enable) :
+        Evt(SYSTEM_TELEMETRY_REQ), m_enable(enable) {}
+    bool GetEnable() const { return m_enable; }
+private:
+    bool m_enable;
+};
+
 class SystemRestartReq : public Evt {
 public:
     enum {
@@ -65,11 +65,11 @@ static char const * const interfaceEvtName[] = {
     COMPOSITE_ACT_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(COMPOSITE_ACT);
+
 CompositeAct::CompositeAct() :
     Active((QStateHandler)&CompositeAct::InitialPseudoState, COMPOSITE_ACT, "COMPOSITE_ACT"), m_inEvt(QEvt::STATIC_EVT),
-    m_stateTimer(GetHsmn(), STATE_TIMER) {
-    SET_EVT_NAME(COMPOSITE_ACT);
-}
+    m_stateTimer(GetHsmn(), STATE_TIMER) {}
 
 QState CompositeAct::InitialPseudoState(CompositeAct * const me, QEvt const * const e) {
     (void)e;
@@ -64,6 +64,8 @@ static char const * const interfaceEvtName[] = {
     COMPOSITE_REG_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(COMPOSITE_REG);
+
 static char const * const hsmName[] = {
     "COMPOSITE_REG0",
     "COMPOSITE_REG1",
@@ -98,7 +100,6 @@ static uint16_t GetInst(Hsmn hsmn) {
 CompositeReg::CompositeReg() :
     Region((QStateHandler)&CompositeReg::InitialPseudoState, GetCurrHsmn(), GetCurrName()),
     m_stateTimer(GetHsmn(), STATE_TIMER) {
-    SET_EVT_NAME(COMPOSITE_REG);
     IncCurrHsmn();
 }
 
@@ -64,11 +64,11 @@ static char const * const interfaceEvtName[] = {
     SIMPLE_ACT_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(SIMPLE_ACT);
+
 SimpleAct::SimpleAct() :
     Active((QStateHandler)&SimpleAct::InitialPseudoState, SIMPLE_ACT, "SIMPLE_ACT"), m_inEvt(QEvt::STATIC_EVT),
-    m_stateTimer(GetHsmn(), STATE_TIMER) {
-    SET_EVT_NAME(SIMPLE_ACT);
-}
+    m_stateTimer(GetHsmn(), STATE_TIMER) {}
 
 QState SimpleAct::InitialPseudoState(SimpleAct * const me, QEvt const * const e) {
     (void)e;
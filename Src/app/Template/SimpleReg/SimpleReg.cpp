@@ -64,11 +64,11 @@ static char const * const interfaceEvtName[] = {
     SIMPLE_REG_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(SIMPLE_REG);
+
 SimpleReg::SimpleReg() :
     Region((QStateHandler)&SimpleReg::InitialPseudoState, SIMPLE_REG, "SIMPLE_REG"),
-    m_stateTimer(GetHsmn(), STATE_TIMER) {
-    SET_EVT_NAME(SIMPLE_REG);
-}
+    m_stateTimer(GetHsmn(), STATE_TIMER) {}
 
 QState SimpleReg::InitialPseudoState(SimpleReg * const me, QEvt const * const e) {
     (void)e;
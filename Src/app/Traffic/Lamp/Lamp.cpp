@@ -65,6 +65,8 @@ static char const * const interfaceEvtName[] = {
     LAMP_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(LAMP);
+
 // Helper functions.
 void Lamp::Draw(Hsmn hsmn, bool redOn, bool yellowOn, bool greenOn) {
     char const *buf;
@@ -87,9 +89,7 @@ void Lamp::Draw(Hsmn hsmn, bool redOn, bool yellowOn, bool greenOn) {
 }
 
 Lamp::Lamp(Hsmn hsmn, char const *name) :
-    Region((QStateHandler)&Lamp::InitialPseudoState, hsmn, name) {
-    SET_EVT_NAME(LAMP);
-}
+    Region((QStateHandler)&Lamp::InitialPseudoState, hsmn, name) {}
 
 QState Lamp::InitialPseudoState(Lamp * const me, QEvt const * const e) {
     (void)e;
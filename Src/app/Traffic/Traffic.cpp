@@ -66,13 +66,13 @@ static char const * const interfaceEvtName[] = {
     TRAFFIC_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(TRAFFIC);
+
 Traffic::Traffic() :
     Active((QStateHandler)&Traffic::InitialPseudoState, TRAFFIC, "TRAFFIC"),
     m_lampNS(LAMP_NS, "LAMP_NS"), m_lampEW(LAMP_EW, "LAMP_EW"),
     m_carWaiting(false), m_waitTimer(GetHsmn(), WAIT_TIMER),
-    m_idleTimer(GetHsmn(), IDLE_TIMER), m_blinkTimer(GetHsmn(), BLINK_TIMER){
-    SET_EVT_NAME(TRAFFIC);
-}
+    m_idleTimer(GetHsmn(), IDLE_TIMER), m_blinkTimer(GetHsmn(), BLINK_TIMER){}
 
 QState Traffic::InitialPseudoState(Traffic * const me, QEvt const * const e) {
     (void)e;
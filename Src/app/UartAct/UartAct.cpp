@@ -103,6 +103,8 @@ static char const * const interfaceEvtName[] = {
     "UART_ACT_FAIL_IND",
 };
 
+DEFINE_EVT_NAME(UART_ACT);
+
 extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef *hal) {
     Hsmn hsmn = UartAct::GetHsmn(hal);
     UartOut::DmaCompleteCallback(UART_OUT + UartAct::GetInst(hsmn));
@@ -134,6 +136,19 @@ void UartAct::InitUart() {
         // Add more cases here...
         default: FW_ASSERT(0); break;
     }
+#ifdef ENABLE_BSP_TICKLESS
+    // A USART can only wake up the CPU from STOP1 when clocked by HSI16 (see UartIn::Normal). The baud rate is
+    // derived from it by HAL_UART_Init().
+    __HAL_RCC_HSI_ENABLE();
+    while (!__HAL_RCC_GET_FLAG(RCC_FLAG_HSIRDY)) {
+    }
+    switch((uint32_t)(m_config->uart)) {
+        case USART2_BASE: __HAL_RCC_USART2_CONFIG(RCC_USART2CLKSOURCE_HSI); break;
+        case USART1_BASE: __HAL_RCC_USART1_CONFIG(RCC_USART1CLKSOURCE_HSI); break;
+        // Add more cases here...
+        default: FW_ASSERT(0); break;
+    }
+#endif
 
     // Configure peripheral GPIO
     // UART TX GPIO pin configuration.
@@ -211,7 +226,6 @@ UartAct::UartAct(Hsmn hsmn, char const *name, char const *inName, char const *ou
     m_uartOut(m_uartOutHsmn, outName, m_hal),
     m_client(HSM_UNDEF), m_outFifo(NULL), m_inFifo(NULL), m_inEvt(QEvt::STATIC_EVT),
     m_stateTimer(hsmn, STATE_TIMER) {
-    SET_EVT_NAME(UART_ACT);
     FW_ASSERT((hsmn >= UART_ACT) && (hsmn <= UART_ACT_LAST));
     memset(&m_hal, 0, sizeof(m_hal));
     memset(&m_txDmaHandle, 0, sizeof(m_txDmaHandle));
@@ -66,6 +66,8 @@ static char const * const interfaceEvtName[] = {
     "UART_IN_FAIL_IND",
 };
 
+DEFINE_EVT_NAME(UART_IN);
+
 static uint16_t GetInst(Hsmn hsmn) {
     uint16_t inst = hsmn - UART_IN;
     FW_ASSERT(inst < UART_IN_COUNT);
@@ -110,6 +112,27 @@ void UartIn::DisableRxInt() {
     QF_CRIT_EXIT(crit);
 }
 
+#ifdef ENABLE_BSP_TICKLESS
+// Circular DMA reception keeps running while idle, but DMA stops in STOP modes. USARTs cannot wake up the CPU from
+// STOP2, so tickless idle is limited to STOP1, from which the USART wakes up the CPU on each received byte (WUF).
+// The byte is held in RDR until DMA resumes, which is well within a character time. See HandleUartIrq().
+void UartIn::EnableStopWakeup() {
+    UART_WakeUpTypeDef wakeup = {};
+    wakeup.WakeUpEvent = UART_WAKEUP_ON_READDATA_NONEMPTY;
+    HAL_StatusTypeDef result = HAL_UARTEx_StopModeWakeUpSourceConfig(&m_hal, wakeup);
+    FW_ASSERT(result == HAL_OK);
+    HAL_UARTEx_EnableStopMode(&m_hal);
+    __HAL_UART_ENABLE_IT(&m_hal, UART_IT_WUF);
+    BspStop2Lock();
+}
+
+void UartIn::DisableStopWakeup() {
+    BspStop2Unlock();
+    __HAL_UART_DISABLE_IT(&m_hal, UART_IT_WUF);
+    HAL_UARTEx_DisableStopMode(&m_hal);
+}
+#endif
+
 void UartIn::CleanInvalidateCache(uint32_t addr, uint32_t len) {
     // Cache not available on this platform.
     //SCB_CleanInvalidateDCache_by_Addr(reinterpret_cast<uint32_t *>(ROUND_DOWN_32(addr)), ROUND_UP_32(addr + len) - ROUND_DOWN_32(addr));
@@ -119,9 +142,7 @@ void UartIn::CleanInvalidateCache(uint32_t addr, uint32_t len) {
 
 UartIn::UartIn(Hsmn hsmn, char const *name, UART_HandleTypeDef &hal) :
     Region((QStateHandler)&UartIn::InitialPseudoState, hsmn, name),
-    m_hal(hal), m_manager(HSM_UNDEF), m_client(HSM_UNDEF), m_fifo(NULL), m_dataRecv(false), m_activeTimer(hsmn, ACTIVE_TIMER) {
-    SET_EVT_NAME(UART_IN);
-}
+    m_hal(hal), m_manager(HSM_UNDEF), m_client(HSM_UNDEF), m_fifo(NULL), m_dataRecv(false), m_activeTimer(hsmn, ACTIVE_TIMER) {}
 
 QState UartIn::InitialPseudoState(UartIn * const me, QEvt const * const e) {
     (void)e;
@@ -262,11 +283,17 @@ QState UartIn::Normal(UartIn * const me, QEvt const * const e) {
             HAL_StatusTypeDef result;
             result = HAL_UART_Receive_DMA(&me->m_hal, (uint8_t *)me->m_fifo->GetAddr(0), me->m_fifo->GetBufSize());
             FW_ASSERT(result == HAL_OK);
+#ifdef ENABLE_BSP_TICKLESS
+            me->EnableStopWakeup();
+#endif
             status = Q_HANDLED();
             break;
         }
         case Q_EXIT_SIG: {
             EVENT(e);
+#ifdef ENABLE_BSP_TICKLESS
+            me->DisableStopWakeup();
+#endif
             HAL_UART_DMAStop(&me->m_hal);
             me->DisableRxInt();
             status = Q_HANDLED();
@@ -286,7 +313,7 @@ QState UartIn::Normal(UartIn * const me, QEvt const * const e) {
                     me->Raise(new Evt(FIFO_OVERFLOW));
                 } else {
                     me->m_fifo->CacheOp(UartIn::CleanInvalidateCache, dmaRxCount);
-                    me->m_fifo->IncWriteIndex(dmaRxCount);
+                    me->m_fifo->Commit(dmaRxCount);
                     me->Send(new UartInDataInd(), me->m_client);
                 }
             }
@@ -45,6 +45,7 @@
 #include "fw_timer.h"
 #include "fw_evt.h"
 #include "fw_pipe.h"
+#include "fw_spscpipe.h"
 #include "app_hsmn.h"
 
 using namespace QP;
@@ -78,12 +79,16 @@ protected:
 
     void EnableRxInt();
     void DisableRxInt();
+#ifdef ENABLE_BSP_TICKLESS
+    void EnableStopWakeup();
+    void DisableStopWakeup();
+#endif
     static void CleanInvalidateCache(uint32_t addr, uint32_t len);
 
     UART_HandleTypeDef &m_hal;
     Hsmn m_manager;
     Hsmn m_client;
-    Fifo *m_fifo;
+    SpscFifo *m_fifo;
     bool m_dataRecv;
     Timer m_activeTimer;
 
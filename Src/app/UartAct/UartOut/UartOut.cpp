@@ -69,6 +69,8 @@ static char const * const interfaceEvtName[] = {
     "UART_OUT_EMPTY_IND",
 };
 
+DEFINE_EVT_NAME(UART_OUT);
+
 static uint16_t GetInst(Hsmn hsmn) {
     uint16_t inst = hsmn - UART_OUT;
     FW_ASSERT(inst < UART_OUT_COUNT);
@@ -91,9 +93,7 @@ void UartOut::CleanCache(uint32_t addr, uint32_t len) {
 UartOut::UartOut(Hsmn hsmn, char const *name, UART_HandleTypeDef &hal) :
     Region((QStateHandler)&UartOut::InitialPseudoState, hsmn, name),
     m_hal(hal), m_manager(HSM_UNDEF), m_client(HSM_UNDEF), m_fifo(NULL), m_writeCount(0),
-    m_activeTimer(GetHsmn(), ACTIVE_TIMER) {
-    SET_EVT_NAME(UART_OUT);
-}
+    m_activeTimer(GetHsmn(), ACTIVE_TIMER) {}
 
 QState UartOut::InitialPseudoState(UartOut * const me, QEvt const * const e) {
     (void)e;
@@ -285,17 +285,14 @@ QState UartOut::Normal(UartOut * const me, QEvt const * const e) {
     switch (e->sig) {
         case Q_ENTRY_SIG: {
             EVENT(e);
-            // Zero-copy.
-            Fifo &fifo = *(me->m_fifo);
-            uint32_t addr = fifo.GetReadAddr();
-            uint32_t len = fifo.GetUsedCount();
-            if ((addr + len) > fifo.GetEndAddr()) {
-                len = fifo.GetEndAddr() - addr;
-            }
-            FW_ASSERT((len > 0) && (len <= fifo.GetUsedCount()));
+            // Zero-copy. Only the first block is transmitted. The wrapped-around block is transmitted upon CONTINUE.
+            PipeSpan<uint8_t> span;
+            me->m_fifo->Peek(span, me->m_fifo->GetBufSize());
+            uint32_t len = span.GetCount(0);
+            FW_ASSERT(len > 0);
             // Must enable the following call when write-back policy is used. See MPU_Config() in main.cpp.
             me->m_fifo->CacheOp(UartOut::CleanCache, len);
-            HAL_UART_Transmit_DMA(&me->m_hal, (uint8_t*)addr, len);
+            HAL_UART_Transmit_DMA(&me->m_hal, span.GetPtr(0), len);
             me->m_writeCount = len;
             status = Q_HANDLED();
             break;
@@ -314,7 +311,7 @@ QState UartOut::Normal(UartOut * const me, QEvt const * const e) {
         }
         case DMA_DONE: {
             //EVENT(e);
-            me->m_fifo->IncReadIndex(me->m_writeCount);
+            me->m_fifo->Consume(me->m_writeCount);
             if (me->m_fifo->GetUsedCount()) {
                 me->Raise(new Evt(CONTINUE));
             } else {
@@ -360,7 +357,7 @@ QState UartOut::StopWait(UartOut * const me, QEvt const * const e) {
         }
         case DMA_DONE: {
             EVENT(e);
-            me->m_fifo->IncReadIndex(me->m_writeCount);
+            me->m_fifo->Consume(me->m_writeCount);
             me->Raise(new Evt(DONE));
             status = Q_HANDLED();
             break;
@@ -69,6 +69,8 @@ static char const * const interfaceEvtName[] = {
     WIFI_INTERFACE_EVT
 };
 
+DEFINE_EVT_NAME(WIFI);
+
 // Define SPI and interrupt configurations.
 Wifi::Config const Wifi::CONFIG[] = {
     {
@@ -263,10 +265,9 @@ Wifi::Wifi(XThread &container) :
     m_client(HSM_UNDEF), m_stateTimer(GetHsmn(), STATE_TIMER),
     m_retryTimer(GetHsmn(), RETRY_TIMER), m_dataPollTimer(GetHsmn(), DATA_POLL_TIMER),
     m_container(container), m_port(0),
-    m_dataOutFifo(nullptr), m_dataInFifo(nullptr), m_retryCnt(0), m_inEvt(QEvt::STATIC_EVT) {
+    m_dataOutFifo(nullptr), m_dataInFifo(nullptr), m_dataInFull(false), m_retryCnt(0), m_inEvt(QEvt::STATIC_EVT) {
     FW_ASSERT(CONFIG[0].hsmn == GetHsmn());
     m_config = &CONFIG[0];
-    SET_EVT_NAME(WIFI);
     m_spiSem.init(0,1);
     m_cmdDataRdySem.init(0,1);
     memset(&m_hal, 0, sizeof(m_hal));
@@ -809,32 +810,36 @@ QState Wifi::Connected(Wifi * const me, QEvt const * const e) {
     switch (e->sig) {
         case Q_ENTRY_SIG: {
             EVENT(e);
+            // Polling is paused when m_dataInFifo becomes full and is resumed when the client has drained it to half.
+            me->m_dataInFifo->SetLowWatermark(me->m_dataInFifo->GetBufSize() / 2, me->GetHsmn(), DATA_IN_DRAINED);
+            me->m_dataInFull = false;
             me->m_dataPollTimer.Start(DATA_POLL_TIMEOUT_MS);
             return Q_HANDLED();
         }
         case Q_EXIT_SIG: {
             EVENT(e);
             me->m_dataPollTimer.Stop();
+            me->m_dataInFifo->ClearWatermarks();
             return Q_HANDLED();
         }
         case WIFI_WRITE_REQ: {
             EVENT(e);
             FW_ASSERT(me->m_dataOutFifo);
             bool failed = false;
-            while(me->m_dataOutFifo->GetUsedCount()) {
+            PipeSpan<uint8_t> span;
+            while(me->m_dataOutFifo->Peek(span, MAX_SEND_LEN)) {
                 uint16_t sentLen = 0;
-                uint32_t writeLen = me->m_dataOutFifo->GetUsedBlockCount();
-                writeLen = MIN(static_cast<uint32_t>(MAX_SEND_LEN), writeLen);
+                // Only sends the first block. The wrapped-around block is sent in the next iteration.
+                uint32_t writeLen = span.GetCount(0);
                 LOG("Calling ES_WIFI_SendData writeLen=%d", writeLen);
-                ES_WIFI_Status_t status = ES_WIFI_SendData(&me->m_esWifiObj, SOCKET_NUM,
-                                                           reinterpret_cast<uint8_t *>(me->m_dataOutFifo->GetReadAddr()),
+                ES_WIFI_Status_t status = ES_WIFI_SendData(&me->m_esWifiObj, SOCKET_NUM, span.GetPtr(0),
                                                            writeLen, &sentLen, 0);
                 LOG("ES_WIFI_SendData return sentLen=%d", sentLen);
                 if ((status != ES_WIFI_STATUS_OK) || (writeLen != sentLen)) {
                     failed = true;
                     break;
                 }
-                me->m_dataOutFifo->IncReadIndex(writeLen);
+                me->m_dataOutFifo->Consume(writeLen);
             }
             if (failed) {
                 me->Raise(new Evt(DISCONNECTED));
@@ -846,30 +851,44 @@ QState Wifi::Connected(Wifi * const me, QEvt const * const e) {
         case DATA_POLL_TIMER: {
             bool failed = false;
             uint32_t totalLen = 0;
-            uint32_t readLen;
-            uint16_t recvLen;
+            uint32_t reserveLen;
+            uint32_t commitLen;
+            // Receives directly into the fifo until it is full or no more data is received.
+            // ES_WIFI_ReceiveData() rejects requests longer than ES_WIFI_PAYLOAD_SIZE.
             do {
-                readLen = me->m_dataInFifo->GetAvailBlockCount();
-                if (readLen) {
+                PipeSpan<uint8_t> span;
+                reserveLen = me->m_dataInFifo->Reserve(span, MAX_RECV_LEN);
+                commitLen = 0;
+                for (uint32_t i = 0; i < span.GetBlockCount(); i++) {
+                    uint16_t recvLen = 0;
+                    uint32_t readLen = span.GetCount(i);
                     //LOG("Calling ES_WIFI_ReceiveData readLen=%d", readLen);
-                    ES_WIFI_Status_t status = ES_WIFI_ReceiveData(&me->m_esWifiObj, SOCKET_NUM,
-                                                                  reinterpret_cast<uint8_t *>(me->m_dataInFifo->GetWriteAddr()),
+                    ES_WIFI_Status_t status = ES_WIFI_ReceiveData(&me->m_esWifiObj, SOCKET_NUM, span.GetPtr(i),
                                                                   readLen, &recvLen, 0);
                     //LOG("ES_WIFI_ReceiveData return recvLen=%d", recvLen);
                     if (status != ES_WIFI_STATUS_OK) {
                         failed = true;
                         break;
                     }
-                    me->m_dataInFifo->IncWriteIndex(recvLen);
-                    totalLen += recvLen;
+                    commitLen += recvLen;
+                    if (recvLen != readLen) {
+                        break;
+                    }
                 }
-            } while(readLen && (recvLen == readLen));
+                me->m_dataInFifo->Commit(commitLen);
+                totalLen += commitLen;
+            } while(!failed && reserveLen && (commitLen == reserveLen));
             if (failed) {
                 me->Raise(new Evt(DISCONNECTED));
             } else if (totalLen) {
                 me->Send(new WifiDataInd(), me->m_client);
             }
-            me->m_dataPollTimer.Start(DATA_POLL_TIMEOUT_MS);
+            if (me->m_dataInFifo->GetAvailCount()) {
+                me->m_dataPollTimer.Start(DATA_POLL_TIMEOUT_MS);
+            } else {
+                LOG("Data in fifo full. Polling paused");
+                me->m_dataInFull = true;
+            }
 
             // Test only
             /*
@@ -888,6 +907,15 @@ QState Wifi::Connected(Wifi * const me, QEvt const * const e) {
                 break;
             }
             */
+            return Q_HANDLED();
+        }
+        case DATA_IN_DRAINED: {
+            EVENT(e);
+            if (me->m_dataInFull) {
+                me->m_dataInFull = false;
+                me->m_dataPollTimer.Start(DATA_POLL_TIMEOUT_MS);
+            }
+            return Q_HANDLED();
         }
     }
     return Q_SUPER(&Wifi::Running);
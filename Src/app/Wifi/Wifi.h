@@ -45,6 +45,7 @@
 #include "fw_timer.h"
 #include "fw_evt.h"
 #include "fw_pipe.h"
+#include "fw_spscpipe.h"
 #include "app_hsmn.h"
 #include "Pin.h"
 #include "es_wifi.h"            // In system/BSP...
@@ -164,7 +165,8 @@ protected:
     enum {
         SOCKET_NUM = 0,
         LOCAL_PORT = 60000,
-        MAX_SEND_LEN = ES_WIFI_PAYLOAD_SIZE
+        MAX_SEND_LEN = ES_WIFI_PAYLOAD_SIZE,
+        MAX_RECV_LEN = ES_WIFI_PAYLOAD_SIZE
     };
 
     Hsmn m_client;
@@ -179,7 +181,8 @@ protected:
     char m_domain[WifiConnectReq::DOMAIN_LEN];  // Domain or IP address string of remote server.
     uint16_t m_port;                            // Port of remote server.
     Fifo *m_dataOutFifo;
-    Fifo *m_dataInFifo;
+    SpscFifo *m_dataInFifo;
+    bool m_dataInFull;                  // Data polling is paused until m_dataInFifo drains below its low watermark.
     uint8_t m_macAddr[6];
     uint32_t m_retryCnt;
     Evt m_inEvt;                        // Static event copy of a generic incoming req to be confirmed. Added more if needed.
@@ -196,7 +199,8 @@ protected:
     ADD_EVT(FAILED) \
     ADD_EVT(INIT_FAILED) \
     ADD_EVT(FAULT_EVT) \
-    ADD_EVT(DISCONNECTED)
+    ADD_EVT(DISCONNECTED) \
+    ADD_EVT(DATA_IN_DRAINED)
 
 #undef ADD_EVT
 #define ADD_EVT(e_) e_,
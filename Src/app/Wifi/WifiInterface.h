@@ -42,6 +42,7 @@
 #include "fw_def.h"
 #include "fw_evt.h"
 #include "fw_pipe.h"
+#include "fw_spscpipe.h"
 #include "fw_assert.h"
 #include "app_hsmn.h"
 
@@ -163,14 +164,14 @@ public:
     enum {
         TIMEOUT_MS = 5000
     };
-    WifiConnectReq(char const *domain, uint16_t port, Fifo *dataOutFifo, Fifo *dataInFifo) :
+    WifiConnectReq(char const *domain, uint16_t port, Fifo *dataOutFifo, SpscFifo *dataInFifo) :
         Evt(WIFI_CONNECT_REQ), m_port(port), m_dataOutFifo(dataOutFifo), m_dataInFifo(dataInFifo) {
         STRBUF_COPY(m_domain, domain);
     }
     char const *GetDomain() const { return m_domain; }
     uint16_t GetPort() const { return m_port; }
     Fifo *GetDataOutFifo() const { return m_dataOutFifo; }
-    Fifo *GetDataInFifo() const { return m_dataInFifo; }
+    SpscFifo *GetDataInFifo() const { return m_dataInFifo; }
     enum {
         DOMAIN_LEN = 100,       // Length of domain name or IP address string including null termination.
     };
@@ -178,7 +179,7 @@ private:
     char m_domain[DOMAIN_LEN];
     uint16_t m_port;
     Fifo *m_dataOutFifo;
-    Fifo *m_dataInFifo;
+    SpscFifo *m_dataInFifo;
 };
 
 class WifiConnectCfm : public ErrorEvt {
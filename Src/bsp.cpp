@@ -37,9 +37,11 @@
  ******************************************************************************/
 
 #include <string.h>
-#include <stdio.h>
 #include "qpcpp.h"
 #include "bsp.h"
+#include "fw_timer.h"
+#include "fw_xthread.h"
+#include "fw_format.h"
 
 Q_DEFINE_THIS_FILE
 
@@ -49,11 +51,24 @@ Q_DEFINE_THIS_FILE
 //#define ENABLE_BSP_PRINT
 
 static volatile uint32_t idleCnt = 0;
+static volatile uint32_t deepSleepLockCnt = 0;
+static volatile uint32_t stop2LockCnt = 0;
 
 static UART_HandleTypeDef usart;
 
 /* top of stack (highest address) defined in the linker script -------------*/
 extern int _estack;
+// Size of the main stack, given by the address of the symbol.
+extern "C" uint32_t _Min_Stack_Size;
+
+enum {
+    STACK_PAINT_MARGIN = 16,            // Words below the stack pointer not painted.
+};
+
+static uint32_t *MainStackBase() {
+    uint32_t top = reinterpret_cast<uint32_t>(&_estack);
+    return reinterpret_cast<uint32_t *>(top - reinterpret_cast<uint32_t>(&_Min_Stack_Size));
+}
 
 static void InitUart() {
     // USART1 (TX=PB6, RX=PB7) is used as the virtual COM port in ST-Link.
@@ -80,9 +95,437 @@ static void WriteUart(char const *buf, uint32_t len) {
     HAL_UART_Transmit(&usart, (uint8_t *)buf, len, 0xFFFF);
 }
 
+// TIM6 is clocked by PCLK1 (APB1 not divided, see SystemClock_Config()) and counts at 1 MHz.
+enum {
+    TIM6_HZ = 1000000,
+};
+
+// Jitter in cycles, converted by BspGetFastTickStat().
+static struct {
+    uint32_t tickCount;
+    uint32_t startCount;
+    uint32_t intervalCount;
+    int32_t minErr;
+    int32_t maxErr;
+    uint64_t sumAbsErr;
+    uint32_t maxIsr;
+} fastTickStat;
+static uint32_t lastFastTickCycle;
+static bool fastTickResync;
+
+static void InitFastTick() {
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    TIM6->CR1 = TIM_CR1_URS;                // Only overflow sets UIF, not UG.
+    TIM6->PSC = SystemCoreClock / TIM6_HZ - 1;
+    TIM6->ARR = TIM6_HZ / BSP_FAST_TICKS_PER_SEC - 1;
+    TIM6->EGR = TIM_EGR_UG;                 // Loads PSC.
+    TIM6->SR = 0;
+    TIM6->DIER = TIM_DIER_UIE;
+    NVIC_SetPriority(TIM6_DAC_IRQn, TIM6_PRIO);
+    NVIC_EnableIRQ(TIM6_DAC_IRQn);
+}
+
+// Must be called in a critical section.
+static void StopFastTick() {
+    TIM6->CR1 &= ~TIM_CR1_CEN;
+    TIM6->SR = 0;
+    NVIC_ClearPendingIRQ(TIM6_DAC_IRQn);
+}
+
+void BspStartTick(uint8_t tickRate) {
+    if (tickRate != TICK_RATE_FAST) {
+        return;
+    }
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    if (!(TIM6->CR1 & TIM_CR1_CEN)) {
+        // The first tick is a full period from now.
+        TIM6->CNT = 0;
+        TIM6->CR1 |= TIM_CR1_CEN;
+        fastTickStat.startCount++;
+        fastTickResync = true;
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+void BspFastTickDone(uint32_t entryCycle) {
+    uint32_t now = GetCycleCount();
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    fastTickStat.tickCount++;
+    if (fastTickResync) {
+        fastTickResync = false;
+    } else {
+        int32_t err = static_cast<int32_t>((entryCycle - lastFastTickCycle) - SystemCoreClock / BSP_FAST_TICKS_PER_SEC);
+        if ((fastTickStat.intervalCount == 0) || (err < fastTickStat.minErr)) {
+            fastTickStat.minErr = err;
+        }
+        if ((fastTickStat.intervalCount == 0) || (err > fastTickStat.maxErr)) {
+            fastTickStat.maxErr = err;
+        }
+        fastTickStat.sumAbsErr += (err < 0) ? -err : err;
+        fastTickStat.intervalCount++;
+    }
+    lastFastTickCycle = entryCycle;
+    if ((now - entryCycle) > fastTickStat.maxIsr) {
+        fastTickStat.maxIsr = now - entryCycle;
+    }
+    if (FW::Timer::IsIdle(TICK_RATE_FAST)) {
+        StopFastTick();
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+static int32_t CycleToNs(int32_t cycle) {
+    return static_cast<int64_t>(cycle) * 1000000000 / static_cast<int32_t>(SystemCoreClock);
+}
+
+void BspGetFastTickStat(BspFastTickStat &stat) {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    stat.periodNs = 1000000000 / BSP_FAST_TICKS_PER_SEC;
+    stat.tickCount = fastTickStat.tickCount;
+    stat.startCount = fastTickStat.startCount;
+    stat.intervalCount = fastTickStat.intervalCount;
+    stat.minErrNs = CycleToNs(fastTickStat.minErr);
+    stat.maxErrNs = CycleToNs(fastTickStat.maxErr);
+    stat.avgErrNs = fastTickStat.intervalCount ? CycleToNs(fastTickStat.sumAbsErr / fastTickStat.intervalCount) : 0;
+    stat.maxIsrNs = CycleToNs(fastTickStat.maxIsr);
+    QF_CRIT_EXIT(crit);
+}
+
+void BspResetFastTickStat() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    memset(&fastTickStat, 0, sizeof(fastTickStat));
+    fastTickResync = true;
+    QF_CRIT_EXIT(crit);
+}
+
+#ifdef ENABLE_BSP_TICKLESS
+
+// HAL tick counter advanced by SysTick_Handler() via HAL_IncTick().
+extern "C" __IO uint32_t uwTick;
+
+enum {
+    LPTIM_HZ = LSE_VALUE / 16,          // 2048 Hz, with a range of 32s.
+    LPTIM_MAX_COUNT = 0xFFFF,
+    MIN_TICKLESS_TICK = 3,              // Below this it is not worth stopping SysTick.
+};
+
+struct WakeIrq {
+    IRQn_Type irq;
+    uint8_t reason;
+};
+
+// Checked in order for a pending interrupt after wakeup.
+static WakeIrq const wakeIrq[] = {
+    { LPTIM1_IRQn, BSP_WAKE_TIMER },
+    { EXTI0_IRQn, BSP_WAKE_GPIO }, { EXTI1_IRQn, BSP_WAKE_GPIO }, { EXTI2_IRQn, BSP_WAKE_GPIO },
+    { EXTI3_IRQn, BSP_WAKE_GPIO }, { EXTI4_IRQn, BSP_WAKE_GPIO }, { EXTI9_5_IRQn, BSP_WAKE_GPIO },
+    { EXTI15_10_IRQn, BSP_WAKE_GPIO },
+    { USART1_IRQn, BSP_WAKE_UART }, { USART2_IRQn, BSP_WAKE_UART },
+    { DMA1_Channel4_IRQn, BSP_WAKE_DMA }, { DMA1_Channel5_IRQn, BSP_WAKE_DMA }, { DMA2_Channel3_IRQn, BSP_WAKE_DMA },
+    { DMA2_Channel4_IRQn, BSP_WAKE_DMA }, { DMA2_Channel6_IRQn, BSP_WAKE_DMA }, { DMA2_Channel7_IRQn, BSP_WAKE_DMA },
+    { I2C1_EV_IRQn, BSP_WAKE_BUS }, { I2C1_ER_IRQn, BSP_WAKE_BUS }, { I2C2_EV_IRQn, BSP_WAKE_BUS },
+    { I2C2_ER_IRQn, BSP_WAKE_BUS }, { SPI1_IRQn, BSP_WAKE_BUS }, { SPI3_IRQn, BSP_WAKE_BUS },
+};
+
+static char const * const wakeName[BSP_WAKE_COUNT] = { "timer", "tick", "gpio", "uart", "dma", "bus", "other" };
+
+static DMA_Channel_TypeDef * const dmaChannel[] = {
+    DMA1_Channel1, DMA1_Channel2, DMA1_Channel3, DMA1_Channel4, DMA1_Channel5, DMA1_Channel6, DMA1_Channel7,
+    DMA2_Channel1, DMA2_Channel2, DMA2_Channel3, DMA2_Channel4, DMA2_Channel5, DMA2_Channel6, DMA2_Channel7,
+};
+
+// Residency in LPTIM counts and awake time in cycles, converted by BspGetIdleStat().
+static struct {
+    uint32_t stopCount;
+    uint32_t sleepCount;
+    uint32_t stopLptim;
+    uint32_t sleepLptim;
+    uint32_t shortCount;
+    uint32_t wakeCount[BSP_WAKE_COUNT];
+    uint64_t awakeCycle[BSP_WAKE_COUNT];
+} idleStat;
+static uint8_t lastWake = BSP_WAKE_OTHER;
+static uint32_t lastWakeCycle;
+// Fraction of a tick in units of 1/LPTIM_HZ carried to the next tickless idle.
+static uint32_t tickRemainder;
+
+// LPTIM1 is clocked by LSE, so it keeps running in STOP2.
+static void InitLptim() {
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    RCC_OscInitTypeDef oscInit = {};
+    oscInit.OscillatorType = RCC_OSCILLATORTYPE_LSE;
+    oscInit.LSEState = RCC_LSE_ON;
+    oscInit.PLL.PLLState = RCC_PLL_NONE;
+    HAL_StatusTypeDef status = HAL_RCC_OscConfig(&oscInit);
+    Q_ASSERT(status == HAL_OK);
+    (void)status;
+    __HAL_RCC_LPTIM1_CONFIG(RCC_LPTIM1CLKSOURCE_LSE);
+    __HAL_RCC_LPTIM1_CLK_ENABLE();
+    // CFGR and IER can only be written when LPTIM is disabled.
+    LPTIM1->CR = 0;
+    LPTIM1->CFGR = LPTIM_CFGR_PRESC_2;      // Divided by 16.
+    LPTIM1->IER = LPTIM_IER_ARRMIE;
+    // EXTI line 32 wakes up from STOP2 on LPTIM1 interrupts.
+    EXTI->IMR2 |= EXTI_IMR2_IM32;
+    // It must be enabled in NVIC to end WFI, but it is cleared before interrupts are re-enabled (see TicklessIdle()).
+    NVIC_SetPriority(LPTIM1_IRQn, LPTIM1_PRIO);
+    NVIC_EnableIRQ(LPTIM1_IRQn);
+    lastWakeCycle = GetCycleCount();
+}
+
+// Starts LPTIM1 in one-shot mode to match after count.
+static void StartLptim(uint32_t count) {
+    LPTIM1->CR = LPTIM_CR_ENABLE;
+    // ARR can only be written when enabled and it takes a few LPTIM clocks to be synchronized.
+    LPTIM1->ARR = count;
+    while (!(LPTIM1->ISR & LPTIM_ISR_ARROK)) {
+    }
+    LPTIM1->ICR = LPTIM_ICR_ARROKCF;
+    LPTIM1->CR = LPTIM_CR_ENABLE | LPTIM_CR_SNGSTRT;
+}
+
+// Stops LPTIM1 and returns the elapsed count.
+static uint32_t StopLptim(uint32_t count) {
+    if (!(LPTIM1->ISR & LPTIM_ISR_ARRM)) {
+        // CNT is asynchronous to the APB clock, so it is valid when two consecutive reads match.
+        uint32_t cnt;
+        do {
+            count = LPTIM1->CNT;
+            cnt = LPTIM1->CNT;
+        } while (cnt != count);
+    }
+    LPTIM1->CR = 0;
+    LPTIM1->ICR = LPTIM_ICR_ARRMCF;
+    NVIC_ClearPendingIRQ(LPTIM1_IRQn);
+    return count;
+}
+
+enum IdleMode {
+    IDLE_SLEEP,         // WFI with SysTick stopped.
+    IDLE_STOP1,
+    IDLE_STOP2,
+};
+
+// Returns the deepest mode allowed while idle. DMA stops in STOP modes, so a non-circular transfer in flight (e.g.
+// UART TX, I2C or SPI) prevents them. Circular transfers run indefinitely and are not checked. Their drivers must
+// either allow STOP1 only with a wakeup source that keeps up with the data (see BspStop2Lock()) or hold
+// BspDeepSleepLock().
+static IdleMode GetIdleMode() {
+    if (deepSleepLockCnt) {
+        return IDLE_SLEEP;
+    }
+    for (uint32_t i = 0; i < ARRAY_COUNT(dmaChannel); i++) {
+        uint32_t ccr = dmaChannel[i]->CCR;
+        if ((ccr & DMA_CCR_EN) && !(ccr & DMA_CCR_CIRC) && dmaChannel[i]->CNDTR) {
+            return IDLE_SLEEP;
+        }
+    }
+    return stop2LockCnt ? IDLE_STOP1 : IDLE_STOP2;
+}
+
+// Called with interrupts disabled. Returns false if the idle period must be short, i.e. the next tick of
+// TICK_RATE_BSP is due within MIN_TICKLESS_TICK or time events are armed at other tick rates, which may be
+// driven by clocks that do not run while idle. Otherwise deadline is the number of ticks until the next time event
+// expires, or 0 if none is armed.
+static bool GetDeadline(uint32_t &deadline) {
+    deadline = QP::QF::nextTickX(TICK_RATE_BSP);
+#ifdef ENABLE_FW_TIMER_WHEEL
+    uint32_t wheel = FW::Timer::NextTick(TICK_RATE_BSP);
+    if (wheel && (!deadline || (wheel < deadline))) {
+        deadline = wheel;
+    }
+#endif
+    for (uint8_t rate = 0; rate < QF_MAX_TICK_RATE; rate++) {
+        if ((rate != TICK_RATE_BSP) && !FW::Timer::IsIdle(rate)) {
+            return false;
+        }
+    }
+    return !deadline || (deadline >= MIN_TICKLESS_TICK);
+}
+
+// Restores the PLL as system clock, since the CPU wakes up from STOP1 and STOP2 with MSI.
+static void RestoreClock() {
+    __HAL_RCC_PLL_ENABLE();
+    while (!__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY)) {
+    }
+    __HAL_RCC_SYSCLK_CONFIG(RCC_SYSCLKSOURCE_PLLCLK);
+    while (__HAL_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_PLLCLK) {
+    }
+}
+
+static uint8_t GetWakeReason() {
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        return BSP_WAKE_TICK;
+    }
+    for (uint32_t i = 0; i < ARRAY_COUNT(wakeIrq); i++) {
+        if (NVIC_GetPendingIRQ(wakeIrq[i].irq)) {
+            return wakeIrq[i].reason;
+        }
+    }
+    return BSP_WAKE_OTHER;
+}
+
+// Called by QXK::onIdle() with interrupts disabled by QF_INT_DISABLE(). Returns with interrupts enabled.
+// SysTick is stopped and LPTIM1 wakes up the CPU at the next time event deadline. On wakeup, the ticks that
+// have elapsed are skipped in QF (and the timer wheel) and in the HAL tick. If the deadline has been reached,
+// SysTick is pended so that its ISR processes the due tick as usual. The part of a tick elapsed before SysTick
+// is stopped is not counted.
+static void TicklessIdle() {
+    idleStat.awakeCycle[lastWake] += GetCycleCount() - lastWakeCycle;
+    uint32_t deadline;
+    if (!GetDeadline(deadline)) {
+        idleStat.shortCount++;
+        // PRIMASK rather than BASEPRI masks interrupts during WFI, since a pending interrupt masked by BASEPRI
+        // does not end WFI.
+        __disable_irq();
+        QF_INT_ENABLE();
+        __WFI();
+        lastWake = GetWakeReason();
+        idleStat.wakeCount[lastWake]++;
+        lastWakeCycle = GetCycleCount();
+        __enable_irq();
+        return;
+    }
+    uint32_t maxTick = static_cast<uint64_t>(LPTIM_MAX_COUNT) * BSP_TICKS_PER_SEC / LPTIM_HZ;
+    uint32_t sleepTick = (deadline && (deadline < maxTick)) ? deadline : maxTick;
+    IdleMode mode = GetIdleMode();
+    bool deep = (mode != IDLE_SLEEP);
+    __disable_irq();
+    QF_INT_ENABLE();
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    // No timer is armed at TICK_RATE_FAST (see GetDeadline()), but TIM6 may not have stopped itself yet.
+    StopFastTick();
+    uint32_t count = static_cast<uint64_t>(sleepTick) * LPTIM_HZ / BSP_TICKS_PER_SEC;
+    StartLptim(count);
+    if (mode == IDLE_STOP2) {
+        HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFI);
+        RestoreClock();
+    } else if (mode == IDLE_STOP1) {
+        HAL_PWREx_EnterSTOP1Mode(PWR_STOPENTRY_WFI);
+        RestoreClock();
+    } else {
+        __WFI();
+    }
+    count = StopLptim(count);
+    lastWake = GetWakeReason();
+    if (deep) {
+        idleStat.stopCount++;
+        idleStat.stopLptim += count;
+    } else {
+        idleStat.sleepCount++;
+        idleStat.sleepLptim += count;
+    }
+    idleStat.wakeCount[lastWake]++;
+    uint32_t total = count * BSP_TICKS_PER_SEC + tickRemainder;
+    uint32_t elapsed = total / LPTIM_HZ;
+    tickRemainder = total % LPTIM_HZ;
+    // Interrupts are disabled by PRIMASK, so it is a critical section for QF.
+    uint32_t skip = (deadline && (elapsed >= deadline)) ? (deadline - 1) : elapsed;
+    if (skip) {
+        QP::QF::skipTickX(TICK_RATE_BSP, skip);
+#ifdef ENABLE_FW_TIMER_WHEEL
+        FW::Timer::SkipTick(TICK_RATE_BSP, skip);
+#endif
+        uwTick += skip;
+    }
+    if (deadline && (elapsed >= deadline)) {
+        SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+    }
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    lastWakeCycle = GetCycleCount();
+    __enable_irq();
+}
+
+void BspGetIdleStat(BspIdleStat &stat) {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    stat.stopMs = static_cast<uint64_t>(idleStat.stopLptim) * 1000 / LPTIM_HZ;
+    stat.sleepMs = static_cast<uint64_t>(idleStat.sleepLptim) * 1000 / LPTIM_HZ;
+    stat.stopCount = idleStat.stopCount;
+    stat.sleepCount = idleStat.sleepCount;
+    stat.shortCount = idleStat.shortCount;
+    for (uint32_t i = 0; i < BSP_WAKE_COUNT; i++) {
+        stat.wakeCount[i] = idleStat.wakeCount[i];
+        stat.awakeMs[i] = idleStat.awakeCycle[i] / (SystemCoreClock / 1000);
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+void BspResetIdleStat() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    memset(&idleStat, 0, sizeof(idleStat));
+    QF_CRIT_EXIT(crit);
+}
+
+char const *BspGetWakeName(uint8_t reason) {
+    return (reason < BSP_WAKE_COUNT) ? wakeName[reason] : "";
+}
+
+#endif // ENABLE_BSP_TICKLESS
+
+// Fills the main stack below the current stack pointer with BSP_STACK_PAINT. Interrupts are masked since ISRs
+// run on the main stack.
+static void PaintMainStack() {
+    uint32_t *p = MainStackBase();
+    uint32_t *sp = reinterpret_cast<uint32_t *>(__get_MSP()) - STACK_PAINT_MARGIN;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    while (p < sp) {
+        *p++ = BSP_STACK_PAINT;
+    }
+    __set_PRIMASK(primask);
+}
+
+uint32_t BspGetStackUsed(void const *base, uint32_t size) {
+    uint32_t const *p = static_cast<uint32_t const *>(base);
+    uint32_t count = size / sizeof(uint32_t);
+    uint32_t i = 0;
+    while ((i < count) && (p[i] == BSP_STACK_PAINT)) {
+        i++;
+    }
+    return size - i * sizeof(uint32_t);
+}
+
+void BspGetMainStackUsage(uint32_t &size, uint32_t &maxUsed) {
+    size = reinterpret_cast<uint32_t>(&_Min_Stack_Size);
+    maxUsed = BspGetStackUsed(MainStackBase(), size);
+}
+
+// Logs the stack usage of the main stack and extended threads in direct mode (see Q_onAssert()).
+static void DumpStack() {
+    char buf[80];
+    uint32_t size, maxUsed;
+    BspGetMainStackUsage(size, maxUsed);
+    FW::Format::Print(buf, sizeof(buf), "STACK main %lu/%lu\n\r", maxUsed, size);
+    WriteUart(buf, strlen(buf));
+    for (uint8_t prio = 1; prio <= QF_MAX_ACTIVE; prio++) {
+        FW::XThread const *thread = FW::XThread::Get(prio);
+        if (thread) {
+            thread->GetStackUsage(size, maxUsed);
+            FW::Format::Print(buf, sizeof(buf), "STACK %u %lu/%lu\n\r", prio, maxUsed, size);
+            WriteUart(buf, strlen(buf));
+        }
+    }
+}
+
 void BspInit() {
+    PaintMainStack();
     // STM32 HAL library initialization
     HAL_Init();
+    // Enable the DWT cycle counter used by GetCycleCount().
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#ifdef ENABLE_BSP_TICKLESS
+    InitLptim();
+#endif
 #ifdef ENABLE_BSP_PRINT
     InitUart();
 #endif // ENABLE_BSP_PRINT
@@ -109,6 +552,7 @@ extern "C" void BspTrace(char const *buf, uint32_t len) {
 }
 
 // Hooks required by multi-threading support for newlib malloc.
+// Not used when malloc() is routed to Heap (see ENABLE_FW_HEAP_MALLOC in fw_heap.h).
 extern "C" void __malloc_lock() {
     QF_INT_DISABLE();
 }
@@ -117,6 +561,45 @@ extern "C" void __malloc_unlock() {
     QF_INT_ENABLE();
 }
 
+void BspDeepSleepLock() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    deepSleepLockCnt++;
+    QF_CRIT_EXIT(crit);
+}
+
+void BspDeepSleepUnlock() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    Q_ASSERT(deepSleepLockCnt > 0);
+    deepSleepLockCnt--;
+    QF_CRIT_EXIT(crit);
+}
+
+void BspStop2Lock() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    stop2LockCnt++;
+    QF_CRIT_EXIT(crit);
+}
+
+void BspStop2Unlock() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    Q_ASSERT(stop2LockCnt > 0);
+    stop2LockCnt--;
+    QF_CRIT_EXIT(crit);
+}
+
+void BspLock::Lock() {
+    QP::QSchedStatus stat = QP::QXK::schedLock(m_ceiling);
+    m_stat = stat;
+}
+
+void BspLock::Unlock() {
+    QP::QXK::schedUnlock(m_stat);
+}
+
 uint32_t GetSystemMs() {
     return HAL_GetTick() * BSP_MSEC_PER_TICK;
 }
@@ -144,6 +627,49 @@ HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority) {
     return HAL_OK;
 }
 
+// CPU time per QF priority. See BspCpuTime in bsp.h.
+static uint64_t cpuCycle[QF_MAX_ACTIVE + 1];
+static uint32_t cpuSwitchCount[QF_MAX_ACTIVE + 1];
+static uint8_t cpuPrio;                 // Priority of the running thread.
+static uint32_t cpuLastCycle;
+static uint32_t cpuResetMs;
+
+// Charges the cycles since the last switch to the running thread and switches to nextPrio.
+// Must be called with interrupts disabled.
+static void ChargeCpu(uint8_t nextPrio) {
+    uint32_t now = GetCycleCount();
+    cpuCycle[cpuPrio] += now - cpuLastCycle;
+    cpuLastCycle = now;
+    if (nextPrio != cpuPrio) {
+        cpuSwitchCount[nextPrio]++;
+        cpuPrio = nextPrio;
+    }
+}
+
+void BspGetCpuTime(uint8_t prio, BspCpuTime &time) {
+    Q_ASSERT(prio <= QF_MAX_ACTIVE);
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    ChargeCpu(cpuPrio);
+    time.cycle = cpuCycle[prio];
+    time.switchCount = cpuSwitchCount[prio];
+    QF_CRIT_EXIT(crit);
+}
+
+uint64_t BspGetCpuElapsed() {
+    return static_cast<uint64_t>(GetSystemMs() - cpuResetMs) * (SystemCoreClock / 1000);
+}
+
+void BspResetCpuTime() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    memset(cpuCycle, 0, sizeof(cpuCycle));
+    memset(cpuSwitchCount, 0, sizeof(cpuSwitchCount));
+    cpuLastCycle = GetCycleCount();
+    cpuResetMs = GetSystemMs();
+    QF_CRIT_EXIT(crit);
+}
+
 // namespace QP **************************************************************
 namespace QP {
 
@@ -164,6 +690,7 @@ void QF::onStartup(void) {
 
     // enable IRQs...
     //NVIC_EnableIRQ(EXTI0_1_IRQn);
+    InitFastTick();
 }
 //............................................................................
 void QF::onCleanup(void) {
@@ -175,9 +702,13 @@ void QXK::onIdle(void) {
     //GPIOA->BSRR |= (LED_LD2);        // turn LED[n] on
     //GPIOA->BSRR |= (LED_LD2 << 16);  // turn LED[n] off
     idleCnt++;
+#ifdef ENABLE_BSP_TICKLESS
+    TicklessIdle();
+#else
     QF_INT_ENABLE();
+#endif
 
-#if defined NDEBUG
+#if defined NDEBUG && !defined ENABLE_BSP_TICKLESS
     // Put the CPU and peripherals to the low-power mode.
     // you might need to customize the clock management for your application,
     // see the datasheet for your particular Cortex-M3 MCU.
@@ -199,6 +730,7 @@ void QXK::onIdle(void) {
 // NOTE: the context-switch callback is called with interrupts DISABLED
 extern "C" void QXK_onContextSw(QActive *prev, QActive *next) {
     (void)prev;
+    ChargeCpu(next ? next->m_prio : 0);
     if (next != (QActive *)0) { // next is not the QK idle loop?
         _impure_ptr = static_cast<struct _reent *>(next->m_thread); // switch to next TLS
     }
@@ -215,8 +747,9 @@ extern "C" void Q_onAssert(char const * const module, int loc) {
     // Reinitializes uart and output assert message in direct mode (not INT or DMA).
     InitUart();
     char buf[100];
-    snprintf(buf, sizeof(buf), "ASSERT FAILED in %s at line %d\n\r", module, loc);
+    FW::Format::Print(buf, sizeof(buf), "ASSERT FAILED in %s at line %d\n\r", module, loc);
     WriteUart(buf, strlen(buf));
+    DumpStack();
     QF_INT_DISABLE();
     for (;;) {
     }
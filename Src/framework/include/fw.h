@@ -45,6 +45,10 @@
 #include "fw_map.h"
 #include "fw_maptype.h"
 #include "fw_def.h"
+#include "fw_latency.h"
+#include "fw_poolstat.h"
+#include "fw_payload.h"
+#include "fw_lfpool.h"
 
 namespace FW {
 
@@ -57,25 +61,104 @@ public:
     static Hsm *GetHsm(Hsmn hsmn);
     static QP::QActive *GetContainer(Hsmn hsmn);
 
+    // Statistics of PostNotInQ().
+    struct NotInQStat {
+        uint32_t posted;        // Events posted.
+        uint32_t coalesced;     // Events discarded as a matching one is still in queue.
+        uint32_t scanned;       // Checks that fell back to scanning the event queue.
+    };
+    static NotInQStat GetNotInQStat() { return m_notInQStat; }
+    static void ResetNotInQStat() { m_notInQStat = NotInQStat(); }
+
+    // Active objects and extended threads are identified by their QF priority (1 to QF_MAX_ACTIVE).
+    // Returns the HSM of the active object at prio, or the first region of an extended thread. NULL if unused.
+    static Hsm *GetActiveHsm(uint8_t prio);
+    // Gets the size and high-water mark of the event queue of the active object at prio. Returns false if unused.
+    static bool GetQueueUsage(uint8_t prio, uint32_t &size, uint32_t &maxUsed);
+    static void ResetQueueUsage();
+
+    // Allocates a dynamic event of size bytes from the smallest event pool that fits it (see Evt::operator new).
+    // It asserts if that pool is exhausted, after counting the failure. The small pool is lock-free (see LfPool)
+    // so that ISRs can allocate small events without a critical section. Other pools are QF pools.
+    static QP::QEvt *NewEvt(uint32_t size);
+    // Event pools are identified by 1 to GetPoolCount() in ascending block size.
+    struct PoolUsage {
+        uint32_t blockSize;
+        uint32_t blockCount;
+        uint32_t minFree;       // Since startup.
+        uint32_t allocCount;    // Since startup or ResetPoolUsage().
+        uint32_t failCount;     // Since startup or ResetPoolUsage().
+    };
+    static uint8_t GetPoolCount() { return EVT_POOL_COUNT; }
+    static void GetPoolUsage(uint8_t poolId, PoolUsage &usage);
+    static void ResetPoolUsage();
+    // Called by QF::gc() before the dynamic event e is recycled. Releases the payload attached to e, if any.
+    // Returns true if e is from the small pool, in which case it has been returned to it.
+    static bool OnGc(QP::QEvt const *e);
+#ifdef ENABLE_FW_POOL_STAT
+    // Returns the size passed to NewEvt() for the event at e and clears it. Returns 0 if it has been taken,
+    // or if e is not in an event pool (e.g. a static event).
+    static uint32_t TakeNewSize(QP::QEvt const *e);
+#endif
+
+#ifdef ENABLE_FW_LATENCY
+    // Post-to-dispatch latency. Only dynamic events posted via Post(), PostNotInQ() or PostSync() are
+    // timestamped. The timestamp is consumed on dispatch, so static (timer) events and recalled events
+    // are not counted.
+    static void StampPost(QP::QEvt const *e);
+    static void ClearPost(QP::QEvt const *e);
+    static void RecordDispatch(QP::QActive const *act, QP::QEvt const *e);
+    static bool GetLatency(uint8_t prio, LatencyHist &hist);
+    static void ResetLatency();
+#endif
+
 protected:
     enum {
-        EVT_POOL_COUNT = 4,     // Number of event pools (small, medium and large).
+        EVT_POOL_COUNT = 3,     // Number of event pools (small, medium and large).
         EVT_SIZE_SMALL = 32,
         EVT_SIZE_MEDIUM = 64,
         EVT_SIZE_LARGE = 256,
-        EVT_SIZE_XLARGE = 2048,
         EVT_COUNT_SMALL = 32,
         EVT_COUNT_MEDIUM = 8,
-        EVT_COUNT_LARGE = 4,
-        EVT_COUNT_XLARGE = 2
+        EVT_COUNT_LARGE = 4
+    };
+    // QF pool ID of small events. Medium and larger pools are QF pools 1 to EVT_POOL_COUNT - 1.
+    enum {
+        SMALL_POOL_QF_ID = EVT_POOL_COUNT
     };
 
     static HsmAct m_hsmActStor[MAX_HSM_COUNT];
     static HsmActMap m_hsmActMap;
+    static NotInQStat m_notInQStat;
     static uint32_t m_evtPoolSmall[ROUND_UP_DIV_4(EVT_SIZE_SMALL * EVT_COUNT_SMALL)];
     static uint32_t m_evtPoolMedium[ROUND_UP_DIV_4(EVT_SIZE_MEDIUM * EVT_COUNT_MEDIUM)];
     static uint32_t m_evtPoolLarge[ROUND_UP_DIV_4(EVT_SIZE_LARGE * EVT_COUNT_LARGE)];
-    static uint32_t m_evtPoolXLarge[ROUND_UP_DIV_4(EVT_SIZE_XLARGE * EVT_COUNT_XLARGE)];
+    static uint32_t const * const m_poolStart[EVT_POOL_COUNT];
+    static uint32_t const m_blockSize[EVT_POOL_COUNT];
+    static uint32_t const m_blockCount[EVT_POOL_COUNT];
+    static LfPool m_smallPool;
+    static std::atomic<uint32_t> m_allocCount[EVT_POOL_COUNT];
+    static std::atomic<uint32_t> m_failCount[EVT_POOL_COUNT];
+    enum {
+        EVT_BLOCK_COUNT = EVT_COUNT_SMALL + EVT_COUNT_MEDIUM + EVT_COUNT_LARGE
+    };
+    // Gets the index of the block holding e across all event pools (0 to EVT_BLOCK_COUNT - 1).
+    // Returns false if e is not in an event pool.
+    static bool GetBlockIndex(QP::QEvt const *e, uint32_t &index);
+    // Payload attached to each dynamic event indexed by its block in the event pools. NULL if none.
+    static Payload *m_payload[EVT_BLOCK_COUNT];
+    // Called by Payload::AttachTo(), which has taken the reference.
+    static void AttachPayload(QP::QEvt const *e, Payload *payload);
+    friend class Payload;
+#ifdef ENABLE_FW_POOL_STAT
+    static uint16_t m_newSize[EVT_BLOCK_COUNT];
+#endif
+#ifdef ENABLE_FW_LATENCY
+    // Post time of each dynamic event indexed by its block in the event pools. 0 if not timestamped.
+    static uint32_t volatile m_postTime[EVT_BLOCK_COUNT];
+    static LatencyHist m_latencyHist[QF_MAX_ACTIVE + 1];
+    static uint32_t volatile *GetPostTime(QP::QEvt const *e);
+#endif
 
     static bool EventMatched(Evt const *e1, QP::QEvt const *e2);
     static bool EventInQNoCrit(Evt const *e, QP::QEQueue *queue);
@@ -83,4 +166,14 @@ protected:
 
 } // namespace FW
 
+#ifdef ENABLE_FW_LATENCY
+#define FW_LAT_POST(e_)             FW::Fw::StampPost(e_)
+#define FW_LAT_CLEAR(e_)            FW::Fw::ClearPost(e_)
+#define FW_LAT_DISPATCH(act_, e_)   FW::Fw::RecordDispatch((act_), (e_))
+#else
+#define FW_LAT_POST(e_)
+#define FW_LAT_CLEAR(e_)
+#define FW_LAT_DISPATCH(act_, e_)
+#endif
+
 #endif // FW_H
@@ -47,15 +47,12 @@
 
 namespace FW {
 
-class Active : public QP::QActive {
+// Base class of active objects. Storage of the event queue, region table, Hsm queues and NewLib TLS
+// is provided by ActiveT below, which is what application classes derive from (usually via Active).
+class ActiveBase : public QP::QActive {
 public:
-    Active(QP::QStateHandler const initial, Hsmn hsmn, char const *name) :
-        QP::QActive(initial),
-        m_hsm(hsmn, name, this),
-        m_hsmnRegMap(m_hsmnRegStor, ARRAY_COUNT(m_hsmnRegStor), HsmnReg(HSM_UNDEF, NULL)){
-    }
     void Start(uint8_t prio);
-    void Add(Region *reg);
+    void Add(RegionBase *reg);
     Hsm &GetHsm() { return m_hsm; }
     virtual void dispatch(QP::QEvt const * const e, std::uint_fast8_t const qs_id);
 
@@ -75,13 +72,13 @@ public:
     void SendNotInQ(Evt *e,  Hsmn to) { m_hsm.SendNotInQ(e, to); }
     void SendNotInQ(Evt *e, Hsmn to, Sequence seq) { m_hsm.SendNotInQ(e, to ,seq); }
 
-    void SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRec &seqRec) { m_hsm.SendReq(e, to, reset, seqRec); }
-    void SendInd(Evt *e, Hsmn to, bool reset, EvtSeqRec &seqRec) { m_hsm.SendInd(e, to, reset, seqRec); }
+    void SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRecBase &seqRec) { m_hsm.SendReq(e, to, reset, seqRec); }
+    void SendInd(Evt *e, Hsmn to, bool reset, EvtSeqRecBase &seqRec) { m_hsm.SendInd(e, to, reset, seqRec); }
     // Using built-in event sequence record.
     void SendReq(Evt *e, Hsmn to, bool reset) { m_hsm.SendReq(e, to, reset); }
     void SendInd(Evt *e, Hsmn to, bool reset) { m_hsm.SendInd(e, to, reset); }
-    bool CheckCfm(ErrorEvt const &e, bool &allReceived, EvtSeqRec &seqRec) { return m_hsm.CheckCfm(e, allReceived, seqRec); }
-    bool CheckRsp(ErrorEvt const &e, bool &allReceived, EvtSeqRec &seqRec) { return m_hsm.CheckRsp(e, allReceived, seqRec); }
+    bool CheckCfm(ErrorEvt const &e, bool &allReceived, EvtSeqRecBase &seqRec) { return m_hsm.CheckCfm(e, allReceived, seqRec); }
+    bool CheckRsp(ErrorEvt const &e, bool &allReceived, EvtSeqRecBase &seqRec) { return m_hsm.CheckRsp(e, allReceived, seqRec); }
     bool CheckCfm(ErrorEvt const &e, bool &allReceived) { return m_hsm.CheckCfm(e, allReceived); }
     bool CheckRsp(ErrorEvt const &e, bool &allReceived) { return m_hsm.CheckRsp(e, allReceived); }
 
@@ -117,17 +114,62 @@ protected:
     void PostReminder(Evt const *e) { m_hsm.PostReminder(e); }
     void Raise(Evt *e) { m_hsm.Raise(e); }
 
-    enum {
-        MAX_REGION_COUNT = 8,
-        EVT_QUEUE_COUNT = 64 //16
-    };
+    // Only references to the storage are saved. It is constructed after this object.
+    template <uint16_t DEFER_QUEUE_COUNT, uint8_t REMINDER_QUEUE_COUNT, size_t EVT_SEQ_COUNT>
+    ActiveBase(QP::QStateHandler const initial, Hsmn hsmn, char const *name,
+               HsmStor<DEFER_QUEUE_COUNT, REMINDER_QUEUE_COUNT, EVT_SEQ_COUNT> &hsmStor,
+               QP::QEvt const *evtQueueStor[], uint16_t evtQueueCount, RegionBase *regStor[], uint8_t regCount) :
+        QP::QActive(initial),
+        m_hsm(hsmn, name, this, hsmStor),
+        m_hsmnRegTable(regStor, regCount),
+        m_evtQueueStor(evtQueueStor), m_evtQueueCount(evtQueueCount), m_tlsNewLib(NULL) {
+    }
+
     Hsm m_hsm;
-    HsmnReg m_hsmnRegStor[MAX_REGION_COUNT];
-    HsmnRegMap m_hsmnRegMap;
+    HsmnRegTable m_hsmnRegTable;
+    QP::QEvt const **m_evtQueueStor;
+    uint16_t m_evtQueueCount;
+    struct _reent *m_tlsNewLib;     // Thread-local-storage for NewLib. NULL to share the global one.
+};
+
+// Holds NewLib TLS if enabled. Without it, an active object shares the global NewLib reentrancy structure and
+// must not call NewLib functions keeping state in it (e.g. printf(), strtok(), rand()). malloc() is still safe since
+// it is serialized by __malloc_lock(). Log and Format do not use NewLib.
+template <bool ENABLE>
+class ActiveTls {
+protected:
+    struct _reent *GetTls() { return &m_tlsNewLib; }
+    struct _reent m_tlsNewLib;
+};
+
+template <>
+class ActiveTls<false> {
+protected:
+    struct _reent *GetTls() { return NULL; }
+};
+
+// Active object with its storage sized by template parameters. The defaults are the capacities used
+// before they became configurable. NewLib TLS is enabled by default. Only disable it for an active object whose
+// code has been checked not to use NewLib state such as errno or strtok() (see ActiveTls).
+template <uint16_t EVT_QUEUE_COUNT = 64, uint8_t MAX_REGION_COUNT = 8, uint16_t DEFER_QUEUE_COUNT = 16,
+          uint8_t REMINDER_QUEUE_COUNT = 4, size_t EVT_SEQ_COUNT = 16, bool TLS_NEWLIB = true>
+class ActiveT : public ActiveBase, protected ActiveTls<TLS_NEWLIB> {
+public:
+    ActiveT(QP::QStateHandler const initial, Hsmn hsmn, char const *name) :
+        ActiveBase(initial, hsmn, name, m_hsmStor, m_evtQueueStor, EVT_QUEUE_COUNT, m_regStor, MAX_REGION_COUNT) {
+        // Set here rather than passed to ActiveBase since ActiveTls is constructed after ActiveBase.
+        m_tlsNewLib = this->GetTls();
+        m_hsm.SetRamSize(sizeof(ActiveT));
+    }
+
+protected:
+    HsmStor<DEFER_QUEUE_COUNT, REMINDER_QUEUE_COUNT, EVT_SEQ_COUNT> m_hsmStor;
     QP::QEvt const *m_evtQueueStor[EVT_QUEUE_COUNT];
-    struct _reent m_tlsNewLib;      // Thread-local-storage for NewLib.
+    RegionBase *m_regStor[MAX_REGION_COUNT];
 };
 
+typedef ActiveT<> Active;
+
 } // namespace FW
 
 
@@ -42,6 +42,7 @@
 #include "qpcpp.h"
 #include "fw_def.h"
 #include "fw_error.h"
+#include "fw_poolstat.h"
 
 #define EVT_CAST(e_)            static_cast<FW::Evt const &>(e_)
 #define ERROR_EVT_CAST(e_)      static_cast<FW::ErrorEvt const &>(e_)
@@ -55,7 +56,9 @@ public:
 
     // Constructor to create a dynamic event allocated from an event pool.
     Evt(QP::QSignal signal, Hsmn to = HSM_UNDEF, Hsmn from = HSM_UNDEF, Sequence seq = 0) :
-        QP::QEvt(signal), m_to(to), m_from(from), m_seq(seq) {}
+        QP::QEvt(signal), m_to(to), m_from(from), m_seq(seq) {
+        FW_POOL_STAT_CTOR(this);
+    }
     // Constructor to create a static event.
     Evt(QP::QSignal signal, Hsmn to, Hsmn from, Sequence seq, QP::QEvt::StaticEvt /*dummy*/) :
         QP::QEvt(signal, QP::QEvt::STATIC_EVT), m_to(to), m_from(from), m_seq(seq) {}
@@ -47,34 +47,30 @@
 
 namespace FW {
 
+// Event names of an event interface, i.e. the timer, internal and interface events of an HSMN.
+// It is defined in flash at namespace scope via DEFINE_EVT_NAME() and is immutable.
 class EvtSet {
 public:
-    EvtSet(EvtName timerEvtName = NULL, EvtCount timerEvtCount = 0,
-           EvtName internalEvtName = NULL, EvtCount internalEvtCount = 0,
-           EvtName interfaceEvtName = NULL, EvtCount interfaceEvtCount = 0) {
-        Init(timerEvtName, timerEvtCount, internalEvtName, internalEvtCount, interfaceEvtName, interfaceEvtCount);
-    }
-    void Init(EvtName timerEvtName, EvtCount timerEvtCount,
-              EvtName internalEvtName, EvtCount internalEvtCount,
-              EvtName interfaceEvtName, EvtCount interfaceEvtCount) {
+    enum {
+        TIMER_EVT_MAX = 1 << (EVT_TYPE_BIT_SIZE - 2),
+        INTERNAL_EVT_MAX = 1 << (EVT_TYPE_BIT_SIZE - 2),
+        INTERFACE_EVT_MAX = 1 << (EVT_TYPE_BIT_SIZE - 1),
+    };
+    // When used to initialize a constexpr object, a failed check (e.g. too many timer events overlapping
+    // the internal event range) is a compile-time error.
+    constexpr EvtSet(EvtName timerEvtName = NULL, EvtCount timerEvtCount = 0,
+                     EvtName internalEvtName = NULL, EvtCount internalEvtCount = 0,
+                     EvtName interfaceEvtName = NULL, EvtCount interfaceEvtCount = 0) :
+        m_timerEvtName(timerEvtName), m_timerEvtCount(timerEvtCount),
+        m_internalEvtName(internalEvtName), m_internalEvtCount(internalEvtCount),
+        m_interfaceEvtName(interfaceEvtName), m_interfaceEvtCount(interfaceEvtCount) {
         FW_EVT_SET_ASSERT(timerEvtCount == 0 || timerEvtName);
         FW_EVT_SET_ASSERT(internalEvtCount == 0 || internalEvtName);
         FW_EVT_SET_ASSERT(interfaceEvtCount == 0 || interfaceEvtName);
-        m_timerEvtName = timerEvtName;
-        m_timerEvtCount = timerEvtCount;
-        m_internalEvtName = internalEvtName;
-        m_internalEvtCount = internalEvtCount;
-        m_interfaceEvtName = interfaceEvtName;
-        m_interfaceEvtCount = interfaceEvtCount;
+        FW_EVT_SET_ASSERT(timerEvtCount <= TIMER_EVT_MAX);
+        FW_EVT_SET_ASSERT(internalEvtCount <= INTERNAL_EVT_MAX);
+        FW_EVT_SET_ASSERT(interfaceEvtCount <= INTERFACE_EVT_MAX);
     }
-
-    enum Category {
-        TIMER_EVT,
-        INTERNAL_EVT,
-        INTERFACE_EVT,
-        CATEGORY_COUNT
-    };
-    void Init(Category cat, EvtName evtName, EvtCount evtCount);
     char const *Get(QP::QSignal signal) const;
 
 protected:
@@ -86,6 +82,42 @@ protected:
     EvtCount m_interfaceEvtCount;
 };
 
+// Event sets of all event interfaces indexed by HSMN. The application builds it at compile time from its HSM
+// list so it is placed in flash and there is no registration at startup, e.g.
+//   #define ADD_HSM(hsmn_, count_) table.Add(hsmn_, &EVT_SET(hsmn_));
+//   static constexpr EvtSetTable MakeEvtSetTable() { EvtSetTable table; APP_HSM return table; }
+//   namespace FW { extern constexpr EvtSetTable evtSetTable = MakeEvtSetTable(); }
+// The weak default table in fw_evtSet.cpp is empty, in which case event names are shown as undefined.
+class EvtSetTable {
+public:
+    constexpr EvtSetTable() : m_evtSet{} {}
+    // A duplicate or out-of-range HSMN is a compile-time error in a constexpr context.
+    constexpr void Add(Hsmn hsmn, EvtSet const *evtSet) {
+        FW_EVT_SET_ASSERT(evtSet && (hsmn != HSM_UNDEF) && (hsmn < MAX_HSM_COUNT));
+        FW_EVT_SET_ASSERT(m_evtSet[hsmn] == NULL);
+        m_evtSet[hsmn] = evtSet;
+    }
+    EvtSet const *Get(Hsmn hsmn) const {
+        return (hsmn < MAX_HSM_COUNT) ? m_evtSet[hsmn] : NULL;
+    }
+
+protected:
+    EvtSet const *m_evtSet[MAX_HSM_COUNT];
+};
+
+extern EvtSetTable const evtSetTable;
+
+// Name of the event set object of an event interface.
+#define EVT_SET(evtHsmn_)           evtHsmn_##_EVT_SET
+
+// Defines the event set of an event interface from the arrays timerEvtName, internalEvtName and interfaceEvtName
+// in the source file of the HSM. To be used at namespace scope.
+#define DEFINE_EVT_NAME(evtHsmn_)   extern constexpr EvtSet EVT_SET(evtHsmn_)(timerEvtName, ARRAY_COUNT(timerEvtName), \
+                                        internalEvtName, ARRAY_COUNT(internalEvtName), \
+                                        interfaceEvtName, ARRAY_COUNT(interfaceEvtName))
+// For an HSM that does not own any events.
+#define DEFINE_NO_EVT_NAME(evtHsmn_)    extern constexpr EvtSet EVT_SET(evtHsmn_){}
+
 } // namespace FW
 
 #endif // FW_EVT_SET_H
@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_FORMAT_H
+#define FW_FORMAT_H
+
+#include <stdarg.h>
+#include <stdint.h>
+
+namespace FW {
+
+// Small allocation-free and reentrant replacement of snprintf()/vsnprintf() for the log path.
+// It does not use newlib (no struct _reent, no malloc) and keeps all state on the caller's stack.
+//
+// Supported: flags '-', '0', '+', ' ', '#'; width and precision (including '*'); length modifiers hh, h, l, ll,
+// z, j, t, L; conversions d, i, u, x, X, o, c, s, p, % and fixed-point f/F.
+// Floats are formatted with integer arithmetic only. Digits are exact to about 18 significant digits and those after
+// the 40th decimal place are zeros. Magnitudes of 2^64 or above are output as "inf".
+// Other conversions (e.g. n) are output literally. That includes e, E, g and G, whose argument is skipped.
+class Format {
+public:
+    // Same semantics as snprintf(): buf is always null-terminated if bufSize > 0. Returns the length of the full
+    // output (excluding null-termination), which may exceed bufSize - 1 if truncated.
+    static uint32_t Print(char *buf, uint32_t bufSize, char const *format, ...);
+    static uint32_t PrintV(char *buf, uint32_t bufSize, char const *format, va_list arg);
+};
+
+} // namespace FW
+
+#endif // FW_FORMAT_H
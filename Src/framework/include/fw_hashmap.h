@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_HASHMAP_H
+#define FW_HASHMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "fw_kv.h"
+#include "fw_assert.h"
+
+#define FW_HASHMAP_ASSERT(t_) ((t_) ? (void)0 : Q_onAssert("fw_hashmap.h", (int_t)__LINE__))
+
+namespace FW {
+
+// Default key hashes. Integral and pointer keys are mixed with a multiplicative (Fibonacci) hash, so that keys
+// sharing a pattern (e.g. all odd, or aligned addresses) still spread over the slots.
+// To use other key types, overload HashKey() in the namespace of the key type (see StrBuf).
+inline uint32_t HashMix(uint32_t k) {
+    return k * 2654435769U;
+}
+template <class Key>
+inline typename std::enable_if<std::is_integral<Key>::value || std::is_enum<Key>::value, uint32_t>::type
+HashKey(Key const &k) {
+    return HashMix(static_cast<uint32_t>(k));
+}
+template <class Type>
+inline uint32_t HashKey(Type * const &k) {
+    return HashMix(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(k)));
+}
+
+// Critical sections MUST be enforced externally by caller.
+// Same interface as Map (except Put()) with O(1) average lookup, insertion and removal.
+// It uses open addressing with linear probing on the storage array passed in. Entries are removed by shifting
+// subsequent entries in the same probe chain backward, so no tombstone is needed and lookups never degrade.
+// The used count is maintained rather than counted.
+//
+// Important - An entry may move to another index when another entry is removed. A pointer returned by GetByKey()
+// or GetByIndex() is only valid until the next removal. The key of a returned entry must not be modified.
+template <class Key, class Value>
+class HashMap {
+public:
+    HashMap(KeyValue<Key, Value> kv[], uint32_t count, KeyValue<Key, Value> const &unusedKv) :
+        m_kv(kv), m_count(count), m_usedCount(0), m_unusedKv(unusedKv) {
+        // m_kv and m_count valided in Reset().
+        Reset();
+    }
+    // Default constructor with m_kv and m_count set to null/0. It allows an array of HashMap objects
+    // to be initialized in its owner's constructor.
+    // A default constructed object is unusable until initialized.
+    HashMap(): m_kv(NULL), m_count(0), m_usedCount(0) {}
+    virtual ~HashMap() {}
+
+    // Init() can only be called once if a HashMap object is default constructed.
+    void Init(KeyValue<Key, Value> kv[], uint32_t count, KeyValue<Key, Value> const &unusedKv) {
+        FW_HASHMAP_ASSERT((m_kv == NULL) && (m_count == 0));
+        m_kv = kv;
+        m_count = count;
+        m_unusedKv = unusedKv;
+        // m_kv and m_count valided in Reset().
+        Reset();
+    }
+    void Reset() {
+        FW_HASHMAP_ASSERT(m_kv && m_count);
+        for (uint32_t i = 0; i < m_count; i++) {
+            m_kv[i] = m_unusedKv;
+        }
+        m_usedCount = 0;
+    }
+
+    KeyValue<Key, Value> *GetByIndex(uint32_t index) {
+        FW_HASHMAP_ASSERT(m_kv && (index < m_count));
+        return &m_kv[index];
+    }
+    void ClearByIndex(uint32_t index) {
+        FW_HASHMAP_ASSERT(m_kv && (index < m_count));
+        if (!IsUnused(index)) {
+            Remove(index);
+        }
+    }
+    // OK to pass unused key to find an empty slot.
+    // It returns "by-reference" instead of "by-value", and therefore a caller can modify the value of the returned entry.
+    KeyValue<Key, Value> *GetByKey(Key const &k) {
+        FW_HASHMAP_ASSERT(m_kv && m_count);
+        uint32_t index = GetHome(k);
+        for (uint32_t i = 0; i < m_count; i++) {
+            if (m_kv[index].GetKey() == k) {
+                return &m_kv[index];
+            }
+            // An empty slot ends the probe chain.
+            if (IsUnused(index)) {
+                return NULL;
+            }
+            index = GetNext(index);
+        }
+        return NULL;
+    }
+    bool ClearByKey(Key const &k) {
+        KeyValue<Key, Value> *kv = GetByKey(k);
+        if (kv && (k != m_unusedKv.GetKey())) {
+            Remove(kv - m_kv);
+            return true;
+        }
+        return false;
+    }
+    // Since there can be more that one keys that map to the same value,
+    // this function returns the first one found.
+    KeyValue<Key, Value> *GetFirstByValue(Value const &v) {
+        FW_HASHMAP_ASSERT(m_kv && m_count);
+        for (uint32_t i = 0; i < m_count; i++) {
+            if (!IsUnused(i) && (m_kv[i].GetValue() == v)) {
+                return &m_kv[i];
+            }
+        }
+        return NULL;
+    }
+    void Save(KeyValue<Key, Value> const &kv) {
+        FW_HASHMAP_ASSERT(m_kv && (m_usedCount < m_count) && (kv.GetKey() != m_unusedKv.GetKey()));
+        uint32_t index = GetHome(kv.GetKey());
+        while (!IsUnused(index)) {
+            index = GetNext(index);
+        }
+        m_kv[index] = kv;
+        m_usedCount++;
+    }
+
+    KeyValue<Key, Value> const &GetUnusedKv() const { return m_unusedKv; }
+    Key const &GetUnusedKey() const { return m_unusedKv.GetKey(); }
+
+    uint32_t GetUnusedCount() const { return m_count - m_usedCount; }
+    uint32_t GetUsedCount() const { return m_usedCount; }
+    uint32_t GetTotalCount() const { return m_count; }
+    bool IsFull() const { return m_usedCount == m_count; }
+    bool IsEmpty() const { return m_usedCount == 0; }
+
+protected:
+    // Maps the hash to [0, m_count) with a multiply rather than a modulo, using the well-mixed high bits.
+    uint32_t GetHome(Key const &k) const {
+        return static_cast<uint32_t>((static_cast<uint64_t>(HashKey(k)) * m_count) >> 32);
+    }
+    uint32_t GetNext(uint32_t index) const { return (index + 1 < m_count) ? (index + 1) : 0; }
+    bool IsUnused(uint32_t index) const { return m_kv[index].GetKey() == m_unusedKv.GetKey(); }
+    // Removes the used entry at index and shifts subsequent entries in the probe chain backward to fill the hole.
+    // An entry is shifted only if its home slot is not cyclically within (hole, its current slot].
+    void Remove(uint32_t hole) {
+        FW_HASHMAP_ASSERT(m_usedCount > 0);
+        uint32_t index = hole;
+        for (uint32_t i = 1; i < m_count; i++) {
+            index = GetNext(index);
+            if (IsUnused(index)) {
+                break;
+            }
+            uint32_t home = GetHome(m_kv[index].GetKey());
+            bool inPlace = (hole <= index) ? ((hole < home) && (home <= index)) : ((hole < home) || (home <= index));
+            if (!inPlace) {
+                m_kv[hole] = m_kv[index];
+                hole = index;
+            }
+        }
+        m_kv[hole] = m_unusedKv;
+        m_usedCount--;
+    }
+
+    KeyValue<Key, Value> *m_kv;
+    uint32_t m_count;
+    uint32_t m_usedCount;
+    KeyValue<Key, Value> m_unusedKv;
+
+    // Unimplemented to disallow built-in memberwise copy constructor and assignment operator.
+    HashMap(HashMap const &);
+    HashMap& operator= (HashMap const &);
+};
+
+} // namespace FW
+
+#endif // FW_HASHMAP_H
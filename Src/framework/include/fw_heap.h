@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_HEAP_H
+#define FW_HEAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "qpcpp.h"
+#include "bsp.h"
+#include "fw_def.h"
+
+// Uncomment the following to route malloc()/free() (including calls made within newlib and by the default
+// operator new/delete) to Heap::GetSys() instead of the newlib allocator, whose lock (__malloc_lock() in
+// bsp.cpp) disables interrupts. malloc() must then not be called from ISRs. realloc(), calloc(), memalign(),
+// aligned_alloc() and malloc_usable_size() are routed as well, so no caller reaches the newlib heap.
+//#define ENABLE_FW_HEAP_MALLOC
+
+// Size of the system arena used by malloc() when ENABLE_FW_HEAP_MALLOC is defined. It may be defined on the compiler
+// command line, up to Heap::MAX_ARENA_SIZE. The host build enlarges it since it also serves the C library there.
+#ifndef FW_HEAP_SYS_SIZE
+#define FW_HEAP_SYS_SIZE        (16 * 1024)
+#endif
+
+#define FW_HEAP_ASSERT(t_) ((t_) ? (void)0 : Q_onAssert("fw_heap.h", (int_t)__LINE__))
+
+namespace FW {
+
+// Two-level segregated fit (TLSF) allocator over a caller-provided memory region (arena). Alloc() and Free()
+// take constant time independent of the number of blocks. Free blocks are kept in lists by size class, located
+// via two levels of bitmaps. Adjacent free blocks are merged immediately. Each arena has its own lock (see
+// BspLock), so an arena can be dedicated to a group of threads with a lower priority ceiling.
+class Heap {
+public:
+    enum {
+        ALIGN = 8,                  // Alignment and granularity of allocated blocks.
+        MAX_ARENA_SIZE = 1 << 20,   // Supported arena size. Larger regions are truncated.
+        SYS_SIZE = FW_HEAP_SYS_SIZE,  // Size of the system arena used by malloc() (see ENABLE_FW_HEAP_MALLOC).
+    };
+
+    // stor must remain valid for the lifetime of the heap. ceiling is the highest priority of all threads
+    // using this heap (see BspLock).
+    Heap(char const *name, void *stor, size_t size, uint8_t ceiling = QF_MAX_ACTIVE);
+
+    // Returns NULL if there is no free block large enough, after counting the failure.
+    void *Alloc(size_t size);
+    void Free(void *ptr);
+    void *Realloc(void *ptr, size_t size);
+    // align must be a power of 2. Alignments up to ALIGN are served by Alloc(). Larger ones take a block with room
+    // for the alignment and return the leading gap to the free lists. Returns NULL on failure, after counting it.
+    void *AllocAligned(size_t align, size_t size);
+    void *Calloc(size_t count, size_t size);
+    // Returns the usable size of an allocated block, which is at least the requested size.
+    size_t GetSize(void const *ptr) const;
+
+    struct Stat {
+        uint32_t size;              // Total bytes available for allocation when empty.
+        uint32_t usedSize;          // Bytes in allocated blocks, excluding block headers.
+        uint32_t peakUsed;          // Peak usedSize since startup.
+        uint32_t freeSize;          // Bytes in free blocks, excluding block headers.
+        uint32_t largestFree;       // Size of the largest free block.
+        uint32_t freeBlockCount;
+        uint32_t allocCount;        // Since startup or ResetStat().
+        uint32_t failCount;         // Since startup or ResetStat().
+        // Percentage of free memory not in the largest free block.
+        uint32_t GetFragPercent() const { return freeSize ? (100 - (uint32_t)(100ULL * largestFree / freeSize)) : 0; }
+    };
+    // Walks the free lists. It takes time proportional to the number of free blocks.
+    void GetStat(Stat &stat);
+    void ResetStat();
+    char const *GetName() const { return m_name; }
+
+    // Heaps in order of construction, for reporting.
+    static Heap *GetFirst() { return m_first; }
+    Heap *GetNext() const { return m_next; }
+    // System arena used by malloc() when ENABLE_FW_HEAP_MALLOC is defined.
+    static Heap &GetSys();
+
+protected:
+    Heap(Heap const &) = delete;
+    Heap &operator=(Heap const &) = delete;
+
+    // Header of a physical block. nextFree and prevFree overlap the first bytes of the payload, so they are
+    // only valid when the block is free. prevPhys is only valid when the previous physical block is free.
+    struct Block {
+        Block *prevPhys;
+        size_t size;                // Payload size. The lowest 2 bits hold BLOCK_FREE and PREV_FREE.
+        Block *nextFree;
+        Block *prevFree;
+    };
+
+    enum {
+        BLOCK_FREE = 0x1,
+        PREV_FREE = 0x2,
+        HDR_SIZE = offsetof(Block, nextFree),
+        MIN_SIZE = sizeof(Block) - HDR_SIZE,
+        ALIGN_LOG2 = 3,
+        SL_LOG2 = 3,                // 8 second level lists per first level.
+        SL_COUNT = 1 << SL_LOG2,
+        FL_SHIFT = SL_LOG2 + ALIGN_LOG2,
+        SMALL_SIZE = 1 << FL_SHIFT, // Sizes below are linearly mapped to first level 0.
+        MAX_ARENA_LOG2 = 20,
+        FL_COUNT = MAX_ARENA_LOG2 - FL_SHIFT + 1,
+    };
+
+    static uint8_t *GetPayload(Block *b) { return reinterpret_cast<uint8_t *>(b) + HDR_SIZE; }
+    static Block *GetBlock(void const *ptr) {
+        return reinterpret_cast<Block *>(const_cast<uint8_t *>(static_cast<uint8_t const *>(ptr)) - HDR_SIZE);
+    }
+    static size_t GetSize(Block const *b) { return b->size & ~static_cast<size_t>(ALIGN - 1); }
+    static Block *GetNextPhys(Block *b) { return reinterpret_cast<Block *>(GetPayload(b) + GetSize(b)); }
+    static void Mapping(size_t size, uint32_t &fl, uint32_t &sl);
+    static size_t AdjustSize(size_t size);
+
+    void Insert(Block *b);
+    void Remove(Block *b);
+    Block *Find(size_t size);
+    Block *Split(Block *b, size_t size);
+    Block *MergeNext(Block *b);
+    void MarkUsed(Block *b);
+
+    char const *m_name;
+    BspLock m_lock;
+    uint32_t m_flBitmap;
+    uint8_t m_slBitmap[FL_COUNT];
+    Block *m_free[FL_COUNT][SL_COUNT];
+    uint32_t m_size;
+    uint32_t m_usedSize;
+    uint32_t m_peakUsed;
+    uint32_t m_allocCount;
+    uint32_t m_failCount;
+    Heap *m_next;
+
+    static Heap *m_first;
+};
+
+} // namespace FW
+
+#endif // FW_HEAP_H
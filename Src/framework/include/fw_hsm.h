@@ -58,21 +58,55 @@
 
 namespace FW {
 
-class Active;
-class Region;
+class ActiveBase;
+class RegionBase;
 
 typedef KeyValue<Hsmn, Sequence> HsmnSeq;
 typedef Map<Hsmn, Sequence> HsmnSeqMap;
 
+// Storage of the queues and built-in event sequence record of an Hsm. It is owned by the container of the Hsm
+// (see ActiveT and RegionT) so the capacities can be set per object. The defaults are the capacities used before
+// they became configurable.
+template <uint16_t DEFER_QUEUE_COUNT = 16, uint8_t REMINDER_QUEUE_COUNT = 4, size_t EVT_SEQ_COUNT = 16>
+class HsmStor {
+public:
+    HsmStor() : m_evtSeq(HSM_UNDEF) {}
+    QP::QEvt const *m_deferQueueStor[DEFER_QUEUE_COUNT];
+    QP::QEvt const *m_reminderQueueStor[REMINDER_QUEUE_COUNT];
+    SeqRec<Hsmn, EVT_SEQ_COUNT> m_evtSeq;
+};
+
 class Hsm {
 public:
-    Hsm(Hsmn hsmn, char const *name, QP::QHsm *qhsm);
+    // Only references to stor are saved. It may be constructed after this object.
+    template <uint16_t DEFER_QUEUE_COUNT, uint8_t REMINDER_QUEUE_COUNT, size_t EVT_SEQ_COUNT>
+    Hsm(Hsmn hsmn, char const *name, QP::QHsm *qhsm, HsmStor<DEFER_QUEUE_COUNT, REMINDER_QUEUE_COUNT, EVT_SEQ_COUNT> &stor) :
+        Hsm(hsmn, name, qhsm, stor.m_deferQueueStor, DEFER_QUEUE_COUNT, stor.m_reminderQueueStor, REMINDER_QUEUE_COUNT,
+            stor.m_evtSeq) {}
+    Hsm(Hsmn hsmn, char const *name, QP::QHsm *qhsm, QP::QEvt const *deferQueueStor[], uint16_t deferQueueCount,
+        QP::QEvt const *reminderQueueStor[], uint8_t reminderQueueCount, EvtSeqRecBase &evtSeq);
     void Init(QP::QActive *container);
 
     Hsmn GetHsmn() const { return m_hsmn; }
     char const *GetName() const { return m_name; }
+    QP::QHsm *GetQHsm() const { return m_qhsm; }
     char const *GetState() const { return m_state; }
     void SetState(char const *s) { m_state = s; }
+    // Number of events dispatched to this HSM from its container, excluding reminder events.
+    uint32_t GetDispatchCount() const { return m_dispatchCount; }
+    void ResetDispatchCount() { m_dispatchCount = 0; }
+    // Framework RAM footprint of the object containing this Hsm (see ActiveT and RegionT), excluding members
+    // added by application classes. 0 if not set.
+    uint32_t GetRamSize() const { return m_ramSize; }
+    void SetRamSize(uint32_t size) { m_ramSize = static_cast<uint16_t>(size); }
+    uint16_t GetDeferQueueCount() const { return m_deferQueueCount; }
+    uint8_t GetReminderQueueCount() const { return m_reminderQueueCount; }
+    uint32_t GetEvtSeqCount() const { return m_evtSeq.GetTotalCount(); }
+
+    // Record of events posted to this HSM via Fw::PostNotInQ() that have not been dispatched yet.
+    // Called by Fw::PostNotInQ() within critical section.
+    bool IsPendingNoCrit(Evt const *e) const;
+    bool AddPendingNoCrit(Evt const *e);
 
     Sequence GenSeq() { return m_nextSequence++; }
     bool Defer(QP::QEvt const *e) { return m_deferEQueue.Defer(e); }
@@ -128,13 +162,13 @@ public:
         SendNotInQ(e);
     }
 
-    void SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRec &seqRec);
-    void SendInd(Evt *e, Hsmn to, bool reset, EvtSeqRec &seqRec) { SendReq(e, to, reset, seqRec); }
+    void SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRecBase &seqRec);
+    void SendInd(Evt *e, Hsmn to, bool reset, EvtSeqRecBase &seqRec) { SendReq(e, to, reset, seqRec); }
     // Using built-in event sequence record.
     void SendReq(Evt *e, Hsmn to, bool reset) { SendReq(e, to, reset, m_evtSeq); }
     void SendInd(Evt *e, Hsmn to, bool reset) { SendReq(e, to, reset); }
-    bool CheckCfm(ErrorEvt const &e, bool &allReceived, EvtSeqRec &seqRec);
-    bool CheckRsp(ErrorEvt const &e, bool &allReceived, EvtSeqRec &seqRec) { return CheckCfm(e, allReceived, seqRec); }
+    bool CheckCfm(ErrorEvt const &e, bool &allReceived, EvtSeqRecBase &seqRec);
+    bool CheckRsp(ErrorEvt const &e, bool &allReceived, EvtSeqRecBase &seqRec) { return CheckCfm(e, allReceived, seqRec); }
     bool CheckCfm(ErrorEvt const &e, bool &allReceived) { return CheckCfm(e, allReceived, m_evtSeq); }
     bool CheckRsp(ErrorEvt const &e, bool &allReceived) { return CheckCfm(e, allReceived); }
 
@@ -167,26 +201,41 @@ public:
 
 protected:
     enum {
-        DEFER_QUEUE_COUNT = 16,
-        REMINDER_QUEUE_COUNT = 4
+        PENDING_COUNT = 4
     };
 
     // Called by Active::dispatch() and Region::dispatch().
     void DispatchReminder();
+    // Called by Active::dispatch() and Region::dispatch() before e is dispatched.
+    void OnDispatch(QP::QEvt const *e) {
+        m_dispatchCount++;
+        // An event cannot be pending if no event was pending when it is dispatched, since it was
+        // added to m_pending before being posted.
+        if (m_pendingCount) {
+            ClearPending(e);
+        }
+    }
+    void ClearPending(QP::QEvt const *e);
 
     Hsmn m_hsmn;
     char const * m_name;
     QP::QHsm *m_qhsm;
     char const *m_state;
     Sequence m_nextSequence;
+    uint32_t m_dispatchCount;
+    Evt const *m_pending[PENDING_COUNT];    // Events posted via Fw::PostNotInQ() still in event queue.
+    uint8_t volatile m_pendingCount;
+    uint8_t m_reminderQueueCount;
+    uint16_t m_deferQueueCount;
+    uint16_t m_ramSize;
     DeferEQueue m_deferEQueue;
     QP::QEQueue m_reminderQueue;
-    EvtSeqRec m_evtSeq;         // Built-in record of sequence numbers of outgoing events. Application classes may add custom ones when needed.
-    QP::QEvt const *m_deferQueueStor[DEFER_QUEUE_COUNT];
-    QP::QEvt const *m_reminderQueueStor[REMINDER_QUEUE_COUNT];
+    EvtSeqRecBase &m_evtSeq;    // Built-in record of sequence numbers of outgoing events. Application classes may add custom ones when needed.
+    QP::QEvt const **m_deferQueueStor;
+    QP::QEvt const **m_reminderQueueStor;
 
-    friend class Active;        // For calling DispatchReminder().
-    friend class Region;        // For calling DispatchReminder().
+    friend class ActiveBase;    // For calling DispatchReminder() and OnDispatch().
+    friend class RegionBase;    // For calling DispatchReminder() and OnDispatch().
 };
 
 } // namespace FW
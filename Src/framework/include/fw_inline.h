@@ -53,11 +53,11 @@
 #define QF_EVT_CONST_CAST_(e_) const_cast<QEvt *>(e_)
 namespace QP {
 //! access to the poolId_ of an event @p e
-inline uint8_t QF_EVT_POOL_ID_(QEvt const * const e) { return e->poolId_; }
+inline uint8_t QF_EVT_POOL_ID_(QEvt const * const e) noexcept { return e->poolId_; }
 //! access to the refCtr_ of an event @p e
-inline uint8_t QF_EVT_REF_CTR_(QEvt const * const e) { return e->refCtr_; }
+inline uint8_t QF_EVT_REF_CTR_(QEvt const * const e) noexcept { return e->refCtr_; }
 //! decrement the refCtr_ of an event @p e
-inline void QF_EVT_REF_CTR_DEC_(QEvt const * const e) {
+inline void QF_EVT_REF_CTR_DEC_(QEvt const * const e) noexcept {
     --(QF_EVT_CONST_CAST_(e))->refCtr_;
 }
 } // namespace QP
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_LATENCY_H
+#define FW_LATENCY_H
+
+#include <stdint.h>
+
+// Uncomment the following to timestamp events on post and record post-to-dispatch latency per active object.
+// See Fw::StampPost(). When it is commented out, FW_LAT_POST(), FW_LAT_CLEAR() and FW_LAT_DISPATCH() in fw.h
+// expand to nothing.
+//#define ENABLE_FW_LATENCY
+
+namespace FW {
+
+// Log2 histogram of latencies in cycles (see GetCycleCount()).
+// Bin i counts latencies in [2^i, 2^(i+1)). Bin 0 also counts 0 and the last bin counts all above its range.
+class LatencyHist {
+public:
+    enum {
+        BIN_COUNT = 24
+    };
+    LatencyHist() { Reset(); }
+    void Reset() {
+        for (uint32_t i = 0; i < BIN_COUNT; i++) {
+            m_bin[i] = 0;
+        }
+        m_count = 0;
+        m_total = 0;
+        m_max = 0;
+    }
+    void Add(uint32_t cycles) {
+        uint32_t bin = cycles ? (31 - __builtin_clz(cycles)) : 0;
+        if (bin >= BIN_COUNT) {
+            bin = BIN_COUNT - 1;
+        }
+        m_bin[bin]++;
+        m_count++;
+        m_total += cycles;
+        if (cycles > m_max) {
+            m_max = cycles;
+        }
+    }
+    uint32_t GetBin(uint32_t i) const { return (i < BIN_COUNT) ? m_bin[i] : 0; }
+    uint32_t GetCount() const { return m_count; }
+    uint32_t GetAvg() const { return m_count ? static_cast<uint32_t>(m_total / m_count) : 0; }
+    uint32_t GetMax() const { return m_max; }
+    // Returns the upper bound (exclusive) of the bin containing the given percentile, or 0 if empty.
+    uint32_t GetPercentile(uint32_t percent) const {
+        uint64_t target = (static_cast<uint64_t>(m_count) * percent + 99) / 100;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < BIN_COUNT; i++) {
+            sum += m_bin[i];
+            if (sum && (sum >= target)) {
+                return (i < BIN_COUNT - 1) ? (2U << i) : m_max;
+            }
+        }
+        return 0;
+    }
+
+protected:
+    uint32_t m_bin[BIN_COUNT];
+    uint32_t m_count;
+    uint64_t m_total;
+    uint32_t m_max;
+};
+
+} // namespace FW
+
+#endif // FW_LATENCY_H
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_LFPOOL_H
+#define FW_LFPOOL_H
+
+#include <atomic>
+#include "fw_def.h"
+
+namespace FW {
+
+// Lock-free pool of fixed-size blocks, for allocation from ISRs as well as threads without a critical section.
+// The free list is a stack updated by compare-and-swap of its head. The head holds the index of the first free
+// block in the lower 16 bits and a tag in the upper 16 bits. The tag is incremented on every update, so a pop that
+// was preempted by other pops and pushes fails its compare-and-swap even if the same block is on top again (ABA).
+// The index of the next free block is stored in the first bytes of a free block.
+class LfPool {
+public:
+    LfPool() : m_stor(NULL), m_blockSize(0), m_blockCount(0), m_head(NIL), m_freeCount(0), m_minFree(0),
+        m_allocCount(0), m_failCount(0) {}
+    // Not thread-safe. To be called during system initialization.
+    // blockSize must be a multiple of 4 and blockCount less than 0xFFFF.
+    void Init(void *stor, uint32_t blockSize, uint32_t blockCount);
+
+    // Returns NULL if the pool is empty, after counting the failure.
+    void *Get();
+    void Put(void *block);
+    bool Contains(void const *p) const {
+        uint8_t const *b = static_cast<uint8_t const *>(p);
+        return (b >= m_stor) && (b < (m_stor + m_blockSize * m_blockCount));
+    }
+
+    uint32_t GetBlockSize() const { return m_blockSize; }
+    uint32_t GetBlockCount() const { return m_blockCount; }
+    uint32_t GetFreeCount() const { return m_freeCount.load(std::memory_order_relaxed); }
+    uint32_t GetMinFree() const { return m_minFree.load(std::memory_order_relaxed); }
+    uint32_t GetAllocCount() const { return m_allocCount.load(std::memory_order_relaxed); }
+    uint32_t GetFailCount() const { return m_failCount.load(std::memory_order_relaxed); }
+    void ResetCount() {
+        m_allocCount.store(0, std::memory_order_relaxed);
+        m_failCount.store(0, std::memory_order_relaxed);
+    }
+
+protected:
+    enum {
+        NIL = 0xFFFF,
+        INDEX_MASK = 0xFFFF,
+        TAG_INC = 0x10000,
+    };
+
+    uint16_t volatile &Next(uint32_t index) {
+        return *reinterpret_cast<uint16_t volatile *>(m_stor + index * m_blockSize);
+    }
+
+    uint8_t *m_stor;
+    uint32_t m_blockSize;
+    uint32_t m_blockCount;
+    std::atomic<uint32_t> m_head;
+    std::atomic<uint32_t> m_freeCount;
+    std::atomic<uint32_t> m_minFree;    // Since startup.
+    std::atomic<uint32_t> m_allocCount; // Since startup or ResetCount().
+    std::atomic<uint32_t> m_failCount;  // Since startup or ResetCount().
+
+    LfPool(LfPool const &) = delete;
+    LfPool &operator=(LfPool const &) = delete;
+};
+
+} // namespace FW
+
+#endif // FW_LFPOOL_H
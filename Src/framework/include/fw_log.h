@@ -39,9 +39,10 @@
 #ifndef FW_LOG_H
 #define FW_LOG_H
 
+#include <stdarg.h>
 #include "fw_def.h"
 #include "fw_error.h"
-#include "fw_map.h"
+#include "fw_hashmap.h"
 #include "fw_pipe.h"
 #include "fw_bitset.h"
 #include "fw_evtSet.h"
@@ -49,32 +50,85 @@
 
 #define FW_LOG_ASSERT(t_) ((t_) ? (void)0 : Q_onAssert("fw_log.h", (int_t)__LINE__))
 
+// Uncomment the following to enable deferred logging. When a drain HSM is set (see Log::SetDrain()),
+// Debug(), Event() and ErrorEvent() store a compact binary record (timestamp, hsmn, type, format string
+// pointer and raw arguments) into a ring buffer instead of formatting text in the caller's context.
+// Records are formatted later by the drain HSM, usually the lowest priority active object, via Log::Drain().
+// Output differs from immediate logging in that string arguments (%s) are cut to DEFER_STR_LEN - 1 characters and
+// arguments beyond DEFER_REC_LEN are dropped.
+//#define ENABLE_LOG_DEFER
+
+// Uncomment the following to enable batched log output. When a drain HSM is set (see Log::SetDrain()), output to the
+// default interfaces is appended to a staging ring buffer instead of to each interface FIFO. The drain HSM moves it
+// into the interface FIFOs via Log::Flush() once per batch interval or when a threshold is reached, so each interface
+// is notified once per batch rather than once per write.
+//#define ENABLE_LOG_BATCH
+
+#if defined(ENABLE_LOG_DEFER) || defined(ENABLE_LOG_BATCH)
+#define ENABLE_LOG_DRAIN
+#endif
+
 namespace FW {
 
-#define SET_EVT_NAME(evtHsmn_)   Log::SetEvtName(evtHsmn_, timerEvtName, ARRAY_COUNT(timerEvtName), \
-                                                 internalEvtName, ARRAY_COUNT(internalEvtName), \
-                                                 interfaceEvtName, ARRAY_COUNT(interfaceEvtName))
-#define SET_TIMER_EVT_NAME(evtHsmn_)        Log::SetEvtName(evtHsmn_, EvtSet::TIMER_EVT, timerEvtName, ARRAY_COUNT(timerEvtName))
-#define SET_INTERNAL_EVT_NAME(evtHsmn_)     Log::SetEvtName(evtHsmn_, EvtSet::INTERNAL_EVT, internalEvtName, ARRAY_COUNT(internalEvtName))
-#define SET_INTERFACE_EVT_NAME(evtHsmn_)    Log::SetEvtName(evtHsmn_, EvtSet::INTERFACE_EVT, interfaceEvtName, ARRAY_COUNT(interfaceEvtName))
+// Compile-time log level of a translation unit, with the same meaning as the runtime verbosity (see Log::SetVerbosity()).
+// Macros for types at or above the level expand to nothing, so their arguments are not evaluated. To set it for a file,
+// define it before the first (direct or indirect) inclusion of this header, e.g. "#define FW_LOG_LEVEL 3" to keep
+// ERROR, WARNING and CRITICAL only. EVENT still records the current state of an HSM when it is compiled out.
+#ifndef FW_LOG_LEVEL
+#define FW_LOG_LEVEL            5
+#endif
 
 #define PRINT(format_, ...)      Log::Print(HSM_UNDEF, format_, ## __VA_ARGS__)
-// The following macros can only be used within an HSM. Newline is automatically appended.
-#define EVENT(e_)                Log::Event(Log::TYPE_LOG, me->GetHsmn(), e_, __FUNCTION__);
-#define ERROR_EVENT(e_)          Log::ErrorEvent(Log::TYPE_LOG, me->GetHsmn(), e_, __FUNCTION__);
-#define INFO(format_, ...)       Log::Debug(Log::TYPE_INFO, me->GetHsmn(), format_, ## __VA_ARGS__)
-#define LOG(format_, ...)        Log::Debug(Log::TYPE_LOG, me->GetHsmn(), format_, ## __VA_ARGS__)
-#define CRITICAL(format_, ...)   Log::Debug(Log::TYPE_CRITICAL, me->GetHsmn(), format_, ## __VA_ARGS__)
-#define WARNING(format_, ...)    Log::Debug(Log::TYPE_WARNING, me->GetHsmn(), format_, ## __VA_ARGS__)
-#define ERROR(format_, ...)      Log::Debug(Log::TYPE_ERROR, me->GetHsmn(), format_, ## __VA_ARGS__)
-
 #define PRINT_BUF(buf_, len_, unit_, label_)    Log::PrintBuf(HSM_UNDEF, buf_, len_, unit_, label_)
+
 // The following macros can only be used within an HSM. Newline is automatically appended.
-#define INFO_BUF(buf_, len_, unit_, label_)     Log::DebugBuf(Log::TYPE_INFO, me->GetHsmn(), buf_, len_, unit_, label_)
-#define LOG_BUF(buf_, len_, unit_, label_)      Log::DebugBuf(Log::TYPE_LOG, me->GetHsmn(), buf_, len_, unit_, label_)
-#define CRITICAL_BUF(buf_, len_, unit_, label_) Log::DebugBuf(Log::TYPE_CRITICAL, me->GetHsmn(), buf_, len_, unit_, label_)
-#define WARNING_BUF(buf_, len_, unit_, label_)  Log::DebugBuf(Log::TYPE_WARNING, me->GetHsmn(), buf_, len_, unit_, label_)
-#define ERROR_BUF(buf_, len_, unit_, label_)    Log::DebugBuf(Log::TYPE_ERROR, me->GetHsmn(), buf_, len_, unit_, label_)
+// The runtime verbosity and per-HSM checks are done inline before calling into Log.
+#define LOG_IF(type_, call_)     (Log::IsOutput(type_, me->GetHsmn()) ? (call_) : (void)0)
+
+#if FW_LOG_LEVEL > 3
+#define EVENT(e_)                ((((e_)->sig == QP::QHsm::Q_ENTRY_SIG) || Log::IsOutput(Log::TYPE_LOG, me->GetHsmn())) ? \
+                                  Log::Event(Log::TYPE_LOG, me->GetHsmn(), e_, __FUNCTION__) : (void)0);
+#define ERROR_EVENT(e_)          LOG_IF(Log::TYPE_LOG, Log::ErrorEvent(Log::TYPE_LOG, me->GetHsmn(), e_, __FUNCTION__));
+#define LOG(format_, ...)        LOG_IF(Log::TYPE_LOG, Log::Debug(Log::TYPE_LOG, me->GetHsmn(), format_, ## __VA_ARGS__))
+#define LOG_BUF(buf_, len_, unit_, label_)      LOG_IF(Log::TYPE_LOG, Log::DebugBuf(Log::TYPE_LOG, me->GetHsmn(), buf_, len_, unit_, label_))
+#else
+#define EVENT(e_)                (((e_)->sig == QP::QHsm::Q_ENTRY_SIG) ? Log::SetState(me->GetHsmn(), __FUNCTION__) : (void)0);
+#define ERROR_EVENT(e_)          ((void)0);
+#define LOG(format_, ...)        ((void)0)
+#define LOG_BUF(buf_, len_, unit_, label_)      ((void)0)
+#endif
+
+#if FW_LOG_LEVEL > 4
+#define INFO(format_, ...)       LOG_IF(Log::TYPE_INFO, Log::Debug(Log::TYPE_INFO, me->GetHsmn(), format_, ## __VA_ARGS__))
+#define INFO_BUF(buf_, len_, unit_, label_)     LOG_IF(Log::TYPE_INFO, Log::DebugBuf(Log::TYPE_INFO, me->GetHsmn(), buf_, len_, unit_, label_))
+#else
+#define INFO(format_, ...)       ((void)0)
+#define INFO_BUF(buf_, len_, unit_, label_)     ((void)0)
+#endif
+
+#if FW_LOG_LEVEL > 2
+#define CRITICAL(format_, ...)   LOG_IF(Log::TYPE_CRITICAL, Log::Debug(Log::TYPE_CRITICAL, me->GetHsmn(), format_, ## __VA_ARGS__))
+#define CRITICAL_BUF(buf_, len_, unit_, label_) LOG_IF(Log::TYPE_CRITICAL, Log::DebugBuf(Log::TYPE_CRITICAL, me->GetHsmn(), buf_, len_, unit_, label_))
+#else
+#define CRITICAL(format_, ...)   ((void)0)
+#define CRITICAL_BUF(buf_, len_, unit_, label_) ((void)0)
+#endif
+
+#if FW_LOG_LEVEL > 1
+#define WARNING(format_, ...)    LOG_IF(Log::TYPE_WARNING, Log::Debug(Log::TYPE_WARNING, me->GetHsmn(), format_, ## __VA_ARGS__))
+#define WARNING_BUF(buf_, len_, unit_, label_)  LOG_IF(Log::TYPE_WARNING, Log::DebugBuf(Log::TYPE_WARNING, me->GetHsmn(), buf_, len_, unit_, label_))
+#else
+#define WARNING(format_, ...)    ((void)0)
+#define WARNING_BUF(buf_, len_, unit_, label_)  ((void)0)
+#endif
+
+#if FW_LOG_LEVEL > 0
+#define ERROR(format_, ...)      LOG_IF(Log::TYPE_ERROR, Log::Debug(Log::TYPE_ERROR, me->GetHsmn(), format_, ## __VA_ARGS__))
+#define ERROR_BUF(buf_, len_, unit_, label_)    LOG_IF(Log::TYPE_ERROR, Log::DebugBuf(Log::TYPE_ERROR, me->GetHsmn(), buf_, len_, unit_, label_))
+#else
+#define ERROR(format_, ...)      ((void)0)
+#define ERROR_BUF(buf_, len_, unit_, label_)    ((void)0)
+#endif
 
 class Log {
 public:
@@ -105,11 +159,7 @@ public:
         BYTE_PER_LINE = 16
     };
 
-    // Set event names for an HSM.
-    static void SetEvtName(Hsmn evtHsmn, EvtName timerEvtName, EvtCount timerEvtCount,
-                           EvtName internalEvtName, EvtCount internalEvtCount,
-                           EvtName interfaceEvtName, EvtCount interfaceEvtCount);
-    static void SetEvtName(Hsmn evtHsmn, EvtSet::Category cat, EvtName evtName, EvtCount evtCount);
+    // Event names are defined at compile time (see DEFINE_EVT_NAME() and EvtSetTable in fw_evtSet.h).
     static char const *GetEvtName(QP::QSignal signal);
     static char const *GetBuiltinEvtName(QP::QSignal signal);
     static char const *GetUndefName() { return m_undefName; }
@@ -144,16 +194,58 @@ public:
     static void OnAll();
     static void OffAll();
     static bool IsOn(Hsmn hsmn) { return m_on.IsSet(hsmn); }
+    // Same as (type < GetVerbosity()) && IsOn(hsmn), reading m_onStor directly so that it is fully inlined.
+    static bool IsOutput(Type type, Hsmn hsmn) {
+        return (type < m_verbosity) && (hsmn < MAX_HSM_COUNT) && (m_onStor[hsmn / 32] & BIT_MASK_AT(hsmn % 32));
+    }
 
     static char const *GetHsmName(Hsmn hsmn);
     static char const *GetTypeName(Type type);
     static char const *GetState(Hsmn hsmn);
-private:
-    // EvtSetStor is a pointer to an array of EvtSet with MAX_HSM_COUNT elements.
-    typedef EvtSet (*EvtSetStor)[MAX_HSM_COUNT];
-    static EvtSetStor GetEvtSetStor();
-    static bool IsOutput(Type type, Hsmn hsmn);
+    // Records the current state of an HSM. It is done by Event() upon the entry signal.
+    static void SetState(Hsmn hsmn, char const *state);
+
+    // Number of writes to the default interface infHsmn discarded because its FIFO was full.
+    static uint32_t GetTruncCount(Hsmn infHsmn);
+    // Clears all truncation and drop counts.
+    static void ResetTruncCount();
+
+#ifdef ENABLE_LOG_DRAIN
+    // Signal sig is posted to drainHsmn when deferred records or batched output become pending.
+    // Pass HSM_UNDEF to disable them, which writes out all pending records and output immediately.
+    static void SetDrain(Hsmn drainHsmn, QP::QSignal sig);
+#endif
 
+#ifdef ENABLE_LOG_DEFER
+    enum {
+        DEFER_BUF_ORDER = 12,   // Ring buffer size = 2^12 = 4096 bytes.
+        DEFER_REC_LEN = 128,    // Max record length in bytes. Arguments beyond it are dropped.
+        DEFER_STR_LEN = 32,     // Max length of a string argument (%s) copied into a record.
+    };
+    // The drain HSM calls Drain() until IsDeferEmpty() returns true.
+    // Formats and writes the oldest pending record. Returns false if there is none.
+    static bool Drain();
+    static bool IsDeferEmpty() { return m_deferFifo.GetUsedCount() == 0; }
+    // Number of records discarded because the ring buffer was full.
+    static uint32_t GetDeferDropCount() { return m_deferDropCount; }
+#endif
+
+#ifdef ENABLE_LOG_BATCH
+    enum {
+        BATCH_BUF_ORDER = 11,   // Staging buffer size = 2^11 = 2048 bytes.
+        BATCH_THRESHOLD = 1024, // Staged byte count above which the drain HSM is notified to flush immediately.
+    };
+    // Moves all staged output into the default interface FIFOs. Each interface takes what fits in its own FIFO and
+    // the rest is counted in its truncation count. Returns true if the staging buffer is empty afterward.
+    static bool Flush();
+    static bool IsBatchEmpty() { return m_batchFifo.GetUsedCount() == 0; }
+    static bool IsBatchReady() { return m_batchFifo.GetUsedCount() >= BATCH_THRESHOLD; }
+    static uint32_t GetBatchAvailCount() { return m_batchFifo.GetAvailCount(); }
+    // Number of writes discarded because the staging buffer was full.
+    static uint32_t GetBatchDropCount() { return m_batchDropCount; }
+#endif
+
+private:
     class Inf {
     public:
         Inf(Fifo *fifo = NULL, QP::QSignal sig = 0, bool isDefault = false) :
@@ -170,7 +262,7 @@ private:
     };
 
     typedef KeyValue<Hsmn, Inf> HsmnInf;
-    typedef Map<Hsmn, Inf> HsmnInfMap;
+    typedef HashMap<Hsmn, Inf> HsmnInfMap;
 
     static uint8_t m_verbosity;
     static uint32_t m_onStor[ROUND_UP_DIV(MAX_HSM_COUNT, 32)];
@@ -182,6 +274,55 @@ private:
     static QP::QSignal const m_entrySig;
     static char const * const m_builtinEvtName[];
     static char const m_undefName[];
+    static uint32_t m_truncCount[MAX_HSM_COUNT];
+
+#ifdef ENABLE_LOG_DRAIN
+    static bool IsDrainOn() { return m_drainHsmn != HSM_UNDEF; }
+    static Hsmn m_drainHsmn;
+    static QP::QSignal m_drainSig;
+#endif
+
+#ifdef ENABLE_LOG_DEFER
+    enum DeferKind {
+        DEFER_DEBUG,
+        DEFER_EVENT,
+        DEFER_ERROR_EVENT,
+    };
+    // Record header. It is copied byte-wise so it need not be aligned in the ring buffer.
+    struct DeferHdr {
+        uint16_t len;           // Total length in bytes including header.
+        uint8_t kind;           // DeferKind.
+        uint8_t type;           // Type.
+        Hsmn hsmn;
+        uint32_t time;          // GetSystemMs() when logged.
+        char const *str;        // Format string (DEFER_DEBUG) or function name (DEFER_EVENT, DEFER_ERROR_EVENT).
+    };
+    // Body of DEFER_EVENT and DEFER_ERROR_EVENT records.
+    struct DeferEvt {
+        QP::QSignal sig;
+        bool hasFrom;           // True if e is an Evt (not a timer or built-in event).
+        Hsmn from;
+        Sequence seq;
+        Error error;
+        Hsmn origin;
+        Reason reason;
+    };
+    static void DeferWrite(uint8_t const *rec, uint32_t len);
+    static void DeferDebug(Type type, Hsmn hsmn, char const *format, va_list arg);
+    static uint32_t FormatDebug(char *buf, uint32_t bufLen, char const *format, uint8_t const *arg, uint32_t argLen);
+
+    static uint8_t m_deferStor[1 << DEFER_BUF_ORDER];
+    static Fifo m_deferFifo;
+    static uint32_t m_deferDropCount;
+#endif
+
+#ifdef ENABLE_LOG_BATCH
+    static void BatchWrite(char const *buf, uint32_t len);
+
+    static uint8_t m_batchStor[1 << BATCH_BUF_ORDER];
+    static Fifo m_batchFifo;
+    static uint32_t m_batchDropCount;
+#endif
 };
 
 } // namespace FW
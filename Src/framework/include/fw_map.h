@@ -48,6 +48,8 @@
 namespace FW {
 
 // Critical sections MUST be enforced externally by caller.
+// Lookups are linear. Entries stay at the indices they are saved or put to.
+// For maps looked up by key on hot paths, see HashMap in fw_hashmap.h.
 template <class Key, class Value>
 class Map {
 public:
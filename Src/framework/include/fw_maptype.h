@@ -42,19 +42,61 @@
 #include "qpcpp.h"
 #include "fw_def.h"
 #include "fw_map.h"
+#include "fw_assert.h"
+
+#define FW_MAPTYPE_ASSERT(t_) ((t_) ? (void)0 : Q_onAssert("fw_maptype.h", (int_t)__LINE__))
 
 namespace FW {
 
-class Region;
+class RegionBase;
 class Hsm;
 
 // Common map types used by the framework.
-typedef KeyValue<Hsmn, Region *> HsmnReg;
-typedef Map<Hsmn, Region *> HsmnRegMap;
-
 typedef KeyValue<Hsm *, QP::QActive *> HsmAct;
 typedef Map<Hsm *, QP::QActive *> HsmActMap;
 
+// Critical sections MUST be enforced externally by caller.
+// Direct-indexed table from hsmn to the regions of a container (active object or extended thread).
+// It is looked up for every event dispatched to a region, so the lookup is a single array access.
+// The table of 8-bit indices keeps the RAM cost to MAX_HSM_COUNT bytes per container.
+// The region pointers are stored in regStor, which is owned by the container to size it per container.
+class HsmnRegTable {
+public:
+    // Only a reference to regStor is saved. It may be constructed after this object.
+    HsmnRegTable(RegionBase *regStor[], uint32_t regCount) : m_reg(regStor), m_regCount(regCount), m_count(0) {
+        FW_MAPTYPE_ASSERT(regStor && (regCount < UNUSED));
+        for (uint32_t i = 0; i < MAX_HSM_COUNT; i++) {
+            m_index[i] = UNUSED;
+        }
+    }
+    // Regions are only added during system initialization. There is no Remove().
+    void Add(Hsmn hsmn, RegionBase *reg) {
+        FW_MAPTYPE_ASSERT((hsmn != HSM_UNDEF) && (hsmn < MAX_HSM_COUNT) && reg);
+        FW_MAPTYPE_ASSERT((m_index[hsmn] == UNUSED) && (m_count < m_regCount));
+        m_reg[m_count] = reg;
+        m_index[hsmn] = m_count++;
+    }
+    // Returns NULL if hsmn has not been added.
+    RegionBase *Get(Hsmn hsmn) const {
+        if (hsmn >= MAX_HSM_COUNT) {
+            return NULL;
+        }
+        uint8_t index = m_index[hsmn];
+        return (index == UNUSED) ? NULL : m_reg[index];
+    }
+    uint32_t GetCount() const { return m_count; }
+    uint32_t GetTotalCount() const { return m_regCount; }
+
+protected:
+    enum {
+        UNUSED = 0xFF
+    };
+    RegionBase **m_reg;
+    uint8_t m_index[MAX_HSM_COUNT];
+    uint8_t m_regCount;
+    uint8_t m_count;
+};
+
 } // namespace FW
 
 #endif // FW_MAPTYPE_H
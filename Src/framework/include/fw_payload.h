@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_PAYLOAD_H
+#define FW_PAYLOAD_H
+
+#include <stdint.h>
+#include "qpcpp.h"
+#include "fw_def.h"
+
+namespace FW {
+
+// Reference-counted buffer for large data (e.g. a received message) which is shared by events rather than
+// copied into them. New() returns a payload with one reference owned by the caller. An event carrying it
+// takes its own reference via AttachTo(), which is released when the event is garbage collected (see
+// Fw::OnGc()). The buffer returns to the pool when the last reference is released.
+class Payload {
+public:
+    enum {
+        BUF_SIZE = 2048,
+        BUF_COUNT = 4,
+    };
+
+    // Allocates a payload with a reference count of 1. It asserts if the pool is exhausted, after counting
+    // the failure.
+    static Payload *New();
+    void Ref();
+    void Release();
+    // Makes the dynamic event e hold a reference until it is garbage collected. An event holds at most one payload.
+    void AttachTo(QP::QEvt const *e);
+
+    uint8_t *GetBufMutable() { return reinterpret_cast<uint8_t *>(m_buf); }
+    uint8_t const *GetBuf() const { return reinterpret_cast<uint8_t const *>(m_buf); }
+    // Accesses the buffer as an object of type T (e.g. a message). Note the buffer is shared by all events
+    // holding this payload.
+    template<class T>
+    T &GetAs() {
+        Q_ASSERT_COMPILE(sizeof(T) <= BUF_SIZE);
+        return *reinterpret_cast<T *>(m_buf);
+    }
+    template<class T>
+    T const &GetAs() const {
+        Q_ASSERT_COMPILE(sizeof(T) <= BUF_SIZE);
+        return *reinterpret_cast<T const *>(m_buf);
+    }
+    uint32_t GetRefCount() const { return m_refCount; }
+
+    struct Usage {
+        uint32_t freeCount;
+        uint32_t minFree;       // Since startup.
+        uint32_t allocCount;    // Since startup or ResetUsage().
+        uint32_t failCount;     // Since startup or ResetUsage().
+    };
+    static void Init();
+    static uint32_t GetBufCount() { return BUF_COUNT; }
+    static void GetUsage(Usage &usage);
+    static void ResetUsage();
+
+protected:
+    Payload() : m_next(NULL), m_refCount(0) {}
+    Payload(Payload const &) = delete;
+    Payload &operator=(Payload const &) = delete;
+
+    // Ensures 4-byte aligned. This buffer may be casted into a message object.
+    uint32_t m_buf[BUF_SIZE / 4];
+    Payload *m_next;            // Next free payload. Only valid when free.
+    uint32_t m_refCount;
+
+    static Payload m_pool[BUF_COUNT];
+    static Payload *m_freeList;
+    static uint32_t m_freeCount;
+    static uint32_t m_minFree;
+    static uint32_t m_allocCount;
+    static uint32_t m_failCount;
+};
+
+} // namespace FW
+
+#endif // FW_PAYLOAD_H
@@ -39,8 +39,11 @@
 #ifndef FW_PIPE_H
 #define FW_PIPE_H
 
+#include <string.h>
+#include <type_traits>
 #include "fw_def.h"
 #include "fw_evt.h"
+#include "fw.h"
 #include "fw_error.h"
 #include "fw_assert.h"
 
@@ -48,7 +51,103 @@
 
 namespace FW {
 
+// Copies a contiguous block of pipe entries. Since pipes copy within critical sections, trivially copyable types
+// (e.g. uint8_t for Fifo) are copied with memcpy(), which copies aligned words rather than single elements.
+// Other types are copied element by element with their assignment operators.
+template <class Type>
+inline void PipeCopy(Type *dest, Type const *src, uint32_t count, std::true_type /*trivial*/) {
+    if (count) {
+        memcpy(dest, src, count * sizeof(Type));
+    }
+}
+template <class Type>
+inline void PipeCopy(Type *dest, Type const *src, uint32_t count, std::false_type /*trivial*/) {
+    for (uint32_t i = 0; i < count; i++) {
+        dest[i] = src[i];
+    }
+}
+template <class Type>
+inline void PipeCopy(Type *dest, Type const *src, uint32_t count) {
+    PipeCopy(dest, src, count, std::integral_constant<bool, std::is_trivially_copyable<Type>::value>());
+}
+
+// Up to two contiguous blocks of pipe entries returned by Reserve() and Peek() for zero-copy access.
+// The second block is only used when the range wraps around the end of the pipe storage.
+template <class Type>
+class PipeSpan {
+public:
+    PipeSpan() { Set(NULL, 0, NULL, 0); }
+    void Set(Type *ptr0, uint32_t count0, Type *ptr1, uint32_t count1) {
+        m_ptr[0] = ptr0;
+        m_count[0] = count0;
+        m_ptr[1] = ptr1;
+        m_count[1] = count1;
+    }
+    // Returns the number of non-empty blocks (0 to 2).
+    uint32_t GetBlockCount() const { return m_count[1] ? 2 : (m_count[0] ? 1 : 0); }
+    Type *GetPtr(uint32_t block) const {
+        FW_PIPE_ASSERT(block < 2);
+        return m_ptr[block];
+    }
+    uint32_t GetCount(uint32_t block) const {
+        FW_PIPE_ASSERT(block < 2);
+        return m_count[block];
+    }
+    // Gets the total count of both blocks.
+    uint32_t GetCount() const { return m_count[0] + m_count[1]; }
+    // Copies count entries from src into the span, filling block 0 before block 1.
+    void CopyFrom(Type const *src, uint32_t count) const {
+        FW_PIPE_ASSERT(src && (count <= GetCount()));
+        uint32_t partial = LESS(count, m_count[0]);
+        PipeCopy(m_ptr[0], src, partial);
+        PipeCopy(m_ptr[1], src + partial, count - partial);
+    }
+    // Copies count entries out of the span to dest, starting from block 0.
+    void CopyTo(Type *dest, uint32_t count) const {
+        FW_PIPE_ASSERT(dest && (count <= GetCount()));
+        uint32_t partial = LESS(count, m_count[0]);
+        PipeCopy(dest, m_ptr[0], partial);
+        PipeCopy(dest + partial, m_ptr[1], count - partial);
+    }
+
+protected:
+    Type *      m_ptr[2];
+    uint32_t    m_count[2];
+};
+
+// Watermark notification of a pipe. An event of m_sig is posted to m_hsmn when the used count crosses m_count
+// in the monitored direction. It is edge-triggered, i.e. posted once per crossing, so that consumers and producers
+// can batch their work rather than being notified on every write or read.
+class PipeWatermark {
+public:
+    PipeWatermark() : m_count(0), m_hsmn(HSM_UNDEF), m_sig(0) {}
+    void Set(uint32_t count, Hsmn hsmn, QP::QSignal sig) {
+        m_count = count;
+        m_hsmn = hsmn;
+        m_sig = sig;
+    }
+    void Clear() { Set(0, HSM_UNDEF, 0); }
+    // Used count has risen from below m_count to m_count or above.
+    bool IsRisen(uint32_t usedBefore, uint32_t usedAfter) const {
+        return m_sig && (usedBefore < m_count) && (usedAfter >= m_count);
+    }
+    // Used count has fallen from above m_count to m_count or below.
+    bool IsFallen(uint32_t usedBefore, uint32_t usedAfter) const {
+        return m_sig && (usedBefore > m_count) && (usedAfter <= m_count);
+    }
+    // Post MUST be outside critical section.
+    void Post() const {
+        Fw::Post(new Evt(m_sig, m_hsmn));
+    }
+
+protected:
+    uint32_t    m_count;
+    Hsmn        m_hsmn;
+    QP::QSignal m_sig;
+};
+
 // Critical sections are enforced internally.
+// For a pipe with a single producer and a single consumer, see SpscPipe in fw_spscpipe.h.
 template <class Type>
 class Pipe {
 public:
@@ -69,6 +168,31 @@ public:
         m_truncated = false;
         QF_CRIT_EXIT(crit);
     }
+    // Posts sig to hsmn when the used count rises to count or above upon Write() or Commit().
+    // count must be between 1 and GetBufSize() - 1. count of 1 is equivalent to the empty-to-non-empty status of Write().
+    void SetHighWatermark(uint32_t count, Hsmn hsmn, QP::QSignal sig) {
+        FW_PIPE_ASSERT((count > 0) && (count <= m_mask) && sig);
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        m_highWatermark.Set(count, hsmn, sig);
+        QF_CRIT_EXIT(crit);
+    }
+    // Posts sig to hsmn when the used count falls to count or below upon Read() or Consume().
+    // count must be less than GetBufSize() - 1. count of 0 is equivalent to the empty status of Read().
+    void SetLowWatermark(uint32_t count, Hsmn hsmn, QP::QSignal sig) {
+        FW_PIPE_ASSERT((count < m_mask) && sig);
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        m_lowWatermark.Set(count, hsmn, sig);
+        QF_CRIT_EXIT(crit);
+    }
+    void ClearWatermarks() {
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        m_highWatermark.Clear();
+        m_lowWatermark.Clear();
+        QF_CRIT_EXIT(crit);
+    }
     bool IsTruncated() const { return m_truncated; }
     uint32_t GetWriteIndex() const { return m_writeIndex; }
     uint32_t GetReadIndex() const { return m_readIndex; }
@@ -147,17 +271,87 @@ public:
         IncIndex(m_readIndex, count);
     }
 
+    // Zero-copy write. Gets up to count unused entries for the producer to fill in place, and returns the actual count.
+    // The entries are not visible to the consumer until Commit() is called.
+    uint32_t Reserve(PipeSpan<Type> &span, uint32_t count) {
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        count = ReserveNoCrit(span, count);
+        QF_CRIT_EXIT(crit);
+        return count;
+    }
+    uint32_t ReserveNoCrit(PipeSpan<Type> &span, uint32_t count) {
+        count = LESS(count, GetAvailCountNoCrit());
+        GetSpan(span, m_writeIndex, count);
+        return count;
+    }
+    // Makes count entries filled in place available to the consumer. count must not exceed the reserved count.
+    // Posts the high watermark event if it is crossed. CommitNoCrit() does not post.
+    void Commit(uint32_t count) {
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        uint32_t used = GetUsedCountNoCrit();
+        CommitNoCrit(count);
+        bool notify = m_highWatermark.IsRisen(used, used + count);
+        QF_CRIT_EXIT(crit);
+        if (notify) {
+            m_highWatermark.Post();
+        }
+    }
+    void CommitNoCrit(uint32_t count) {
+        FW_PIPE_ASSERT(count <= GetAvailCountNoCrit());
+        IncIndex(m_writeIndex, count);
+    }
+
+    // Zero-copy read. Gets up to count used entries for the consumer to access in place, and returns the actual count.
+    // The entries remain in the pipe until Consume() is called.
+    uint32_t Peek(PipeSpan<Type> &span, uint32_t count) {
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        count = PeekNoCrit(span, count);
+        QF_CRIT_EXIT(crit);
+        return count;
+    }
+    uint32_t PeekNoCrit(PipeSpan<Type> &span, uint32_t count) {
+        count = LESS(count, GetUsedCountNoCrit());
+        GetSpan(span, m_readIndex, count);
+        return count;
+    }
+    // Frees count entries accessed in place. count must not exceed the peeked count.
+    // Posts the low watermark event if it is crossed. ConsumeNoCrit() does not post.
+    void Consume(uint32_t count) {
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        uint32_t used = GetUsedCountNoCrit();
+        ConsumeNoCrit(count);
+        bool notify = m_lowWatermark.IsFallen(used, used - count);
+        QF_CRIT_EXIT(crit);
+        if (notify) {
+            m_lowWatermark.Post();
+        }
+    }
+    void ConsumeNoCrit(uint32_t count) {
+        FW_PIPE_ASSERT(count <= GetUsedCountNoCrit());
+        IncIndex(m_readIndex, count);
+    }
+
     // Return written count. If not enough space to write all, return 0 (i.e. no partial write).
     // If overflow has occurred set m_truncated; otherwise clear m_truncated.
+    // Posts the high watermark event if it is crossed.
     uint32_t Write(Type const *src, uint32_t count, bool *status = NULL) {
         QF_CRIT_STAT_TYPE crit;
         QF_CRIT_ENTRY(crit);
+        uint32_t used = GetUsedCountNoCrit();
         count = WriteNoCrit(src, count, status);
+        bool notify = m_highWatermark.IsRisen(used, used + count);
         QF_CRIT_EXIT(crit);
+        if (notify) {
+            m_highWatermark.Post();
+        }
         return count;
     }
 
-    // Without critical section.
+    // Without critical section. Watermark events are not posted since posting is not allowed in critical sections.
     uint32_t WriteNoCrit(Type const *src, uint32_t count, bool *status = NULL) {
         FW_PIPE_ASSERT(src);
         bool wasEmpty = IsEmpty();
@@ -195,15 +389,21 @@ public:
     }
 
     // Return actual read count. Okay if data in pipe < count.
+    // Posts the low watermark event if it is crossed.
     uint32_t Read(Type *dest, uint32_t count, bool *status = NULL) {
         QF_CRIT_STAT_TYPE crit;
         QF_CRIT_ENTRY(crit);
+        uint32_t used = GetUsedCountNoCrit();
         count = ReadNoCrit(dest, count, status);
+        bool notify = m_lowWatermark.IsFallen(used, used - count);
         QF_CRIT_EXIT(crit);
+        if (notify) {
+            m_lowWatermark.Post();
+        }
         return count;
     }
 
-    // Without critical section.
+    // Without critical section. Watermark events are not posted since posting is not allowed in critical sections.
     uint32_t ReadNoCrit(Type *dest, uint32_t count, bool *status = NULL) {
         FW_PIPE_ASSERT(dest);
         uint32_t used = GetUsedCountNoCrit();
@@ -307,20 +507,21 @@ protected:
     // Without critical section.
     void WriteBlock(Type const *src, uint32_t count) {
         FW_PIPE_ASSERT(src && ((m_writeIndex + count) <= (m_mask + 1)));
-        for (uint32_t i = 0; i < count; i++) {
-            m_stor[m_writeIndex + i] = src[i];
-        }
+        PipeCopy(&m_stor[m_writeIndex], src, count);
         IncIndex(m_writeIndex, count);
     }
     // Read contiguous block from m_stor. count can be 0.
     // Without critical section.
     void ReadBlock(Type *dest, uint32_t count) {
         FW_PIPE_ASSERT(dest && ((m_readIndex + count) <= (m_mask + 1)));
-        for (uint32_t i = 0; i < count; i++) {
-            dest[i] = m_stor[m_readIndex + i];
-        }
+        PipeCopy(dest, &m_stor[m_readIndex], count);
         IncIndex(m_readIndex, count);
     }
+    // Gets the span of count entries starting at index, which wraps around the end of m_stor if needed.
+    void GetSpan(PipeSpan<Type> &span, uint32_t index, uint32_t count) {
+        uint32_t partial = LESS(count, m_mask + 1 - index);
+        span.Set(&m_stor[index], partial, &m_stor[0], count - partial);
+    }
     void IncIndex(uint32_t &index, uint32_t count) {
         index = (index + count) & m_mask;
     }
@@ -336,8 +537,8 @@ protected:
     uint32_t    m_writeIndex;
     uint32_t    m_readIndex;
     bool        m_truncated;
-    // For future enhancement.
-    //QP::QSignal m_halfEmptySig; // signal to send when pipe has just crossed half-empty threshold upon read.
+    PipeWatermark m_highWatermark;  // Notifies consumer when enough entries have been written.
+    PipeWatermark m_lowWatermark;   // Notifies producer when enough entries have been read.
 
     // Unimplemented to disallow built-in memberwise copy constructor and assignment operator.
     Pipe(Pipe const &);
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_POOLSTAT_H
+#define FW_POOLSTAT_H
+
+#include <stdint.h>
+#include "qpcpp.h"
+#include "fw_def.h"
+#include "fw_hashmap.h"
+
+// Uncomment the following to record the sizes of dynamic events per signal. When it is commented out,
+// FW_POOL_STAT_CTOR() expands to nothing and the signal table is not compiled in. Pool level usage
+// (see Fw::GetPoolUsage()) is always available.
+//#define ENABLE_FW_POOL_STAT
+
+#ifdef ENABLE_FW_POOL_STAT
+// Called from the Evt constructor for dynamic events, after the signal is set.
+#define FW_POOL_STAT_CTOR(e_)       FW::PoolStat::Record(e_)
+#else
+#define FW_POOL_STAT_CTOR(e_)
+#endif
+
+namespace FW {
+
+#ifdef ENABLE_FW_POOL_STAT
+
+// Requested event sizes per signal of dynamic events.
+class PoolStat {
+public:
+    // Min/max size and a log2 histogram of sizes. Bin i counts sizes in [2^i, 2^(i+1)). The last bin also counts
+    // all above its range. Bins saturate rather than wrap to keep the table small.
+    class Stat {
+    public:
+        enum {
+            BIN_COUNT = 12
+        };
+        Stat() : m_count(0), m_minSize(0), m_maxSize(0) {
+            for (uint32_t i = 0; i < BIN_COUNT; i++) {
+                m_bin[i] = 0;
+            }
+        }
+        void Add(uint32_t size) {
+            if ((m_count == 0) || (size < m_minSize)) {
+                m_minSize = static_cast<uint16_t>(size);
+            }
+            if (size > m_maxSize) {
+                m_maxSize = static_cast<uint16_t>(size);
+            }
+            m_count++;
+            uint32_t bin = size ? (31 - __builtin_clz(size)) : 0;
+            if (bin >= BIN_COUNT) {
+                bin = BIN_COUNT - 1;
+            }
+            if (m_bin[bin] < UINT16_MAX) {
+                m_bin[bin]++;
+            }
+        }
+        uint32_t GetBin(uint32_t i) const { return (i < BIN_COUNT) ? m_bin[i] : 0; }
+        // Lower and upper (inclusive) size bounds of bin i.
+        static uint32_t GetBinLow(uint32_t i) { return (i == 0) ? 0 : (1U << i); }
+        static uint32_t GetBinHigh(uint32_t i) { return (i < BIN_COUNT - 1) ? ((2U << i) - 1) : UINT16_MAX; }
+
+        uint32_t m_count;
+        uint16_t m_minSize;
+        uint16_t m_maxSize;
+        uint16_t m_bin[BIN_COUNT];
+    };
+
+    // Records the size of a newly allocated event against its signal. Events not allocated by Fw::NewEvt()
+    // (e.g. constructed on the stack) are ignored.
+    static void Record(QP::QEvt const *e);
+    static void Reset();
+    // Copies the entry at index in [0, GetTotalCount()). Returns false if it is unused.
+    static bool Get(uint32_t index, QP::QSignal &sig, Stat &stat);
+    static uint32_t GetTotalCount() { return ENTRY_COUNT; }
+    static uint32_t GetUsedCount() { return m_map.GetUsedCount(); }
+    // Number of allocations not recorded because the table was full.
+    static uint32_t GetDropCount() { return m_dropCount; }
+
+protected:
+    enum {
+        ENTRY_COUNT = 128,
+        MAX_USED_COUNT = ENTRY_COUNT * 3 / 4,   // Keeps probe chains short.
+    };
+
+    typedef KeyValue<QP::QSignal, Stat> PoolStatKV;
+    static PoolStatKV m_stor[ENTRY_COUNT];
+    static HashMap<QP::QSignal, Stat> m_map;
+    static uint32_t m_dropCount;
+};
+
+#endif // ENABLE_FW_POOL_STAT
+
+} // namespace FW
+
+#endif // FW_POOLSTAT_H
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_PROF_H
+#define FW_PROF_H
+
+#include <stdint.h>
+#include "qpcpp.h"
+#include "bsp.h"
+#include "fw_def.h"
+#include "fw_hashmap.h"
+
+// Uncomment the following to enable the dispatch profiler. When it is commented out, FW_PROF_START() and
+// FW_PROF_END() expand to nothing and the profiler table is not compiled in.
+//#define ENABLE_FW_PROF
+
+#ifdef ENABLE_FW_PROF
+// Records the cycles spent in a dispatch. Cycles include any preemption by higher priority threads or ISRs.
+#define FW_PROF_START()             uint32_t const profStart_ = GetCycleCount()
+#define FW_PROF_END(hsmn_, sig_)    FW::Prof::Record((hsmn_), (sig_), GetCycleCount() - profStart_)
+#else
+#define FW_PROF_START()
+#define FW_PROF_END(hsmn_, sig_)
+#endif
+
+namespace FW {
+
+#ifdef ENABLE_FW_PROF
+
+// Dispatch cycle statistics per (hsmn, signal), measured with GetCycleCount() (DWT cycle counter on target).
+class Prof {
+public:
+    class Stat {
+    public:
+        Stat() : m_count(0), m_total(0), m_min(0), m_max(0) {}
+        void Add(uint32_t cycles) {
+            if ((m_count == 0) || (cycles < m_min)) {
+                m_min = cycles;
+            }
+            if (cycles > m_max) {
+                m_max = cycles;
+            }
+            m_total += cycles;
+            m_count++;
+        }
+        uint32_t GetAvg() const { return m_count ? static_cast<uint32_t>(m_total / m_count) : 0; }
+
+        uint32_t m_count;
+        uint64_t m_total;
+        uint32_t m_min;
+        uint32_t m_max;
+    };
+
+    static void Record(Hsmn hsmn, QP::QSignal sig, uint32_t cycles);
+    static void Reset();
+    // Copies the entry at index in [0, GetTotalCount()). Returns false if it is unused.
+    static bool Get(uint32_t index, Hsmn &hsmn, QP::QSignal &sig, Stat &stat);
+    static uint32_t GetTotalCount() { return ENTRY_COUNT; }
+    static uint32_t GetUsedCount() { return m_map.GetUsedCount(); }
+    // Number of dispatches not recorded because the table was full.
+    static uint32_t GetDropCount() { return m_dropCount; }
+
+protected:
+    enum {
+        ENTRY_COUNT = 128,
+        MAX_USED_COUNT = ENTRY_COUNT * 3 / 4,   // Keeps probe chains short.
+    };
+    static uint32_t GetKey(Hsmn hsmn, QP::QSignal sig) { return (static_cast<uint32_t>(hsmn) << 16) | sig; }
+
+    typedef KeyValue<uint32_t, Stat> ProfKV;
+    static ProfKV m_stor[ENTRY_COUNT];
+    static HashMap<uint32_t, Stat> m_map;
+    static uint32_t m_dropCount;
+};
+
+#endif // ENABLE_FW_PROF
+
+} // namespace FW
+
+#endif // FW_PROF_H
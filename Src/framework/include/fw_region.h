@@ -46,17 +46,14 @@
 
 namespace FW {
 
-class Active;
+class ActiveBase;
 class XThread;
 
-class Region : public QP::QHsm {
+// Base class of regions. Storage of the Hsm queues is provided by RegionT below, which is what application
+// classes derive from (usually via Region).
+class RegionBase : public QP::QHsm {
 public:
-    Region(QP::QStateHandler const initial, Hsmn hsmn, char const *name) :
-        QP::QHsm(initial),
-        m_hsm(hsmn, name, this),
-        m_container(NULL) {}
-
-    void Init(Active *container);
+    void Init(ActiveBase *container);
     void Init(XThread *container);
     Hsm &GetHsm() { return m_hsm; }
     void Dispatch(QP::QEvt const * const e);
@@ -77,13 +74,13 @@ public:
     void SendNotInQ(Evt *e,  Hsmn to) { m_hsm.SendNotInQ(e, to); }
     void SendNotInQ(Evt *e, Hsmn to, Sequence seq) { m_hsm.SendNotInQ(e, to ,seq); }
 
-    void SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRec &seqRec) { m_hsm.SendReq(e, to, reset, seqRec); }
-    void SendInd(Evt *e, Hsmn to, bool reset, EvtSeqRec &seqRec) { m_hsm.SendInd(e, to, reset, seqRec); }
+    void SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRecBase &seqRec) { m_hsm.SendReq(e, to, reset, seqRec); }
+    void SendInd(Evt *e, Hsmn to, bool reset, EvtSeqRecBase &seqRec) { m_hsm.SendInd(e, to, reset, seqRec); }
     // Using built-in event sequence record.
     void SendReq(Evt *e, Hsmn to, bool reset) { m_hsm.SendReq(e, to, reset); }
     void SendInd(Evt *e, Hsmn to, bool reset) { m_hsm.SendInd(e, to, reset); }
-    bool CheckCfm(ErrorEvt const &e, bool &allReceived, EvtSeqRec &seqRec) { return m_hsm.CheckCfm(e, allReceived, seqRec); }
-    bool CheckRsp(ErrorEvt const &e, bool &allReceived, EvtSeqRec &seqRec) { return m_hsm.CheckRsp(e, allReceived, seqRec); }
+    bool CheckCfm(ErrorEvt const &e, bool &allReceived, EvtSeqRecBase &seqRec) { return m_hsm.CheckCfm(e, allReceived, seqRec); }
+    bool CheckRsp(ErrorEvt const &e, bool &allReceived, EvtSeqRecBase &seqRec) { return m_hsm.CheckRsp(e, allReceived, seqRec); }
     bool CheckCfm(ErrorEvt const &e, bool &allReceived) { return m_hsm.CheckCfm(e, allReceived); }
     bool CheckRsp(ErrorEvt const &e, bool &allReceived) { return m_hsm.CheckRsp(e, allReceived); }
 
@@ -121,10 +118,34 @@ protected:
 
     QP::QActive *GetContainer() { return m_container; }
 
+    // Only references to hsmStor are saved. It is constructed after this object.
+    template <uint16_t DEFER_QUEUE_COUNT, uint8_t REMINDER_QUEUE_COUNT, size_t EVT_SEQ_COUNT>
+    RegionBase(QP::QStateHandler const initial, Hsmn hsmn, char const *name,
+               HsmStor<DEFER_QUEUE_COUNT, REMINDER_QUEUE_COUNT, EVT_SEQ_COUNT> &hsmStor) :
+        QP::QHsm(initial),
+        m_hsm(hsmn, name, this, hsmStor),
+        m_container(NULL) {}
+
     Hsm m_hsm;
     QP::QActive *m_container;
 };
 
+// Region with its storage sized by template parameters. The defaults are the capacities used before they
+// became configurable.
+template <uint16_t DEFER_QUEUE_COUNT = 16, uint8_t REMINDER_QUEUE_COUNT = 4, size_t EVT_SEQ_COUNT = 16>
+class RegionT : public RegionBase {
+public:
+    RegionT(QP::QStateHandler const initial, Hsmn hsmn, char const *name) :
+        RegionBase(initial, hsmn, name, m_hsmStor) {
+        m_hsm.SetRamSize(sizeof(RegionT));
+    }
+
+protected:
+    HsmStor<DEFER_QUEUE_COUNT, REMINDER_QUEUE_COUNT, EVT_SEQ_COUNT> m_hsmStor;
+};
+
+typedef RegionT<> Region;
+
 } // namespace FW
 
 #endif // FW_REGION_H
@@ -41,7 +41,7 @@
 
 #include <stddef.h>
 #include "fw_def.h"
-#include "fw_map.h"
+#include "fw_hashmap.h"
 #include "fw_strbuf.h"
 #include "fw_msg.h"
 #include "fw_assert.h"
@@ -53,10 +53,11 @@ namespace FW {
 // Critical sections MUST be enforced externally by caller.
 // A Sequence Record class to maintain records of outgoing sequence numbers sent in req/ind events/messages.
 // It helps match a received sequence no. in a cfm/rsp event/message against those sent.
-template <class Type, size_t N>
-class SeqRec {
+// The storage is provided by SeqRec below, so records of different capacities can be passed around
+// by a reference to this class.
+template <class Type>
+class SeqRecBase {
 public:
-    SeqRec(Type unusedKey) : m_map(m_mapStor, N, KeyValue<Type, Sequence>(unusedKey, 0)) {}
     void Reset() {
         m_map.Reset();
     }
@@ -79,7 +80,7 @@ public:
             return false;
         }
         // Clear entry once matched.
-        *kv = m_map.GetUnusedKv();
+        m_map.ClearByKey(key);
         return true;
     }
     void Clear(Type key) { m_map.ClearByKey(key); }
@@ -90,15 +91,31 @@ public:
     bool IsAllCleared() {
         return (m_map.GetUsedCount() == 0);
     }
+    uint32_t GetTotalCount() const { return m_map.GetTotalCount(); }
 
+protected:
+    SeqRecBase(KeyValue<Type, Sequence> stor[], size_t count, Type unusedKey) :
+        m_map(stor, count, KeyValue<Type, Sequence>(unusedKey, 0)) {}
+    HashMap<Type, Sequence> m_map;
+};
+
+template <class Type, size_t N>
+class SeqRecStor {
 protected:
     KeyValue<Type, Sequence> m_mapStor[N];
-    Map<Type, Sequence> m_map;
+};
+
+// The storage is a base class so it is constructed before the map initialized with it.
+template <class Type, size_t N>
+class SeqRec : private SeqRecStor<Type, N>, public SeqRecBase<Type> {
+public:
+    SeqRec(Type unusedKey) : SeqRecBase<Type>(this->m_mapStor, N, unusedKey) {}
 };
 
 // Common template instantiation
 using MsgSeqRec = SeqRec<StrBuf<Msg::TO_LEN>, 8>;
 using EvtSeqRec = SeqRec<Hsmn, 16>;
+using EvtSeqRecBase = SeqRecBase<Hsmn>;
 
 } // namespace FW
 
@@ -0,0 +1,322 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_SPSCPIPE_H
+#define FW_SPSCPIPE_H
+
+#include <atomic>
+#include "fw_def.h"
+#include "fw_pipe.h"
+#include "fw_assert.h"
+
+#define FW_SPSCPIPE_ASSERT(t_) ((t_) ? (void)0 : Q_onAssert("fw_spscpipe.h", (int_t)__LINE__))
+
+namespace FW {
+
+// Lock-free pipe for exactly one producer and one consumer (e.g. an ISR/DMA callback and an active object).
+// It has the same API as Pipe (except Delete()) so that users can switch between them with a typedef.
+// No critical section is used. The *NoCrit() variants are kept for API compatibility and are the same
+// as their counterparts, except that they do not post watermark events.
+//
+// Only the producer updates m_writeIndex and m_truncated. Only the consumer updates m_readIndex.
+// Entries are published with release stores of an index and observed with acquire loads of it.
+// Index updates are sequentially consistent so that a producer or consumer checking the other index
+// right after its own update (e.g. for the empty-to-non-empty status in Write() or GetUsedCount() after Read())
+// cannot miss an update from the other side.
+//
+// Reset() and the watermark setters are not thread-safe. They must only be called when neither side is accessing the pipe.
+// Watermark crossings are detected by each side from its own view of the other index. They are exact when the other
+// side is idle (e.g. a producer waiting for the low watermark before writing more), but a concurrent access by the
+// other side may cause a crossing to be missed.
+template <class Type>
+class SpscPipe {
+public:
+    SpscPipe(Type stor[], uint8_t order) :
+        m_stor(stor), m_mask(BIT_MASK_OF_SIZE(order)),
+        m_writeIndex(0), m_readIndex(0), m_truncated(false) {
+        // Arithmetic in this class (m_mask + 1) assumes order < 32.
+        // BIT_MASK_OF_SIZE() assumes order > 0
+        FW_SPSCPIPE_ASSERT(stor && (order > 0) and (order < 32));
+    }
+    virtual ~SpscPipe() {}
+
+    void Reset() {
+        m_writeIndex.store(0);
+        m_readIndex.store(0);
+        m_truncated = false;
+    }
+    // See Pipe::SetHighWatermark(), Pipe::SetLowWatermark() and Pipe::ClearWatermarks().
+    void SetHighWatermark(uint32_t count, Hsmn hsmn, QP::QSignal sig) {
+        FW_SPSCPIPE_ASSERT((count > 0) && (count <= m_mask) && sig);
+        m_highWatermark.Set(count, hsmn, sig);
+    }
+    void SetLowWatermark(uint32_t count, Hsmn hsmn, QP::QSignal sig) {
+        FW_SPSCPIPE_ASSERT((count < m_mask) && sig);
+        m_lowWatermark.Set(count, hsmn, sig);
+    }
+    void ClearWatermarks() {
+        m_highWatermark.Clear();
+        m_lowWatermark.Clear();
+    }
+    bool IsTruncated() const { return m_truncated; }
+    uint32_t GetWriteIndex() const { return m_writeIndex.load(std::memory_order_acquire); }
+    uint32_t GetReadIndex() const { return m_readIndex.load(std::memory_order_acquire); }
+    uint32_t GetUsedCount() const { return GetUsedCountNoCrit(); }
+    uint32_t GetUsedCountNoCrit() const {
+        return (GetWriteIndex() - GetReadIndex()) & m_mask;
+    }
+    // Gets the largest contiguous used block size in byte.
+    uint32_t GetUsedBlockCount() const {
+        uint32_t readIndex = GetReadIndex();
+        uint32_t count = (GetWriteIndex() - readIndex) & m_mask;
+        if ((readIndex + count) > (m_mask + 1)) {
+            count = m_mask + 1 - readIndex;
+        }
+        return count;
+    }
+    uint32_t GetAvailCount() const { return GetAvailCountNoCrit(); }
+    // Since (m_readIndex == m_writeIndex) is regarded as empty, the maximum available count =
+    // total storage - 1, i.e. m_mask.
+    uint32_t GetAvailCountNoCrit() const {
+        return (GetReadIndex() - GetWriteIndex() - 1) & m_mask;
+    }
+    // Gets the largest contiguous unused block size in byte.
+    uint32_t GetAvailBlockCount() const {
+        uint32_t writeIndex = GetWriteIndex();
+        uint32_t count = (GetReadIndex() - writeIndex - 1) & m_mask;
+        if ((writeIndex + count) > (m_mask + 1)) {
+            count = m_mask + 1 - writeIndex;
+        }
+        return count;
+    }
+    uint32_t GetDiff(uint32_t a, uint32_t b) { return (a - b) & m_mask; }
+    uint32_t GetAddr(uint32_t index) { return reinterpret_cast<uint32_t>(&m_stor[index & m_mask]); }
+    Type&    GetRef(uint32_t index) { return m_stor[index & m_mask]; }
+    uint32_t GetWriteAddr() { return GetAddr(GetWriteIndex()); }
+    Type&    GetWriteRef() { return GetRef(GetWriteIndex()); }
+    uint32_t GetReadAddr() { return GetAddr(GetReadIndex()); }
+    Type&    GetReadRef() { return GetRef(GetReadIndex()); }
+    // Returns one byte past the max buffer address. Important - It is not valid to write to /read from this address.
+    uint32_t GetEndAddr() { return reinterpret_cast<uint32_t>(&m_stor[m_mask + 1]); }
+    uint32_t GetBufSize() { return (m_mask + 1); }
+    // Called by producer only.
+    void IncWriteIndex(uint32_t count) {
+        m_writeIndex.store((m_writeIndex.load(std::memory_order_relaxed) + count) & m_mask);
+    }
+    // Called by consumer only.
+    void IncReadIndex(uint32_t count) {
+        m_readIndex.store((m_readIndex.load(std::memory_order_relaxed) + count) & m_mask);
+    }
+    void IncWriteIndexNoCrit(uint32_t count) { IncWriteIndex(count); }
+    void IncReadIndexNoCrit(uint32_t count) { IncReadIndex(count); }
+
+    // Called by producer only.
+    // See Pipe::Reserve() and Pipe::Commit().
+    uint32_t Reserve(PipeSpan<Type> &span, uint32_t count) {
+        uint32_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+        count = LESS(count, (m_readIndex.load(std::memory_order_acquire) - writeIndex - 1) & m_mask);
+        GetSpan(span, writeIndex, count);
+        return count;
+    }
+    uint32_t ReserveNoCrit(PipeSpan<Type> &span, uint32_t count) { return Reserve(span, count); }
+    void Commit(uint32_t count) {
+        uint32_t used = GetUsedCountNoCrit();
+        CommitNoCrit(count);
+        if (m_highWatermark.IsRisen(used, used + count)) {
+            m_highWatermark.Post();
+        }
+    }
+    void CommitNoCrit(uint32_t count) {
+        FW_SPSCPIPE_ASSERT(count <= GetAvailCountNoCrit());
+        IncWriteIndex(count);
+    }
+
+    // Called by consumer only.
+    // See Pipe::Peek() and Pipe::Consume().
+    uint32_t Peek(PipeSpan<Type> &span, uint32_t count) {
+        uint32_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+        count = LESS(count, (m_writeIndex.load(std::memory_order_acquire) - readIndex) & m_mask);
+        GetSpan(span, readIndex, count);
+        return count;
+    }
+    uint32_t PeekNoCrit(PipeSpan<Type> &span, uint32_t count) { return Peek(span, count); }
+    void Consume(uint32_t count) {
+        uint32_t used = GetUsedCountNoCrit();
+        ConsumeNoCrit(count);
+        if (m_lowWatermark.IsFallen(used, used - count)) {
+            m_lowWatermark.Post();
+        }
+    }
+    void ConsumeNoCrit(uint32_t count) {
+        FW_SPSCPIPE_ASSERT(count <= GetUsedCountNoCrit());
+        IncReadIndex(count);
+    }
+
+    // Called by producer only.
+    // Return written count. If not enough space to write all, return 0 (i.e. no partial write).
+    // If overflow has occurred set m_truncated; otherwise clear m_truncated.
+    // Posts the high watermark event if it is crossed. WriteNoCrit() does not post.
+    uint32_t Write(Type const *src, uint32_t count, bool *status = NULL) {
+        uint32_t used = GetUsedCountNoCrit();
+        count = WriteNoCrit(src, count, status);
+        if (m_highWatermark.IsRisen(used, used + count)) {
+            m_highWatermark.Post();
+        }
+        return count;
+    }
+    uint32_t WriteNoCrit(Type const *src, uint32_t count, bool *status = NULL) {
+        FW_SPSCPIPE_ASSERT(src);
+        uint32_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+        uint32_t readIndex = m_readIndex.load(std::memory_order_acquire);
+        if (count > ((readIndex - writeIndex - 1) & m_mask)) {
+            m_truncated = true;
+            count = 0;
+        } else {
+            m_truncated = false;
+            if ((writeIndex + count) <= (m_mask + 1)) {
+                PipeCopy(&m_stor[writeIndex], src, count);
+            } else {
+                uint32_t partial = m_mask + 1 - writeIndex;
+                PipeCopy(&m_stor[writeIndex], src, partial);
+                PipeCopy(&m_stor[0], src + partial, count - partial);
+            }
+            m_writeIndex.store((writeIndex + count) & m_mask);
+        }
+        if (status) {
+            // The pipe was empty if the consumer has read everything written before this call.
+            *status = (count && (m_readIndex.load() == writeIndex));
+        }
+        return count;
+    }
+
+    // Called by producer only.
+    // Writes a single entry.
+    bool WriteNoCrit(Type const &s) {
+        uint32_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+        if (((m_readIndex.load(std::memory_order_acquire) - writeIndex - 1) & m_mask) == 0) {
+            return false;
+        }
+        m_stor[writeIndex] = s;
+        m_writeIndex.store((writeIndex + 1) & m_mask);
+        return true;
+    }
+
+    // Called by consumer only.
+    // Return actual read count. Okay if data in pipe < count.
+    // Posts the low watermark event if it is crossed. ReadNoCrit() does not post.
+    uint32_t Read(Type *dest, uint32_t count, bool *status = NULL) {
+        uint32_t used = GetUsedCountNoCrit();
+        count = ReadNoCrit(dest, count, status);
+        if (m_lowWatermark.IsFallen(used, used - count)) {
+            m_lowWatermark.Post();
+        }
+        return count;
+    }
+    uint32_t ReadNoCrit(Type *dest, uint32_t count, bool *status = NULL) {
+        FW_SPSCPIPE_ASSERT(dest);
+        uint32_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+        uint32_t used = (m_writeIndex.load(std::memory_order_acquire) - readIndex) & m_mask;
+        count = LESS(count, used);
+        if ((readIndex + count) <= (m_mask + 1)) {
+            PipeCopy(dest, &m_stor[readIndex], count);
+        } else {
+            uint32_t partial = m_mask + 1 - readIndex;
+            PipeCopy(dest, &m_stor[readIndex], partial);
+            PipeCopy(dest + partial, &m_stor[0], count - partial);
+        }
+        readIndex = (readIndex + count) & m_mask;
+        m_readIndex.store(readIndex);
+        if (status) {
+            // Currently use "empty" as condition, but it can be half-empty, etc.
+            *status = (count && (m_writeIndex.load() == readIndex));
+        }
+        return count;
+    }
+
+    // Called by consumer only.
+    // Reads a single entry.
+    bool ReadNoCrit(Type &d) {
+        uint32_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+        if (m_writeIndex.load(std::memory_order_acquire) == readIndex) {
+            return false;
+        }
+        d = m_stor[readIndex];
+        m_readIndex.store((readIndex + 1) & m_mask);
+        return true;
+    }
+
+    // See Pipe::CacheOp().
+    void CacheOp(void (*op)(uint32_t addr, uint32_t len), uint32_t count) {
+        uint32_t readIndex = GetReadIndex();
+        if ((readIndex + count) <= (m_mask + 1)) {
+            op(GetAddr(readIndex), count * sizeof(Type));
+        } else {
+            uint32_t partial = m_mask + 1 - readIndex;
+            op(GetAddr(readIndex), partial * sizeof(Type));
+            op(GetAddr(0), (count - partial) * sizeof(Type));
+        }
+    }
+    void CacheOpNoCrit(void (*op)(uint32_t addr, uint32_t len), uint32_t count) {
+        CacheOp(op, count);
+    }
+
+protected:
+    void GetSpan(PipeSpan<Type> &span, uint32_t index, uint32_t count) {
+        uint32_t partial = LESS(count, m_mask + 1 - index);
+        span.Set(&m_stor[index], partial, &m_stor[0], count - partial);
+    }
+
+    Type *                  m_stor;
+    uint32_t                m_mask;
+    std::atomic<uint32_t>   m_writeIndex;
+    std::atomic<uint32_t>   m_readIndex;
+    bool                    m_truncated;
+    PipeWatermark           m_highWatermark;    // Notifies consumer when enough entries have been written.
+    PipeWatermark           m_lowWatermark;     // Notifies producer when enough entries have been read.
+
+    // Unimplemented to disallow built-in memberwise copy constructor and assignment operator.
+    SpscPipe(SpscPipe const &);
+    SpscPipe& operator= (SpscPipe const &);
+};
+
+// Common template instantiation
+typedef SpscPipe<uint8_t> SpscFifo;
+
+} // namespace FW
+
+#endif // FW_SPSCPIPE_H
@@ -133,6 +133,16 @@ public:
     }
 };
 
+// Hash for using StrBuf as a HashMap key (FNV-1a).
+template <size_t N>
+inline uint32_t HashKey(StrBuf<N> const &s) {
+    uint32_t hash = 2166136261U;
+    for (char const *c = s.GetRawConst(); *c; c++) {
+        hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619U;
+    }
+    return hash;
+}
+
 } // namespace FW
 
 #endif // FW_STRBUF_H
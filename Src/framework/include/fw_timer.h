@@ -42,6 +42,7 @@
 #include <stdint.h>
 #include "qpcpp.h"
 #include "fw.h"
+#include "fw_timerwheel.h"
 
 namespace FW {
 
@@ -53,15 +54,26 @@ public:
         INVALID
     };
 
-    // tickRate - 0 is default rate triggered by SysTick_Handler().
-    //            Others up to QF_MAX_TICK_RATE are controlled by application (see bsp.h).
-    Timer(Hsmn hsmn, QP::QSignal signal, uint8_t tickRate = 0, uint32_t msPerTick = BSP_MSEC_PER_TICK);
+    // tickRate - TICK_RATE_BSP is default rate triggered by SysTick_Handler().
+    //            TICK_RATE_FAST is the high-resolution rate triggered by TIM6 (see bsp.h).
+    Timer(Hsmn hsmn, QP::QSignal signal, uint8_t tickRate = TICK_RATE_BSP);
     ~Timer() {}
 
     Hsmn GetHsmn() const { return m_hsmn; }
+    // Timeouts are rounded up to whole ticks of the tick rate.
     void Start(uint32_t timeoutMs, Type type = ONCE);
+    void StartUs(uint32_t timeoutUs, Type type = ONCE);
     void Restart(uint32_t timeoutMs, Type type = ONCE);
     void Stop();
+    // Returns true if no timer is armed at tickRate. Must be called in a critical section.
+    static bool IsIdle(uint8_t tickRate);
+#ifdef ENABLE_FW_TIMER_WHEEL
+    // Advances the timing wheel of tickRate. Called via FW_TIMER_TICK() by the tick ISR.
+    static void Tick(uint8_t tickRate);
+    // For tickless idle. See TimerWheel::NextTick() and SkipTick().
+    static uint32_t NextTick(uint8_t tickRate);
+    static void SkipTick(uint8_t tickRate, uint32_t nTicks);
+#endif
 
 protected:
     bool IsMatch(QEvt const *other) {
@@ -72,10 +84,24 @@ protected:
         return other && (other->sig == sig) && (static_cast<Timer const *>(other)->GetHsmn() == m_hsmn);
     }
 
+    void StartTick(uint32_t timeoutTick, Type type);
+
     Hsmn m_hsmn;
-    uint32_t m_msPerTick;
+    uint32_t m_usPerTick;
+    uint8_t m_tickRate;
+    uint16_t m_tickPerMs;       // Ticks per millisecond, or 0 if a millisecond is not a whole number of ticks.
+#ifdef ENABLE_FW_TIMER_WHEEL
+    TimerWheel::Entry m_entry;
+    static TimerWheel m_wheel[QF_MAX_TICK_RATE];
+#endif
 };
 
 } // namespace FW
 
+#ifdef ENABLE_FW_TIMER_WHEEL
+#define FW_TIMER_TICK(tickRate_)    FW::Timer::Tick(tickRate_)
+#else
+#define FW_TIMER_TICK(tickRate_)
+#endif
+
 #endif // FW_TIMER_H
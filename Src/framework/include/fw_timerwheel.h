@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#ifndef FW_TIMER_WHEEL_H
+#define FW_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include "qpcpp.h"
+
+// Uncomment the following to drive Timer by a timing wheel per tick rate rather than the QF time event list.
+// The tick ISR must call FW_TIMER_TICK() (see fw_timer.h) after QF::tickX_(), which is still needed for
+// QXThread timeouts. When it is commented out, FW_TIMER_TICK() expands to nothing.
+//#define ENABLE_FW_TIMER_WHEEL
+
+namespace FW {
+
+// Hierarchical timing wheel. QF::tickX_() decrements every armed time event on every tick. Here an entry is placed
+// in a slot by its expiry tick, so a tick only visits the entries expiring on it plus those cascaded from the
+// slot of a higher level that has come due, which is amortized over the slots of the level below.
+// Level n has SLOT_COUNT slots of SLOT_COUNT^n ticks each. Timeouts beyond the top level are parked in its last
+// slot and re-inserted when it cascades.
+// All functions use the QF critical section, so Arm() and Disarm() may be called from threads while Tick()
+// runs in the tick ISR.
+class TimerWheel {
+public:
+    // An intrusive list node in a slot. It posts evt to act on expiry.
+    struct Entry {
+        Entry() : next(NULL), pprev(NULL), expire(0), interval(0), act(NULL), evt(NULL) {}
+        bool IsArmed() const { return pprev != NULL; }
+        Entry *next;
+        Entry **pprev;          // Points to the head of the slot or to next of the previous entry. NULL if unlinked.
+        uint32_t expire;        // Tick count at expiry.
+        uint32_t interval;      // Period in ticks. 0 for a one-shot timer.
+        QP::QActive *act;
+        QP::QEvt const *evt;
+    };
+
+    TimerWheel();
+    // nTicks must be greater than 0. The entry must not be armed.
+    void Arm(Entry &entry, uint32_t nTicks, uint32_t interval);
+    // Returns true if the entry was armed.
+    bool Disarm(Entry &entry);
+    // Advances the wheel by one tick and posts the events of expiring entries.
+    void Tick();
+    // For tickless idle. Returns the number of ticks until the earliest entry expires, or 0 if none is armed.
+    uint32_t NextTick();
+    // Accounts for nTicks ticks skipped while idle. nTicks must be less than NextTick(), so no entry expires.
+    void SkipTick(uint32_t nTicks);
+    uint32_t GetNow() const { return m_now; }
+    // Returns true if no entry is armed.
+    bool IsEmpty() const { return m_armedCount == 0; }
+
+protected:
+    enum {
+        SLOT_BITS = 5,
+        SLOT_COUNT = 1 << SLOT_BITS,
+        SLOT_MASK = SLOT_COUNT - 1,
+        LEVEL_COUNT = 4,
+    };
+    // Longest timeout held by the wheel. About 17 minutes at 1 ms per tick.
+    static uint32_t const MAX_DELTA = (1UL << (SLOT_BITS * LEVEL_COUNT)) - 1;
+
+    // Must be called in a critical section.
+    void Insert(Entry &entry);
+    void Remove(Entry &entry);
+    void Cascade(uint8_t level);
+    // Cascades the levels due at m_now.
+    void CascadeDue();
+
+    uint32_t m_now;
+    uint32_t m_armedCount;
+    Entry *m_slot[LEVEL_COUNT][SLOT_COUNT];
+
+    TimerWheel(TimerWheel const &) = delete;
+    TimerWheel &operator=(TimerWheel const &) = delete;
+};
+
+} // namespace FW
+
+#endif // FW_TIMER_WHEEL_H
@@ -53,11 +53,18 @@ class XThread : public QP::QXThread {
 public:
     XThread() :
         QP::QXThread(XThreadHandler),
-        m_hsmnRegMap(m_hsmnRegStor, ARRAY_COUNT(m_hsmnRegStor), HsmnReg(HSM_UNDEF, NULL)) {
+        m_hsmnRegTable(m_regStor, MAX_REGION_COUNT) {
     }
     void Start(uint8_t prio);
-    void Add(Region *reg);
+    void Add(RegionBase *reg);
     static void DelayMs(uint32_t ms) { delay(BSP_MSEC_TO_TICK(ms)); }
+    // Gets the stack size and high-water mark in bytes. The stack is painted by QXK_stackInit_() on start.
+    void GetStackUsage(uint32_t &size, uint32_t &maxUsed) const {
+        size = sizeof(m_stackSto);
+        maxUsed = BspGetStackUsed(m_stackSto, size);
+    }
+    // Returns the extended thread started at QF priority prio, or NULL if none.
+    static XThread *Get(uint8_t prio);
 
 protected:
     virtual void OnRun() = 0;
@@ -67,11 +74,12 @@ protected:
         EVT_QUEUE_COUNT = 16,
         STACK_SIZE_BYTE = 4096
     };
-    HsmnReg m_hsmnRegStor[MAX_REGION_COUNT];
-    HsmnRegMap m_hsmnRegMap;
+    HsmnRegTable m_hsmnRegTable;
+    RegionBase *m_regStor[MAX_REGION_COUNT];
     QP::QEvt const *m_evtQueueStor[EVT_QUEUE_COUNT];
     uint64_t m_stackSto[ROUND_UP_DIV_8(STACK_SIZE_BYTE)];
     struct _reent m_tlsNewLib;      // Thread-local-storage for NewLib.
+    static XThread *m_xthread[QF_MAX_ACTIVE + 1];
 
 private:
     static void XThreadHandler(QXThread * const me) {
@@ -36,9 +36,12 @@
  * Email - admin@galliumstudio.com
  ******************************************************************************/
 
+#include <string.h>
 #include "qpcpp.h"
 #include "fw_active.h"
 #include "fw.h"
+#include "fw_inline.h"
+#include "fw_payload.h"
 #include "fw_assert.h"
 
 FW_DEFINE_THIS_FILE("fw.cpp")
@@ -49,20 +52,34 @@ namespace FW {
 
 HsmAct Fw::m_hsmActStor[MAX_HSM_COUNT];
 HsmActMap Fw::m_hsmActMap(m_hsmActStor, ARRAY_COUNT(m_hsmActStor), HsmAct(NULL, NULL));
+Fw::NotInQStat Fw::m_notInQStat;
 uint32_t Fw::m_evtPoolSmall[ROUND_UP_DIV_4(EVT_SIZE_SMALL * EVT_COUNT_SMALL)];
 uint32_t Fw::m_evtPoolMedium[ROUND_UP_DIV_4(EVT_SIZE_MEDIUM * EVT_COUNT_MEDIUM)];
 uint32_t Fw::m_evtPoolLarge[ROUND_UP_DIV_4(EVT_SIZE_LARGE * EVT_COUNT_LARGE)];
-uint32_t Fw::m_evtPoolXLarge[ROUND_UP_DIV_4(EVT_SIZE_XLARGE * EVT_COUNT_XLARGE)];
+uint32_t const * const Fw::m_poolStart[EVT_POOL_COUNT] = { m_evtPoolSmall, m_evtPoolMedium, m_evtPoolLarge };
+uint32_t const Fw::m_blockSize[EVT_POOL_COUNT] = { EVT_SIZE_SMALL, EVT_SIZE_MEDIUM, EVT_SIZE_LARGE };
+uint32_t const Fw::m_blockCount[EVT_POOL_COUNT] = { EVT_COUNT_SMALL, EVT_COUNT_MEDIUM, EVT_COUNT_LARGE };
+LfPool Fw::m_smallPool;
+std::atomic<uint32_t> Fw::m_allocCount[EVT_POOL_COUNT];
+std::atomic<uint32_t> Fw::m_failCount[EVT_POOL_COUNT];
+Payload *Fw::m_payload[EVT_BLOCK_COUNT];
+#ifdef ENABLE_FW_POOL_STAT
+uint16_t Fw::m_newSize[EVT_BLOCK_COUNT];
+#endif
+#ifdef ENABLE_FW_LATENCY
+uint32_t volatile Fw::m_postTime[EVT_BLOCK_COUNT];
+LatencyHist Fw::m_latencyHist[QF_MAX_ACTIVE + 1];
+#endif
 
 
 void Fw::Init() {
     // Initialize QP. It must be done before BspInit() since the latter may enable
     // SysTick which will cause the scheduler to run.
     QF::init();
-    QF::poolInit(m_evtPoolSmall, sizeof(m_evtPoolSmall), EVT_SIZE_SMALL);
+    m_smallPool.Init(m_evtPoolSmall, EVT_SIZE_SMALL, EVT_COUNT_SMALL);
     QF::poolInit(m_evtPoolMedium, sizeof(m_evtPoolMedium), EVT_SIZE_MEDIUM);
     QF::poolInit(m_evtPoolLarge, sizeof(m_evtPoolLarge), EVT_SIZE_LARGE);
-    QF::poolInit(m_evtPoolXLarge, sizeof(m_evtPoolXLarge), EVT_SIZE_XLARGE);
+    Payload::Init();
     // Any necessary framework initialization will be placed here.
     // ...
     // Initialize BSP include HAL.
@@ -87,6 +104,7 @@ void Fw::Post(Evt const *e) {
     FW_ASSERT(e);
     QActive *act = m_hsmActMap.GetByIndex(e->GetTo())->GetValue();
     if (act) {
+        FW_LAT_POST(e);
         act->post_(e, QF_NO_MARGIN);
     } else {
         QF::gc(e);
@@ -130,19 +148,36 @@ bool Fw::EventInQNoCrit(Evt const *e, QEQueue *queue) {
 }
 
 // Post an event if it is not already in the event queue of the destination active object.
+// An event matches (same signal, destination and source) only if it was also posted via PostNotInQ().
+// Such events are recorded in the destination HSM until dispatched, so the check does not depend on the
+// queue depth. The queue is only scanned when the record is full.
 void Fw::PostNotInQ(Evt const *e) {
     FW_ASSERT(e);
-    QActive *act = m_hsmActMap.GetByIndex(e->GetTo())->GetValue();
+    HsmAct *hsmAct = m_hsmActMap.GetByIndex(e->GetTo());
+    QActive *act = hsmAct->GetValue();
     if (act) {
+        Hsm *hsm = hsmAct->GetKey();
         QEQueue *queue = &act->m_eQueue;
-        FW_ASSERT(queue);
+        FW_ASSERT(hsm && queue);
         // Critical section must support nesting.
         QF_CRIT_STAT_TYPE crit;
         QF_CRIT_ENTRY(crit);
-        if (!Fw::EventInQNoCrit(e, queue)) {
+        bool inQ;
+        if (hsm->IsPendingNoCrit(e)) {
+            inQ = true;
+        } else if (hsm->AddPendingNoCrit(e)) {
+            inQ = false;
+        } else {
+            inQ = Fw::EventInQNoCrit(e, queue);
+            m_notInQStat.scanned++;
+        }
+        if (!inQ) {
+            FW_LAT_POST(e);
             act->post_(e, QF_NO_MARGIN);
+            m_notInQStat.posted++;
         } else {
             QF::gc(e);
+            m_notInQStat.coalesced++;
         }
         QF_CRIT_EXIT(crit);
     } else {
@@ -160,4 +195,235 @@ QActive *Fw::GetContainer(Hsmn hsmn) {
     return m_hsmActMap.GetByIndex(hsmn)->GetValue();
 }
 
+Hsm *Fw::GetActiveHsm(uint8_t prio) {
+    FW_ASSERT(prio <= QF_MAX_ACTIVE);
+    QActive *act = QF::active_[prio];
+    if (!act) {
+        return NULL;
+    }
+    Hsm *first = NULL;
+    for (Hsmn hsmn = HSM_UNDEF + 1; hsmn < MAX_HSM_COUNT; hsmn++) {
+        HsmAct *hsmAct = m_hsmActMap.GetByIndex(hsmn);
+        Hsm *hsm = hsmAct->GetKey();
+        if (hsm && (hsmAct->GetValue() == act)) {
+            if (hsm->GetQHsm() == act) {
+                return hsm;
+            }
+            if (!first) {
+                first = hsm;
+            }
+        }
+    }
+    return first;
+}
+
+bool Fw::GetQueueUsage(uint8_t prio, uint32_t &size, uint32_t &maxUsed) {
+    FW_ASSERT(prio <= QF_MAX_ACTIVE);
+    QActive *act = QF::active_[prio];
+    if (!act) {
+        return false;
+    }
+    // Queue capacity includes the front event.
+    QEQueue const &queue = act->m_eQueue;
+    size = queue.m_end + 1;
+    maxUsed = size - queue.getNMin();
+    return true;
+}
+
+void Fw::ResetQueueUsage() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    for (uint8_t prio = 1; prio <= QF_MAX_ACTIVE; prio++) {
+        QActive *act = QF::active_[prio];
+        if (act) {
+            act->m_eQueue.m_nMin = act->m_eQueue.m_nFree;
+        }
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+QEvt *Fw::NewEvt(uint32_t size) {
+    uint8_t i;
+    for (i = 0; (i < EVT_POOL_COUNT) && (size > m_blockSize[i]); i++) {
+    }
+    FW_ASSERT(i < EVT_POOL_COUNT);
+    QEvt *e;
+    if (i == 0) {
+        e = static_cast<QEvt *>(m_smallPool.Get());
+        if (e) {
+            QF::initDynEvt(e, SMALL_POOL_QF_ID);
+        }
+    } else {
+        // A margin of 0 returns NULL rather than asserting within QF when the pool is exhausted.
+        e = QF::newX_(size, 0, 0);
+    }
+    // Counted without a critical section since it may be called from ISRs.
+    if (e) {
+        m_allocCount[i].fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_failCount[i].fetch_add(1, std::memory_order_relaxed);
+    }
+    // The pool is exhausted. m_failCount identifies the pool when inspected with a debugger.
+    FW_ASSERT(e);
+#ifdef ENABLE_FW_POOL_STAT
+    uint32_t index;
+    if (GetBlockIndex(e, index)) {
+        m_newSize[index] = static_cast<uint16_t>(size);
+    }
+#endif
+    return e;
+}
+
+void Fw::GetPoolUsage(uint8_t poolId, PoolUsage &usage) {
+    FW_ASSERT((poolId > 0) && (poolId <= EVT_POOL_COUNT));
+    uint8_t i = poolId - 1;
+    usage.blockSize = m_blockSize[i];
+    usage.blockCount = m_blockCount[i];
+    usage.minFree = (i == 0) ? m_smallPool.GetMinFree() : QF::getPoolMin(i);
+    usage.allocCount = m_allocCount[i].load(std::memory_order_relaxed);
+    usage.failCount = m_failCount[i].load(std::memory_order_relaxed);
+}
+
+void Fw::ResetPoolUsage() {
+    for (uint8_t i = 0; i < EVT_POOL_COUNT; i++) {
+        m_allocCount[i].store(0, std::memory_order_relaxed);
+        m_failCount[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+// Uses the address rather than the pool ID of e, since the latter is not set for an event constructed on the stack.
+bool Fw::GetBlockIndex(QEvt const *e, uint32_t &index) {
+    uint8_t const *p = reinterpret_cast<uint8_t const *>(e);
+    index = 0;
+    for (uint8_t i = 0; i < EVT_POOL_COUNT; i++) {
+        uint8_t const *start = reinterpret_cast<uint8_t const *>(m_poolStart[i]);
+        if ((p >= start) && (p < (start + m_blockSize[i] * m_blockCount[i]))) {
+            index += (p - start) / m_blockSize[i];
+            return true;
+        }
+        index += m_blockCount[i];
+    }
+    return false;
+}
+
+void Fw::AttachPayload(QEvt const *e, Payload *payload) {
+    FW_ASSERT(e && payload);
+    uint32_t index;
+    bool found = GetBlockIndex(e, index);
+    FW_ASSERT(found);
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    FW_ASSERT(m_payload[index] == NULL);
+    m_payload[index] = payload;
+    QF_CRIT_EXIT(crit);
+}
+
+bool Fw::OnGc(QEvt const *e) {
+    uint32_t index;
+    if (!GetBlockIndex(e, index)) {
+        return false;
+    }
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    Payload *payload = m_payload[index];
+    m_payload[index] = NULL;
+    QF_CRIT_EXIT(crit);
+    if (payload) {
+        payload->Release();
+    }
+    if (m_smallPool.Contains(e)) {
+        m_smallPool.Put(const_cast<QEvt *>(e));
+        return true;
+    }
+    return false;
+}
+
+#ifdef ENABLE_FW_POOL_STAT
+
+uint32_t Fw::TakeNewSize(QEvt const *e) {
+    uint32_t index;
+    if (!GetBlockIndex(e, index)) {
+        return 0;
+    }
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    uint32_t size = m_newSize[index];
+    m_newSize[index] = 0;
+    QF_CRIT_EXIT(crit);
+    return size;
+}
+
+#endif // ENABLE_FW_POOL_STAT
+
+#ifdef ENABLE_FW_LATENCY
+
+// Returns the post time slot of a dynamic event, or NULL for a static event.
+uint32_t volatile *Fw::GetPostTime(QEvt const *e) {
+    if (QF_EVT_POOL_ID_(e) == 0) {
+        return NULL;
+    }
+    uint32_t index;
+    bool found = GetBlockIndex(e, index);
+    FW_ASSERT(found);
+    return &m_postTime[index];
+}
+
+// Must be called before the event is posted, since it may be dispatched before post returns.
+void Fw::StampPost(QEvt const *e) {
+    uint32_t volatile *postTime = GetPostTime(e);
+    if (postTime) {
+        uint32_t now = GetCycleCount();
+        // 0 is reserved for not timestamped.
+        *postTime = now ? now : 1;
+    }
+}
+
+void Fw::ClearPost(QEvt const *e) {
+    uint32_t volatile *postTime = GetPostTime(e);
+    if (postTime) {
+        *postTime = 0;
+    }
+}
+
+void Fw::RecordDispatch(QActive const *act, QEvt const *e) {
+    FW_ASSERT(act && (act->m_prio <= QF_MAX_ACTIVE));
+    uint32_t volatile *postTime = GetPostTime(e);
+    if (postTime && *postTime) {
+        uint32_t latency = GetCycleCount() - *postTime;
+        *postTime = 0;
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        m_latencyHist[act->m_prio].Add(latency);
+        QF_CRIT_EXIT(crit);
+    }
+}
+
+bool Fw::GetLatency(uint8_t prio, LatencyHist &hist) {
+    FW_ASSERT(prio <= QF_MAX_ACTIVE);
+    if (!QF::active_[prio]) {
+        return false;
+    }
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    hist = m_latencyHist[prio];
+    QF_CRIT_EXIT(crit);
+    return true;
+}
+
+void Fw::ResetLatency() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    for (uint32_t i = 0; i < ARRAY_COUNT(m_latencyHist); i++) {
+        m_latencyHist[i].Reset();
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+#endif // ENABLE_FW_LATENCY
+
 } // namespace FW
+
+// Gallium - See qf_dyn.cpp.
+bool QP::QF::onGc(QEvt const * const e) noexcept {
+    return FW::Fw::OnGc(e);
+}
@@ -42,6 +42,7 @@
 #include "fw_evt.h"
 #include "fw_timer.h"
 #include "fw.h"
+#include "fw_prof.h"
 #include "fw_assert.h"
 
 FW_DEFINE_THIS_FILE("fw_active.cpp")
@@ -50,26 +51,29 @@ using namespace QP;
 
 namespace FW {
 
-void Active::Start(uint8_t prio) {
+void ActiveBase::Start(uint8_t prio) {
     Fw::Add(m_hsm.GetHsmn(), &m_hsm, this);
     m_hsm.Init(this);
-    m_tlsNewLib = _REENT_INIT(m_tlsNewLib);
-    m_thread = &m_tlsNewLib;
-    QActive::start(prio, m_evtQueueStor, ARRAY_COUNT(m_evtQueueStor), NULL, 0);
+    if (m_tlsNewLib) {
+        *m_tlsNewLib = _REENT_INIT(*m_tlsNewLib);
+        m_thread = m_tlsNewLib;
+    } else {
+        m_thread = _global_impure_ptr;
+    }
+    QActive::start(prio, m_evtQueueStor, m_evtQueueCount, NULL, 0);
 }
 
-void Active::Add(Region *reg) {
+void ActiveBase::Add(RegionBase *reg) {
     FW_ASSERT(reg);
     Hsmn regHsmn = reg->GetHsmn();
     FW_ASSERT(regHsmn != HSM_UNDEF);
-    HsmnReg *existing = m_hsmnRegMap.GetByKey(regHsmn);
-    FW_ASSERT(existing == NULL);
-    m_hsmnRegMap.Save(HsmnReg(regHsmn, reg));
+    m_hsmnRegTable.Add(regHsmn, reg);
     Fw::Add(regHsmn, &reg->GetHsm(), this);
 }
 
-void Active::dispatch(QEvt const * const e, std::uint_fast8_t const qs_id) {
+void ActiveBase::dispatch(QEvt const * const e, std::uint_fast8_t const qs_id) {
     (void)qs_id;
+    FW_LAT_DISPATCH(this, e);
     Hsmn hsmn;
     // Discard event if it is associated with an undefined HSM.
     // This happens when a timer event already posted is canceled.
@@ -86,19 +90,23 @@ void Active::dispatch(QEvt const * const e, std::uint_fast8_t const qs_id) {
     if (hsmn == m_hsm.GetHsmn()) {
         // For active object, e must be from the active object's event queue (dynamic or static/timer).
         // Garbage collection, if needed, is done by the caller.
+        m_hsm.OnDispatch(e);
+        FW_PROF_START();
         QHsm::dispatch(e, 0);
+        FW_PROF_END(hsmn, e->sig);
         // Handle all reminder events generated as a result of e.
         m_hsm.DispatchReminder();
     } else {
-        HsmnReg *hsmnReg = m_hsmnRegMap.GetByKey(hsmn);
-        if (hsmnReg && hsmnReg->GetValue()) {
-            hsmnReg->GetValue()->Dispatch(e);
+        RegionBase *reg = m_hsmnRegTable.Get(hsmn);
+        if (reg) {
+            reg->Dispatch(e);
         }
     }
 }
 
-void Active::PostSync(Evt const *e) {
+void ActiveBase::PostSync(Evt const *e) {
     FW_ASSERT(e);
+    FW_LAT_POST(e);
     postLIFO(e);
 }
 
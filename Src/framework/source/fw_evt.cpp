@@ -38,6 +38,7 @@
 
 #include "qpcpp.h"
 #include "fw_evt.h"
+#include "fw.h"
 #include "fw_assert.h"
 
 FW_DEFINE_THIS_FILE("fw_evt.cpp")
@@ -47,7 +48,10 @@ using namespace QP;
 namespace FW {
 
 void *Evt::operator new(size_t evtSize) {
-    return QF::newX_(evtSize, QF_NO_MARGIN, 0);
+    QEvt *e = Fw::NewEvt(evtSize);
+    // Clears any post time left from a previous event in the same block that was not dispatched.
+    FW_LAT_CLEAR(e);
+    return e;
 }
 
 void Evt::operator delete(void *evt) {
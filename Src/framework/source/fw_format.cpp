@@ -0,0 +1,421 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "fw_format.h"
+#include "fw_macro.h"
+
+namespace FW {
+
+// Output buffer which counts all characters but only stores those that fit.
+class FormatOut {
+public:
+    FormatOut(char *buf, uint32_t bufSize) : m_buf(buf), m_bufSize(bufSize), m_len(0) {}
+    void Put(char c) {
+        if ((m_len + 1) < m_bufSize) {
+            m_buf[m_len] = c;
+        }
+        m_len++;
+    }
+    void PutN(char c, int32_t count) {
+        while (count-- > 0) {
+            Put(c);
+        }
+    }
+    uint32_t End() {
+        if (m_bufSize) {
+            m_buf[LESS(m_len, m_bufSize - 1)] = 0;
+        }
+        return m_len;
+    }
+private:
+    char *m_buf;
+    uint32_t m_bufSize;
+    uint32_t m_len;
+};
+
+class FormatSpec {
+public:
+    FormatSpec() : left(false), zero(false), plus(false), space(false), alt(false), width(0), prec(-1) {}
+    bool left;
+    bool zero;
+    bool plus;
+    bool space;
+    bool alt;
+    int32_t width;
+    int32_t prec;       // -1 if not specified.
+};
+
+// Outputs sign, prefix and digits (most significant first) with padding.
+// suffixZeroCount zeros are output after the suffix.
+static void PutDigits(FormatOut &out, FormatSpec const &spec, char sign, char const *prefix, char const *digits,
+                      int32_t digitCount, int32_t zeroCount, char const *suffix, int32_t suffixCount,
+                      int32_t suffixZeroCount = 0) {
+    int32_t prefixCount = 0;
+    while (prefix && prefix[prefixCount]) {
+        prefixCount++;
+    }
+    int32_t total = (sign ? 1 : 0) + prefixCount + zeroCount + digitCount + suffixCount + suffixZeroCount;
+    int32_t pad = spec.width - total;
+    if (!spec.left && !spec.zero) {
+        out.PutN(' ', pad);
+    }
+    if (sign) {
+        out.Put(sign);
+    }
+    for (int32_t i = 0; i < prefixCount; i++) {
+        out.Put(prefix[i]);
+    }
+    if (!spec.left && spec.zero) {
+        out.PutN('0', pad);
+    }
+    out.PutN('0', zeroCount);
+    for (int32_t i = 0; i < digitCount; i++) {
+        out.Put(digits[i]);
+    }
+    for (int32_t i = 0; i < suffixCount; i++) {
+        out.Put(suffix[i]);
+    }
+    out.PutN('0', suffixZeroCount);
+    if (spec.left) {
+        out.PutN(' ', pad);
+    }
+}
+
+// Converts v to digits (most significant first). Returns the digit count.
+static int32_t ToDigits(char *digits, uint64_t v, uint32_t base, bool upper) {
+    char const *hex = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[24];
+    int32_t count = 0;
+    do {
+        tmp[count++] = hex[v % base];
+        v /= base;
+    } while (v);
+    for (int32_t i = 0; i < count; i++) {
+        digits[i] = tmp[count - 1 - i];
+    }
+    return count;
+}
+
+static void PutInt(FormatOut &out, FormatSpec spec, uint64_t v, bool neg, uint32_t base, bool upper, bool ptr) {
+    char digits[24];
+    int32_t digitCount = 0;
+    // A zero value with zero precision outputs no digits.
+    if (v || (spec.prec != 0)) {
+        digitCount = ToDigits(digits, v, base, upper);
+    }
+    char const *prefix = NULL;
+    if ((ptr || (spec.alt && v)) && (base == 16)) {
+        prefix = upper ? "0X" : "0x";
+    }
+    int32_t zeroCount = 0;
+    if (spec.prec >= 0) {
+        zeroCount = GREATER(spec.prec - digitCount, 0);
+        // The 0 flag is ignored when a precision is specified.
+        spec.zero = false;
+    }
+    if (spec.alt && (base == 8) && (zeroCount == 0) && ((digitCount == 0) || (digits[0] != '0'))) {
+        zeroCount = 1;
+    }
+    char sign = neg ? '-' : (spec.plus ? '+' : (spec.space ? ' ' : 0));
+    PutDigits(out, spec, sign, prefix, digits, digitCount, zeroCount, NULL, 0);
+}
+
+// Formats v in fixed-point notation with integer arithmetic only, so no double precision (soft-float) operation is
+// used. v is split into its 53-bit mantissa and binary exponent. Fractional digits are generated by multiplying the
+// remaining fraction by 10 (as 5 and a shift). When that would overflow 64 bits the lowest bit is dropped, so digits
+// are exact to about 18 significant digits. Digits after the FRAC_DIGITS-th decimal place are output as zeros.
+// Ties round to even as in the C library.
+static void PutFloat(FormatOut &out, FormatSpec spec, double v, bool upper) {
+    enum {
+        MANT_BITS = 52,
+        EXP_MAX = 0x7FF,
+        EXP_BIAS = 1023 + MANT_BITS,
+        FRAC_DIGITS = 40,
+    };
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    bool neg = (bits >> 63) != 0;
+    int32_t exp = static_cast<int32_t>((bits >> MANT_BITS) & EXP_MAX);
+    uint64_t mant = bits & ((1ULL << MANT_BITS) - 1);
+    char sign = neg ? '-' : (spec.plus ? '+' : (spec.space ? ' ' : 0));
+    if ((exp == EXP_MAX) || (exp >= 1023 + 64)) {
+        // Out of range values (2^64 or above in magnitude) are output as "inf".
+        bool nan = (exp == EXP_MAX) && mant;
+        spec.zero = false;
+        PutDigits(out, spec, sign, NULL, nan ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf"), 3, 0, NULL, 0);
+        return;
+    }
+    // v = mant * 2^exp. Subnormals have no implicit leading 1 and the exponent of the smallest normal.
+    if (exp) {
+        mant |= 1ULL << MANT_BITS;
+    } else {
+        exp = 1;
+    }
+    exp -= EXP_BIAS;
+    uint64_t intPart = 0;
+    uint64_t frac = 0;          // The fraction is frac * 2^-shift.
+    int32_t shift = -exp;
+    if (exp >= 0) {
+        intPart = mant << exp;
+    } else if (shift < 64) {
+        intPart = mant >> shift;
+        frac = mant & ((1ULL << shift) - 1);
+    } else {
+        frac = mant;
+    }
+    int32_t prec = (spec.prec < 0) ? 6 : spec.prec;
+    int32_t fracCount = LESS(prec, static_cast<int32_t>(FRAC_DIGITS));
+    // Decimal point followed by fracCount fractional digits.
+    char suffix[FRAC_DIGITS + 1];
+    int32_t suffixCount = 0;
+    if (prec || spec.alt) {
+        suffix[suffixCount++] = '.';
+    }
+    char *fracDigits = &suffix[suffixCount];
+    for (int32_t i = 0; i < fracCount; i++) {
+        uint32_t digit = 0;
+        if (frac) {
+            while (frac > (UINT64_MAX / 5)) {
+                frac >>= 1;
+                shift--;
+            }
+            frac *= 5;
+            shift--;
+            if (shift < 64) {
+                digit = static_cast<uint32_t>(frac >> shift);
+                frac -= static_cast<uint64_t>(digit) << shift;
+            }
+        }
+        fracDigits[i] = static_cast<char>('0' + digit);
+    }
+    suffixCount += fracCount;
+    // The remainder is at least half if its top bit is set. It is less than half if shift is beyond 64 bits.
+    bool odd = fracCount ? ((fracDigits[fracCount - 1] - '0') & 1) : (intPart & 1);
+    bool roundUp = false;
+    if (frac && (shift <= 64)) {
+        uint64_t half = 1ULL << (shift - 1);
+        roundUp = (frac > half) || ((frac == half) && odd);
+    }
+    if (roundUp) {
+        int32_t i = fracCount - 1;
+        while ((i >= 0) && (fracDigits[i] == '9')) {
+            fracDigits[i--] = '0';
+        }
+        if (i >= 0) {
+            fracDigits[i]++;
+        } else {
+            intPart++;
+        }
+    }
+    char digits[24];
+    int32_t digitCount = ToDigits(digits, intPart, 10, false);
+    PutDigits(out, spec, sign, NULL, digits, digitCount, 0, suffix, suffixCount, prec - fracCount);
+}
+
+uint32_t Format::Print(char *buf, uint32_t bufSize, char const *format, ...) {
+    va_list arg;
+    va_start(arg, format);
+    uint32_t len = PrintV(buf, bufSize, format, arg);
+    va_end(arg);
+    return len;
+}
+
+uint32_t Format::PrintV(char *buf, uint32_t bufSize, char const *format, va_list arg) {
+    FormatOut out(buf, bufSize);
+    char const *p = format;
+    while (*p) {
+        if (*p != '%') {
+            out.Put(*p++);
+            continue;
+        }
+        char const *start = p++;
+        FormatSpec spec;
+        for (bool flag = true; flag; ) {
+            switch (*p) {
+                case '-': spec.left = true; p++; break;
+                case '0': spec.zero = true; p++; break;
+                case '+': spec.plus = true; p++; break;
+                case ' ': spec.space = true; p++; break;
+                case '#': spec.alt = true; p++; break;
+                default: flag = false; break;
+            }
+        }
+        if (*p == '*') {
+            spec.width = va_arg(arg, int);
+            if (spec.width < 0) {
+                spec.left = true;
+                spec.width = -spec.width;
+            }
+            p++;
+        } else {
+            while ((*p >= '0') && (*p <= '9')) {
+                spec.width = spec.width * 10 + (*p++ - '0');
+            }
+        }
+        if (*p == '.') {
+            p++;
+            spec.prec = 0;
+            if (*p == '*') {
+                spec.prec = va_arg(arg, int);
+                spec.prec = (spec.prec < 0) ? -1 : spec.prec;
+                p++;
+            } else {
+                while ((*p >= '0') && (*p <= '9')) {
+                    spec.prec = spec.prec * 10 + (*p++ - '0');
+                }
+            }
+        }
+        // Length modifier: 'h' count (negative) or 'l' count, 'z' for size_t/ptrdiff_t, 'L' for long double.
+        int32_t lenMod = 0;
+        char sizeMod = 0;
+        for (bool mod = true; mod; ) {
+            switch (*p) {
+                case 'h': lenMod--; p++; break;
+                case 'l': lenMod++; p++; break;
+                case 'j': lenMod = 2; p++; break;
+                case 'z':
+                case 't': sizeMod = 'z'; p++; break;
+                case 'L': sizeMod = 'L'; p++; break;
+                default: mod = false; break;
+            }
+        }
+        char conv = *p;
+        if (conv) {
+            p++;
+        }
+        switch (conv) {
+            case 'd':
+            case 'i': {
+                int64_t v;
+                if (sizeMod == 'z') {
+                    v = va_arg(arg, ptrdiff_t);
+                } else if (lenMod >= 2) {
+                    v = va_arg(arg, long long);
+                } else if (lenMod == 1) {
+                    v = va_arg(arg, long);
+                } else {
+                    v = va_arg(arg, int);
+                    v = (lenMod == -1) ? static_cast<short>(v) : ((lenMod <= -2) ? static_cast<signed char>(v) : v);
+                }
+                uint64_t mag = (v < 0) ? (0 - static_cast<uint64_t>(v)) : static_cast<uint64_t>(v);
+                PutInt(out, spec, mag, v < 0, 10, false, false);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o': {
+                uint64_t v;
+                if (sizeMod == 'z') {
+                    v = va_arg(arg, size_t);
+                } else if (lenMod >= 2) {
+                    v = va_arg(arg, unsigned long long);
+                } else if (lenMod == 1) {
+                    v = va_arg(arg, unsigned long);
+                } else {
+                    v = va_arg(arg, unsigned int);
+                    v = (lenMod == -1) ? static_cast<unsigned short>(v) : ((lenMod <= -2) ? static_cast<unsigned char>(v) : v);
+                }
+                uint32_t base = (conv == 'o') ? 8 : ((conv == 'u') ? 10 : 16);
+                spec.plus = spec.space = false;
+                PutInt(out, spec, v, false, base, conv == 'X', false);
+                break;
+            }
+            case 'p': {
+                spec.plus = spec.space = false;
+                PutInt(out, spec, reinterpret_cast<uintptr_t>(va_arg(arg, void *)), false, 16, false, true);
+                break;
+            }
+            case 'c': {
+                char c = static_cast<char>(va_arg(arg, int));
+                spec.zero = false;
+                PutDigits(out, spec, 0, NULL, &c, 1, 0, NULL, 0);
+                break;
+            }
+            case 's': {
+                char const *s = va_arg(arg, char const *);
+                s = s ? s : "(null)";
+                int32_t len = 0;
+                while (((spec.prec < 0) || (len < spec.prec)) && s[len]) {
+                    len++;
+                }
+                spec.zero = false;
+                PutDigits(out, spec, 0, NULL, s, len, 0, NULL, 0);
+                break;
+            }
+            case 'f':
+            case 'F': {
+                double v = (sizeMod == 'L') ? static_cast<double>(va_arg(arg, long double)) : va_arg(arg, double);
+                PutFloat(out, spec, v, conv == 'F');
+                break;
+            }
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G': {
+                // Not supported. The argument is consumed so that the following ones stay in place, and the
+                // conversion is output literally like other unsupported ones.
+                if (sizeMod == 'L') {
+                    va_arg(arg, long double);
+                } else {
+                    va_arg(arg, double);
+                }
+                while (start < p) {
+                    out.Put(*start++);
+                }
+                break;
+            }
+            case '%': {
+                out.Put('%');
+                break;
+            }
+            default: {
+                // Unsupported conversion is output literally.
+                while (start < p) {
+                    out.Put(*start++);
+                }
+                break;
+            }
+        }
+    }
+    return out.End();
+}
+
+} // namespace FW
@@ -0,0 +1,414 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#include <string.h>
+#include "fw_heap.h"
+#include "fw_assert.h"
+
+FW_DEFINE_THIS_FILE("fw_heap.cpp")
+
+namespace FW {
+
+Heap *Heap::m_first = NULL;
+
+// Index of the most significant set bit. v must not be 0.
+static inline uint32_t Fls(size_t v) {
+    return (8 * sizeof(unsigned long) - 1) - __builtin_clzl(static_cast<unsigned long>(v));
+}
+
+// Index of the least significant set bit. v must not be 0.
+static inline uint32_t Ffs(uint32_t v) {
+    return __builtin_ctz(v);
+}
+
+Heap::Heap(char const *name, void *stor, size_t size, uint8_t ceiling) :
+    m_name(name), m_lock(ceiling), m_flBitmap(0), m_size(0), m_usedSize(0), m_peakUsed(0),
+    m_allocCount(0), m_failCount(0), m_next(NULL) {
+    static_assert((1 << ALIGN_LOG2) == ALIGN, "ALIGN_LOG2");
+    static_assert((HDR_SIZE % ALIGN) == 0, "HDR_SIZE");
+    static_assert((1 << MAX_ARENA_LOG2) == static_cast<int>(MAX_ARENA_SIZE), "MAX_ARENA_LOG2");
+    FW_ASSERT(name && stor);
+    memset(m_slBitmap, 0, sizeof(m_slBitmap));
+    memset(m_free, 0, sizeof(m_free));
+    uintptr_t start = (reinterpret_cast<uintptr_t>(stor) + ALIGN - 1) & ~static_cast<uintptr_t>(ALIGN - 1);
+    size -= (start - reinterpret_cast<uintptr_t>(stor));
+    if (size > MAX_ARENA_SIZE) {
+        size = MAX_ARENA_SIZE;
+    }
+    size &= ~static_cast<size_t>(ALIGN - 1);
+    // One free block spanning the arena, followed by a zero-sized used sentinel block.
+    FW_ASSERT(size >= (2 * HDR_SIZE + MIN_SIZE));
+    Block *b = reinterpret_cast<Block *>(start);
+    b->prevPhys = NULL;
+    b->size = (size - 2 * HDR_SIZE) | BLOCK_FREE;
+    Block *sentinel = GetNextPhys(b);
+    sentinel->prevPhys = b;
+    sentinel->size = PREV_FREE;
+    Insert(b);
+    m_size = GetSize(b);
+    // Heaps are constructed during system initialization.
+    Heap **h = &m_first;
+    while (*h) {
+        h = &(*h)->m_next;
+    }
+    *h = this;
+}
+
+void Heap::Mapping(size_t size, uint32_t &fl, uint32_t &sl) {
+    if (size < SMALL_SIZE) {
+        fl = 0;
+        sl = size / (SMALL_SIZE / SL_COUNT);
+    } else {
+        uint32_t msb = Fls(size);
+        sl = (size >> (msb - SL_LOG2)) ^ SL_COUNT;
+        fl = msb - FL_SHIFT + 1;
+    }
+}
+
+size_t Heap::AdjustSize(size_t size) {
+    size = (size + ALIGN - 1) & ~static_cast<size_t>(ALIGN - 1);
+    return (size < MIN_SIZE) ? static_cast<size_t>(MIN_SIZE) : size;
+}
+
+void Heap::Insert(Block *b) {
+    uint32_t fl, sl;
+    Mapping(GetSize(b), fl, sl);
+    Block *head = m_free[fl][sl];
+    b->nextFree = head;
+    b->prevFree = NULL;
+    if (head) {
+        head->prevFree = b;
+    }
+    m_free[fl][sl] = b;
+    m_flBitmap |= (1UL << fl);
+    m_slBitmap[fl] |= (1U << sl);
+}
+
+void Heap::Remove(Block *b) {
+    uint32_t fl, sl;
+    Mapping(GetSize(b), fl, sl);
+    if (b->nextFree) {
+        b->nextFree->prevFree = b->prevFree;
+    }
+    if (b->prevFree) {
+        b->prevFree->nextFree = b->nextFree;
+    } else {
+        FW_ASSERT(m_free[fl][sl] == b);
+        m_free[fl][sl] = b->nextFree;
+        if (m_free[fl][sl] == NULL) {
+            m_slBitmap[fl] &= ~(1U << sl);
+            if (m_slBitmap[fl] == 0) {
+                m_flBitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+// Returns a free block of at least size bytes, or NULL. Rounding the size up to the next size class
+// guarantees any block in the list found is large enough, so no list is searched.
+Heap::Block *Heap::Find(size_t size) {
+    if (size >= SMALL_SIZE) {
+        size += (static_cast<size_t>(1) << (Fls(size) - SL_LOG2)) - 1;
+    }
+    uint32_t fl, sl;
+    Mapping(size, fl, sl);
+    if (fl >= FL_COUNT) {
+        return NULL;
+    }
+    uint32_t slMap = m_slBitmap[fl] & (~0U << sl);
+    if (slMap == 0) {
+        uint32_t flMap = (fl + 1 < FL_COUNT) ? (m_flBitmap & (~0UL << (fl + 1))) : 0;
+        if (flMap == 0) {
+            return NULL;
+        }
+        fl = Ffs(flMap);
+        slMap = m_slBitmap[fl];
+    }
+    sl = Ffs(slMap);
+    return m_free[fl][sl];
+}
+
+// Splits the block b (not in a free list) so it is size bytes. The remainder, if large enough to hold
+// a block, is put in a free list and returned.
+Heap::Block *Heap::Split(Block *b, size_t size) {
+    size_t bSize = GetSize(b);
+    if (bSize < (size + HDR_SIZE + MIN_SIZE)) {
+        return NULL;
+    }
+    Block *rem = reinterpret_cast<Block *>(GetPayload(b) + size);
+    rem->size = (bSize - size - HDR_SIZE) | BLOCK_FREE;
+    b->size = size | (b->size & (BLOCK_FREE | PREV_FREE));
+    rem->prevPhys = b;
+    Block *next = GetNextPhys(rem);
+    next->prevPhys = rem;
+    next->size |= PREV_FREE;
+    Insert(rem);
+    return rem;
+}
+
+// Merges the next physical block into b if it is free. It is removed from its free list.
+Heap::Block *Heap::MergeNext(Block *b) {
+    Block *next = GetNextPhys(b);
+    if (next->size & BLOCK_FREE) {
+        Remove(next);
+        b->size += GetSize(next) + HDR_SIZE;
+        GetNextPhys(b)->prevPhys = b;
+    }
+    return b;
+}
+
+void Heap::MarkUsed(Block *b) {
+    b->size &= ~static_cast<size_t>(BLOCK_FREE);
+    GetNextPhys(b)->size &= ~static_cast<size_t>(PREV_FREE);
+    m_usedSize += GetSize(b);
+    if (m_usedSize > m_peakUsed) {
+        m_peakUsed = m_usedSize;
+    }
+    m_allocCount++;
+}
+
+void *Heap::Alloc(size_t size) {
+    if (size > MAX_ARENA_SIZE) {
+        m_lock.Lock();
+        m_failCount++;
+        m_lock.Unlock();
+        return NULL;
+    }
+    size = AdjustSize(size);
+    m_lock.Lock();
+    Block *b = Find(size);
+    if (b == NULL) {
+        m_failCount++;
+        m_lock.Unlock();
+        return NULL;
+    }
+    Remove(b);
+    Split(b, size);
+    MarkUsed(b);
+    m_lock.Unlock();
+    return GetPayload(b);
+}
+
+void *Heap::AllocAligned(size_t align, size_t size) {
+    if (align <= ALIGN) {
+        return Alloc(size);
+    }
+    FW_ASSERT((align & (align - 1)) == 0);
+    if ((size > MAX_ARENA_SIZE) || (align > MAX_ARENA_SIZE)) {
+        m_lock.Lock();
+        m_failCount++;
+        m_lock.Unlock();
+        return NULL;
+    }
+    size = AdjustSize(size);
+    // The leading gap must be large enough to hold a free block.
+    size_t const GAP_MIN = HDR_SIZE + MIN_SIZE;
+    m_lock.Lock();
+    Block *b = Find(size + align + GAP_MIN);
+    if (b == NULL) {
+        m_failCount++;
+        m_lock.Unlock();
+        return NULL;
+    }
+    Remove(b);
+    uintptr_t payload = reinterpret_cast<uintptr_t>(GetPayload(b));
+    uintptr_t aligned = (payload + GAP_MIN + align - 1) & ~static_cast<uintptr_t>(align - 1);
+    size_t gap = aligned - payload;
+    // b keeps the gap and is freed. Since free blocks are always merged, the block before b is not free.
+    Block *ab = GetBlock(reinterpret_cast<void *>(aligned));
+    ab->size = (GetSize(b) - gap) | BLOCK_FREE | PREV_FREE;
+    ab->prevPhys = b;
+    b->size = (gap - HDR_SIZE) | BLOCK_FREE;
+    Insert(b);
+    Split(ab, size);
+    MarkUsed(ab);
+    m_lock.Unlock();
+    return GetPayload(ab);
+}
+
+void Heap::Free(void *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    Block *b = GetBlock(ptr);
+    m_lock.Lock();
+    FW_ASSERT((b->size & BLOCK_FREE) == 0);
+    m_usedSize -= GetSize(b);
+    b->size |= BLOCK_FREE;
+    if (b->size & PREV_FREE) {
+        Block *prev = b->prevPhys;
+        Remove(prev);
+        prev->size += GetSize(b) + HDR_SIZE;
+        b = prev;
+    }
+    b = MergeNext(b);
+    Block *next = GetNextPhys(b);
+    next->prevPhys = b;
+    next->size |= PREV_FREE;
+    Insert(b);
+    m_lock.Unlock();
+}
+
+void *Heap::Realloc(void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return Alloc(size);
+    }
+    if (size == 0) {
+        Free(ptr);
+        return NULL;
+    }
+    if (size > MAX_ARENA_SIZE) {
+        m_lock.Lock();
+        m_failCount++;
+        m_lock.Unlock();
+        return NULL;
+    }
+    Block *b = GetBlock(ptr);
+    size_t oldSize = GetSize(b);
+    size = AdjustSize(size);
+    m_lock.Lock();
+    Block *next = GetNextPhys(b);
+    if ((size > oldSize) && (next->size & BLOCK_FREE) && ((oldSize + HDR_SIZE + GetSize(next)) >= size)) {
+        // Grows in place into the next free block.
+        MergeNext(b);
+        GetNextPhys(b)->size &= ~static_cast<size_t>(PREV_FREE);
+    }
+    if (GetSize(b) >= size) {
+        // When shrinking, the remainder may be followed by a free block.
+        Block *rem = Split(b, size);
+        if (rem && (GetNextPhys(rem)->size & BLOCK_FREE)) {
+            Remove(rem);
+            Insert(MergeNext(rem));
+        }
+        m_usedSize += GetSize(b) - oldSize;
+        if (m_usedSize > m_peakUsed) {
+            m_peakUsed = m_usedSize;
+        }
+        m_lock.Unlock();
+        return ptr;
+    }
+    m_lock.Unlock();
+    void *newPtr = Alloc(size);
+    if (newPtr) {
+        memcpy(newPtr, ptr, oldSize);
+        Free(ptr);
+    }
+    return newPtr;
+}
+
+void *Heap::Calloc(size_t count, size_t size) {
+    if (size && (count > (MAX_ARENA_SIZE / size))) {
+        return NULL;
+    }
+    void *ptr = Alloc(count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+size_t Heap::GetSize(void const *ptr) const {
+    FW_ASSERT(ptr);
+    return GetSize(GetBlock(ptr));
+}
+
+void Heap::GetStat(Stat &stat) {
+    m_lock.Lock();
+    stat.size = m_size;
+    stat.usedSize = m_usedSize;
+    stat.peakUsed = m_peakUsed;
+    stat.allocCount = m_allocCount;
+    stat.failCount = m_failCount;
+    stat.freeSize = 0;
+    stat.largestFree = 0;
+    stat.freeBlockCount = 0;
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++) {
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++) {
+            for (Block *b = m_free[fl][sl]; b; b = b->nextFree) {
+                uint32_t size = GetSize(b);
+                stat.freeSize += size;
+                stat.freeBlockCount++;
+                if (size > stat.largestFree) {
+                    stat.largestFree = size;
+                }
+            }
+        }
+    }
+    m_lock.Unlock();
+}
+
+void Heap::ResetStat() {
+    m_lock.Lock();
+    m_peakUsed = m_usedSize;
+    m_allocCount = 0;
+    m_failCount = 0;
+    m_lock.Unlock();
+}
+
+Heap &Heap::GetSys() {
+    static_assert(SYS_SIZE <= MAX_ARENA_SIZE, "FW_HEAP_SYS_SIZE");
+    // Constructed on first use since malloc() may be called before static constructors run.
+    static uint64_t stor[SYS_SIZE / sizeof(uint64_t)];
+    static Heap heap("sys", stor, sizeof(stor));
+    return heap;
+}
+
+} // namespace FW
+
+#ifdef ENABLE_FW_HEAP_MALLOC
+
+// Replaces the newlib allocator. newlib internally calls the reentrant versions.
+extern "C" {
+
+void *malloc(size_t size) { return FW::Heap::GetSys().Alloc(size); }
+void free(void *ptr) { FW::Heap::GetSys().Free(ptr); }
+void *realloc(void *ptr, size_t size) { return FW::Heap::GetSys().Realloc(ptr, size); }
+void *calloc(size_t count, size_t size) { return FW::Heap::GetSys().Calloc(count, size); }
+void *_malloc_r(struct _reent *r, size_t size) { (void)r; return malloc(size); }
+void _free_r(struct _reent *r, void *ptr) { (void)r; free(ptr); }
+void *_realloc_r(struct _reent *r, void *ptr, size_t size) { (void)r; return realloc(ptr, size); }
+void *_calloc_r(struct _reent *r, size_t count, size_t size) { (void)r; return calloc(count, size); }
+void *memalign(size_t align, size_t size) { return FW::Heap::GetSys().AllocAligned(align, size); }
+void *aligned_alloc(size_t align, size_t size) { return FW::Heap::GetSys().AllocAligned(align, size); }
+size_t malloc_usable_size(void *ptr) { return ptr ? FW::Heap::GetSys().GetSize(ptr) : 0; }
+void *_memalign_r(struct _reent *r, size_t align, size_t size) { (void)r; return memalign(align, size); }
+size_t _malloc_usable_size_r(struct _reent *r, void *ptr) { (void)r; return malloc_usable_size(ptr); }
+
+} // extern "C"
+
+#endif // ENABLE_FW_HEAP_MALLOC
@@ -41,6 +41,7 @@
 #include "fw_log.h"
 #include "fw_assert.h"
 #include "fw.h"
+#include "fw_prof.h"
 
 FW_DEFINE_THIS_FILE("fw_hsm.cpp")
 
@@ -48,18 +49,24 @@ using namespace QP;
 
 namespace FW {
 
-Hsm::Hsm(Hsmn hsmn, char const *name, QP::QHsm *qhsm) :
+Hsm::Hsm(Hsmn hsmn, char const *name, QP::QHsm *qhsm, QEvt const *deferQueueStor[], uint16_t deferQueueCount,
+         QEvt const *reminderQueueStor[], uint8_t reminderQueueCount, EvtSeqRecBase &evtSeq) :
     m_hsmn(hsmn), m_name(name), m_qhsm(qhsm), m_state(Log::GetUndefName()),
-    m_nextSequence(0), m_evtSeq(HSM_UNDEF) {}
+    m_nextSequence(0), m_dispatchCount(0), m_pendingCount(0), m_reminderQueueCount(reminderQueueCount),
+    m_deferQueueCount(deferQueueCount), m_ramSize(0), m_evtSeq(evtSeq), m_deferQueueStor(deferQueueStor),
+    m_reminderQueueStor(reminderQueueStor) {}
 
 void Hsm::Init(QActive *container) {
-    m_deferEQueue.Init(container, m_deferQueueStor, ARRAY_COUNT(m_deferQueueStor));
-    m_reminderQueue.init(m_reminderQueueStor, ARRAY_COUNT(m_reminderQueueStor));
+    FW_ASSERT(m_deferQueueStor && m_deferQueueCount && m_reminderQueueStor && m_reminderQueueCount);
+    m_deferEQueue.Init(container, m_deferQueueStor, m_deferQueueCount);
+    m_reminderQueue.init(m_reminderQueueStor, m_reminderQueueCount);
 }
 
 void Hsm::DispatchReminder() {
     while (QEvt const *reminder = m_reminderQueue.get(0)) {
+        FW_PROF_START();
         m_qhsm->QHsm::dispatch(reminder, 0);
+        FW_PROF_END(m_hsmn, reminder->sig);
         // A reminder event must be dynamic and is garbage collected after being processed.
         FW_ASSERT(QF_EVT_POOL_ID_(reminder) != 0);
         // A reminder event must be an internal or interface event (but not a timer event).
@@ -69,7 +76,44 @@ void Hsm::DispatchReminder() {
     }
 }
 
-void Hsm::SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRec &seqRec) {
+// Returns true if an event of the same signal and source as e is pending.
+// The destination matches as e is posted to this HSM.
+bool Hsm::IsPendingNoCrit(Evt const *e) const {
+    FW_ASSERT(e && (e->GetTo() == m_hsmn));
+    for (uint32_t i = 0; i < m_pendingCount; i++) {
+        if ((m_pending[i]->sig == e->sig) && (m_pending[i]->GetFrom() == e->GetFrom())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns false if the pending record is full.
+bool Hsm::AddPendingNoCrit(Evt const *e) {
+    FW_ASSERT(e);
+    if (m_pendingCount >= PENDING_COUNT) {
+        return false;
+    }
+    m_pending[m_pendingCount] = e;
+    m_pendingCount = m_pendingCount + 1;
+    return true;
+}
+
+void Hsm::ClearPending(QEvt const *e) {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    for (uint32_t i = 0; i < m_pendingCount; i++) {
+        if (m_pending[i] == e) {
+            // Moves the last one to fill the hole. Order does not matter.
+            m_pendingCount = m_pendingCount - 1;
+            m_pending[i] = m_pending[m_pendingCount];
+            break;
+        }
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+void Hsm::SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRecBase &seqRec) {
     FW_ASSERT(e);
     Sequence seq = GenSeq();
     e->SetTo(to);
@@ -84,7 +128,7 @@ void Hsm::SendReq(Evt *e, Hsmn to, bool reset, EvtSeqRec &seqRec) {
 // @return Handling status - true if the event was handled without error. This includes the event being ignored
 //                           due to sequence number mismatch.
 //                           false if the event matches sequence number and reports an error.
-bool Hsm::CheckCfm(ErrorEvt const &e, bool &allReceived, EvtSeqRec &seqRec) {
+bool Hsm::CheckCfm(ErrorEvt const &e, bool &allReceived, EvtSeqRecBase &seqRec) {
     allReceived = false;
     if (seqRec.Match(e.GetFrom(), e.GetSeq())) {
         if (e.GetError() != ERROR_SUCCESS) {
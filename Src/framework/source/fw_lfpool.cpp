@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#include "fw_lfpool.h"
+#include "fw_assert.h"
+
+FW_DEFINE_THIS_FILE("fw_lfpool.cpp")
+
+namespace FW {
+
+void LfPool::Init(void *stor, uint32_t blockSize, uint32_t blockCount) {
+    FW_ASSERT(stor && (blockSize >= sizeof(uint16_t)) && ((blockSize % 4) == 0) && (blockCount > 0) && (blockCount < NIL));
+    m_stor = static_cast<uint8_t *>(stor);
+    m_blockSize = blockSize;
+    m_blockCount = blockCount;
+    for (uint32_t i = 0; i < blockCount; i++) {
+        Next(i) = (i + 1 < blockCount) ? (i + 1) : static_cast<uint32_t>(NIL);
+    }
+    m_head.store(0);
+    m_freeCount.store(blockCount);
+    m_minFree.store(blockCount);
+    ResetCount();
+}
+
+void *LfPool::Get() {
+    uint32_t head = m_head.load(std::memory_order_acquire);
+    uint32_t next;
+    do {
+        uint32_t index = head & INDEX_MASK;
+        if (index == NIL) {
+            m_failCount.fetch_add(1, std::memory_order_relaxed);
+            return NULL;
+        }
+        // The block may have been taken and overwritten since head was read, in which case next is garbage and
+        // the compare-and-swap below fails since the tag has changed.
+        next = ((head & ~static_cast<uint32_t>(INDEX_MASK)) + TAG_INC) | Next(index);
+    } while (!m_head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire));
+    uint32_t freeCount = m_freeCount.fetch_sub(1, std::memory_order_relaxed) - 1;
+    uint32_t minFree = m_minFree.load(std::memory_order_relaxed);
+    while ((freeCount < minFree) &&
+           !m_minFree.compare_exchange_weak(minFree, freeCount, std::memory_order_relaxed)) {
+    }
+    m_allocCount.fetch_add(1, std::memory_order_relaxed);
+    return m_stor + (head & INDEX_MASK) * m_blockSize;
+}
+
+void LfPool::Put(void *block) {
+    FW_ASSERT(Contains(block));
+    uint32_t offset = static_cast<uint8_t *>(block) - m_stor;
+    FW_ASSERT((offset % m_blockSize) == 0);
+    uint32_t index = offset / m_blockSize;
+    // Counted before the block is pushed so that m_freeCount never drops below the actual count in Get().
+    m_freeCount.fetch_add(1, std::memory_order_relaxed);
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    uint32_t next;
+    do {
+        Next(index) = head & INDEX_MASK;
+        next = ((head & ~static_cast<uint32_t>(INDEX_MASK)) + TAG_INC) | index;
+    } while (!m_head.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+}
+
+} // namespace FW
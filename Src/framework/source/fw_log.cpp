@@ -37,12 +37,13 @@
  ******************************************************************************/
 
 #include <stdarg.h>
-#include <stdio.h>
+#include <string.h>
 #include "bsp.h"
 #include "qpcpp.h"
 #include "fw_hsm.h"
 #include "fw_pipe.h"
 #include "fw_log.h"
+#include "fw_format.h"
 #include "fw.h"
 #include "fw_assert.h"
 
@@ -76,50 +77,128 @@ char const * const Log::m_builtinEvtName[] = {
 };
 char const Log::m_undefName[] = "UNDEF";
 
-Log::EvtSetStor Log::GetEvtSetStor() {
-    // Event names for each HSM. Only the 1st HSM of an event interface is actually used.
-    static EvtSet evtSetStor[MAX_HSM_COUNT];
-    return &evtSetStor;
-}
-
-// Sets up event names for the specified event interface.
-// @param evtHsmn - HSMN of the event interface for which event names are being set up.
-//                  evtHsmn forms the upper bits of an event signal. It is retrieved from
-//                  a signal via the macro GET_EVT_HSMN(signal_).
-// This function is to be called in the constructors of Active or Region objects.
-// By design there is no "Unset/Clear" function. All event names are to be set up
-// to the framework during system initialization (before main()).
-// As a result there is no need to implement critical sections in other API functions using
-// evtSetStor.
-void Log::SetEvtName(Hsmn evtHsmn, EvtName timerEvtName, EvtCount timerEvtCount,
-                    EvtName internalEvtName, EvtCount internalEvtCount,
-                    EvtName interfaceEvtName, EvtCount interfaceEvtCount) {
-    EvtSetStor stor = GetEvtSetStor();
-    FW_ASSERT(stor && (evtHsmn < ARRAY_COUNT(*stor)));
-    QF_CRIT_STAT_TYPE crit;
-    QF_CRIT_ENTRY(crit);
-    (*stor)[evtHsmn].Init(timerEvtName, timerEvtCount, internalEvtName, internalEvtCount, interfaceEvtName, interfaceEvtCount);
-    QF_CRIT_EXIT(crit);
+uint32_t Log::m_truncCount[MAX_HSM_COUNT];
+
+#ifdef ENABLE_LOG_DRAIN
+Hsmn Log::m_drainHsmn = HSM_UNDEF;
+QSignal Log::m_drainSig = 0;
+#endif
+
+#ifdef ENABLE_LOG_BATCH
+uint8_t Log::m_batchStor[1 << BATCH_BUF_ORDER];
+Fifo Log::m_batchFifo(m_batchStor, BATCH_BUF_ORDER);
+uint32_t Log::m_batchDropCount = 0;
+#endif
+
+#ifdef ENABLE_LOG_DEFER
+uint8_t Log::m_deferStor[1 << DEFER_BUF_ORDER];
+Fifo Log::m_deferFifo(m_deferStor, DEFER_BUF_ORDER);
+uint32_t Log::m_deferDropCount = 0;
+
+// Argument classes of the printf conversions supported by deferred logging.
+enum DeferArg {
+    DEFER_ARG_NONE,         // No argument, e.g. "%%" or an unsupported conversion.
+    DEFER_ARG_INT,          // int and smaller types (promoted to int).
+    DEFER_ARG_LONG,
+    DEFER_ARG_LLONG,        // long long and intmax_t.
+    DEFER_ARG_SIZE,         // size_t and ptrdiff_t.
+    DEFER_ARG_DOUBLE,       // double and float (promoted to double).
+    DEFER_ARG_LDOUBLE,
+    DEFER_ARG_PTR,
+    DEFER_ARG_STR,          // Copied into the record with a length prefix.
+};
+
+// Parses a conversion specification. spec points to the character after '%'.
+// @param argType - Class of the value argument.
+// @param starCount - Number of '*' in width and precision, each taking an int argument before the value.
+// @return Pointer to the character after the conversion specifier.
+static char const *ParseSpec(char const *spec, DeferArg &argType, uint32_t &starCount) {
+    char const *p = spec;
+    starCount = 0;
+    while (*p && strchr("-+ #0", *p)) {
+        p++;
+    }
+    for (uint32_t i = 0; i < 2; i++) {
+        if (*p == '*') {
+            starCount++;
+            p++;
+        } else {
+            while ((*p >= '0') && (*p <= '9')) {
+                p++;
+            }
+        }
+        if ((i == 0) && (*p == '.')) {
+            p++;
+        } else {
+            break;
+        }
+    }
+    DeferArg intType = DEFER_ARG_INT;
+    bool longDouble = false;
+    if ((p[0] == 'l') && (p[1] == 'l')) {
+        intType = DEFER_ARG_LLONG;
+        p += 2;
+    } else if (*p == 'l') {
+        intType = DEFER_ARG_LONG;
+        p++;
+    } else if (*p == 'j') {
+        intType = DEFER_ARG_LLONG;
+        p++;
+    } else if ((*p == 'z') || (*p == 't')) {
+        intType = DEFER_ARG_SIZE;
+        p++;
+    } else if (*p == 'L') {
+        longDouble = true;
+        p++;
+    } else {
+        while ((*p == 'h')) {
+            p++;
+        }
+    }
+    switch (*p) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': argType = intType; break;
+        case 'c': argType = DEFER_ARG_INT; break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            argType = longDouble ? DEFER_ARG_LDOUBLE : DEFER_ARG_DOUBLE;
+            break;
+        case 'p': argType = DEFER_ARG_PTR; break;
+        case 's': argType = DEFER_ARG_STR; break;
+        default: {
+            argType = DEFER_ARG_NONE;
+            starCount = 0;
+            return *p ? (p + 1) : p;
+        }
+    }
+    return p + 1;
 }
 
-void Log::SetEvtName(Hsmn evtHsmn, EvtSet::Category cat, EvtName evtName, EvtCount evtCount) {
-    EvtSetStor stor = GetEvtSetStor();
-    FW_ASSERT(stor && (evtHsmn < ARRAY_COUNT(*stor)));
-    QF_CRIT_STAT_TYPE crit;
-    QF_CRIT_ENTRY(crit);
-    (*stor)[evtHsmn].Init(cat, evtName, evtCount);
-    QF_CRIT_EXIT(crit);
+template <class T>
+static bool DeferPut(uint8_t *rec, uint32_t &len, uint32_t maxLen, T const &v) {
+    if ((len + sizeof(v)) > maxLen) {
+        return false;
+    }
+    memcpy(&rec[len], &v, sizeof(v));
+    len += sizeof(v);
+    return true;
 }
 
+template <class T>
+static bool DeferGet(uint8_t const *arg, uint32_t argLen, uint32_t &index, T &v) {
+    if ((index + sizeof(v)) > argLen) {
+        return false;
+    }
+    memcpy(&v, &arg[index], sizeof(v));
+    index += sizeof(v);
+    return true;
+}
+#endif // ENABLE_LOG_DEFER
+
 char const *Log::GetEvtName(QSignal signal) {
     if (signal < Q_USER_SIG) {
         return GetBuiltinEvtName(signal);
     }
-    EvtSetStor stor = GetEvtSetStor();
-    Hsmn hsmn = GET_EVT_HSMN(signal);
-    FW_ASSERT(stor && (hsmn < ARRAY_COUNT(*stor)));
-    EvtSet const &evtSet = (*stor)[hsmn];
-    return evtSet.Get(signal);
+    EvtSet const *evtSet = evtSetTable.Get(GET_EVT_HSMN(signal));
+    return evtSet ? evtSet->Get(signal) : GetUndefName();
 }
 
 char const *Log::GetBuiltinEvtName(QP::QSignal signal) {
@@ -181,34 +260,51 @@ uint32_t Log::Write(Hsmn infHsmn, char const *buf, uint32_t len) {
     return result;
 }
 
-// @description Writes to all "default" interfaces. If a FIFO is full, the message is truncated.
+// The interface map is walked by index with the critical section held per entry only. RemoveInterface() may then
+// shift an entry back from an index already visited to one not yet visited, or wrap one around past index 0.
+// The latter is missed, which is fine as with an interface added during the walk. The former would be visited
+// twice, so written keeps track of interfaces written to. Must be called in a critical section.
+static bool WrittenBefore(Bitset &written, Hsmn infHsmn) {
+    if (written.IsSet(infHsmn)) {
+        return true;
+    }
+    written.Set(infHsmn);
+    return false;
+}
+
+// @description Writes to all "default" interfaces. If a FIFO is full, the message is discarded and counted
+//              in the truncation count of the interface (see GetTruncCount()).
 // @param buf - Pointer to byte buffer.
 // @param len - Length in bytes.
 void Log::WriteDefault(char const *buf, uint32_t len) {
+#ifdef ENABLE_LOG_BATCH
+    if (IsDrainOn()) {
+        BatchWrite(buf, len);
+        return;
+    }
+#endif
     uint32_t writeCount = 0;
+    // Interfaces written to. See WrittenBefore().
+    uint32_t writtenStor[ROUND_UP_DIV(MAX_HSM_COUNT, 32)];
+    Bitset written(writtenStor, ARRAY_COUNT(writtenStor), MAX_HSM_COUNT);
     uint32_t index = m_hsmnInfMap.GetTotalCount();
     while (index--) {
         HsmnInf *kv = m_hsmnInfMap.GetByIndex(index);
         // Maintain critical section within loop to reduce interrupt latency.
-        // Okay to miss a new entry after passing its index.
         QF_CRIT_STAT_TYPE crit;
         QF_CRIT_ENTRY(crit);
         Hsmn infHsmn = kv->GetKey();
-        if ((infHsmn != HSM_UNDEF) && (kv->GetValue().IsDefault())) {
+        if ((infHsmn != HSM_UNDEF) && (kv->GetValue().IsDefault()) && !WrittenBefore(written, infHsmn)) {
             Fifo *fifo = kv->GetValue().GetFifo();
             FW_ASSERT(fifo);
-            bool status1 = false;
-            bool status2 = false;
-            if (fifo->IsTruncated()) {
-                fifo->WriteNoCrit(reinterpret_cast<uint8_t const *>(m_truncatedError), CONST_STRING_LEN(m_truncatedError), &status1);
-            }
-            if (!fifo->IsTruncated()) {
-                fifo->WriteNoCrit(reinterpret_cast<uint8_t const *>(buf), len, &status2);
+            QSignal sig = kv->GetValue().GetSig();
+            bool status = false;
+            if ((fifo->WriteNoCrit(reinterpret_cast<uint8_t const *>(buf), len, &status) == 0) && len) {
+                m_truncCount[infHsmn]++;
             }
             QF_CRIT_EXIT(crit);
             // Post MUST be outside critical section.
-            if (status1 || status2) {
-                QSignal sig = kv->GetValue().GetSig();
+            if (status) {
                 FW_ASSERT(sig);
                 Fw::Post(new Evt(sig, infHsmn));
             }
@@ -253,7 +349,7 @@ uint32_t Log::Print(Hsmn infHsmn, char const *format, ...) {
     va_list arg;
     va_start(arg, format);
     char buf[BUF_LEN];
-    uint32_t len = vsnprintf(buf, sizeof(buf), format, arg);
+    uint32_t len = Format::PrintV(buf, sizeof(buf), format, arg);
     va_end(arg);
     len = LESS(len, sizeof(buf) - 1);
     return Write(infHsmn, buf, len);
@@ -265,7 +361,7 @@ uint32_t Log::PrintItem(Hsmn infHsmn, uint32_t index, uint32_t minWidth, uint32_
     char buf[BUF_LEN];
     // Reserve 2 bytes for newline.
     const uint32_t MAX_LEN = sizeof(buf) - 2;
-    uint32_t len = vsnprintf(buf, MAX_LEN, format, arg);
+    uint32_t len = Format::PrintV(buf, MAX_LEN, format, arg);
     va_end(arg);
     len = LESS(len, (MAX_LEN - 1));
     if (len < (MAX_LEN - 1)) {
@@ -311,10 +407,10 @@ void Log::FloatToStr(char *buf, uint32_t bufSize, float v, uint32_t totalWidth,
         for (uint32_t i = 0; i < padWidth; i++) {
             buf[i] = ' ';
         }
-        snprintf(buf + padWidth, bufSize - padWidth, "-0.%0*ld", static_cast<int>(decimalPlaces), static_cast<int32_t>(d));
+        Format::Print(buf + padWidth, bufSize - padWidth, "-0.%0*ld", static_cast<int>(decimalPlaces), static_cast<int32_t>(d));
 
     } else {
-        snprintf(buf, bufSize, "%*ld.%0*ld", intWidth, static_cast<int32_t>(v),
+        Format::Print(buf, bufSize, "%*ld.%0*ld", intWidth, static_cast<int32_t>(v),
                  static_cast<int>(decimalPlaces), static_cast<int32_t>(d));
     }
 }
@@ -329,6 +425,22 @@ void Log::Event(Type type, Hsmn hsmn, QP::QEvt const *e, char const *func) {
     if (!IsOutput(type, hsmn)) {
         return;
     }
+#ifdef ENABLE_LOG_DEFER
+    if (IsDrainOn()) {
+        DeferHdr hdr = { sizeof(DeferHdr) + sizeof(DeferEvt), DEFER_EVENT, static_cast<uint8_t>(type), hsmn, GetSystemMs(), func };
+        DeferEvt evt = { e->sig, false, HSM_UNDEF, 0, ERROR_SUCCESS, HSM_UNDEF, 0 };
+        if (IS_EVT_HSMN_VALID(e->sig) && !IS_TIMER_EVT(e->sig)) {
+            evt.hasFrom = true;
+            evt.from = static_cast<Evt const *>(e)->GetFrom();
+            evt.seq = static_cast<Evt const *>(e)->GetSeq();
+        }
+        uint8_t rec[sizeof(hdr) + sizeof(evt)];
+        memcpy(rec, &hdr, sizeof(hdr));
+        memcpy(&rec[sizeof(hdr)], &evt, sizeof(evt));
+        DeferWrite(rec, sizeof(rec));
+        return;
+    }
+#endif
     if (IS_EVT_HSMN_VALID(e->sig) && !IS_TIMER_EVT(e->sig)) {
         Evt const *evt = static_cast<Evt const *>(e);
         Hsmn from = evt->GetFrom();
@@ -346,6 +458,17 @@ void Log::ErrorEvent(Type type, Hsmn hsmn, ErrorEvt const &e, char const *func)
     if (!IsOutput(type, hsmn)) {
         return;
     }
+#ifdef ENABLE_LOG_DEFER
+    if (IsDrainOn()) {
+        DeferHdr hdr = { sizeof(DeferHdr) + sizeof(DeferEvt), DEFER_ERROR_EVENT, static_cast<uint8_t>(type), hsmn, GetSystemMs(), func };
+        DeferEvt evt = { e.sig, true, e.GetFrom(), e.GetSeq(), e.GetError(), e.GetOrigin(), e.GetReason() };
+        uint8_t rec[sizeof(hdr) + sizeof(evt)];
+        memcpy(rec, &hdr, sizeof(hdr));
+        memcpy(&rec[sizeof(hdr)], &evt, sizeof(evt));
+        DeferWrite(rec, sizeof(rec));
+        return;
+    }
+#endif
     Hsmn from = e.GetFrom();
     Hsmn origin = e.GetOrigin();
     Print(HSM_UNDEF, "%lu %s(%u): %s %s from %s(%d) seq=%d error=%d origin=%s(%d) reason=%d\n\r",
@@ -359,16 +482,25 @@ void Log::Debug(Type type, Hsmn hsmn, char const *format, ...) {
     if (!IsOutput(type, hsmn)) {
         return;
     }
+#ifdef ENABLE_LOG_DEFER
+    if (IsDrainOn()) {
+        va_list arg;
+        va_start(arg, format);
+        DeferDebug(type, hsmn, format, arg);
+        va_end(arg);
+        return;
+    }
+#endif
     char buf[BUF_LEN];
     // Reserve 2 bytes for newline.
     const uint32_t MAX_LEN = sizeof(buf) - 2;
     // Note there is no space after type name.
-    uint32_t len = snprintf(buf, MAX_LEN, "%lu %s(%u): %s", GetSystemMs(), hsm->GetName(), hsmn, GetTypeName(type));
+    uint32_t len = Format::Print(buf, MAX_LEN, "%lu %s(%u): %s", GetSystemMs(), hsm->GetName(), hsmn, GetTypeName(type));
     len = LESS(len, (MAX_LEN - 1));
     if (len < (MAX_LEN - 1)) {
         va_list arg;
         va_start(arg, format);
-        len += vsnprintf(&buf[len], MAX_LEN - len, format, arg);
+        len += Format::PrintV(&buf[len], MAX_LEN - len, format, arg);
         va_end(arg);
         len = LESS(len, MAX_LEN - 1);
     }
@@ -384,18 +516,18 @@ uint32_t Log::PrintBufLine(Hsmn infHsmn, uint8_t const *lineBuf, uint32_t lineLe
     // Reserve 2 bytes for newline.
     const uint32_t MAX_LEN = sizeof(buf) - 2;
     // Print label.
-    uint32_t len = snprintf(buf, MAX_LEN, "[0x%.8lx] ", lineLabel);
+    uint32_t len = Format::Print(buf, MAX_LEN, "[0x%.8lx] ", lineLabel);
     len = LESS(len, MAX_LEN - 1);
     // Print hex data.
     uint8_t i = 0;
     for (i = 0; i < lineLen; i += unit) {
         if (len < (MAX_LEN - 1)) {
             if (unit == 1) {
-                len += snprintf(&buf[len], MAX_LEN - len, "%.2x ", lineBuf[i]);
+                len += Format::Print(&buf[len], MAX_LEN - len, "%.2x ", lineBuf[i]);
             } else if (unit == 2) {
-                len += snprintf(&buf[len], MAX_LEN - len, "%.4x ", *((uint16_t *)&lineBuf[i]));
+                len += Format::Print(&buf[len], MAX_LEN - len, "%.4x ", *((uint16_t *)&lineBuf[i]));
             } else {
-                len += snprintf(&buf[len], MAX_LEN - len, "%.8lx ", *((uint32_t *)&lineBuf[i]));
+                len += Format::Print(&buf[len], MAX_LEN - len, "%.8lx ", *((uint32_t *)&lineBuf[i]));
             }
             len = LESS(len, MAX_LEN - 1);
         }
@@ -429,7 +561,7 @@ uint32_t Log::PrintBufLine(Hsmn infHsmn, uint8_t const *lineBuf, uint32_t lineLe
 // @return Number of raw data bytes in dataBuf written. It is NOT the length of the formatted strings written.
 uint32_t Log::PrintBuf(Hsmn infHsmn, uint8_t const *dataBuf, uint32_t dataLen, uint8_t unit, uint32_t label) {
     FW_ASSERT((unit == 1) || (unit == 2) || (unit == 4));
-    FW_ASSERT(dataBuf && (((uint32_t)dataBuf % unit) == 0) && ((dataLen % unit) == 0) && ((BYTE_PER_LINE % unit) == 0));
+    FW_ASSERT(dataBuf && (((uintptr_t)dataBuf % unit) == 0) && ((dataLen % unit) == 0) && ((BYTE_PER_LINE % unit) == 0));
     Print(infHsmn, "Buffer 0x%.8x len %lu:\n\r", dataBuf, dataLen);
     uint32_t dataIndex = 0;
     while (dataIndex < dataLen) {
@@ -481,9 +613,6 @@ void Log::OffAll() {
     QF_CRIT_EXIT(crit);
 }
 
-bool Log::IsOutput(Type type, Hsmn hsmn) {
-    return (type < m_verbosity) && IsOn(hsmn);
-}
 
 // Must allow HSM_UNDEF since the "m_from" hsmn of an event is optional
 // (e.g. an internal event or event sent from main).
@@ -500,6 +629,12 @@ char const *Log::GetTypeName(Type type) {
     return m_typeName[type];
 }
 
+void Log::SetState(Hsmn hsmn, char const *state) {
+    Hsm *hsm = Fw::GetHsm(hsmn);
+    FW_ASSERT(hsm && state);
+    hsm->SetState(state);
+}
+
 char const *Log::GetState(Hsmn hsmn) {
     Hsm *hsm = Fw::GetHsm(hsmn);
     if (!hsm) {
@@ -508,4 +643,322 @@ char const *Log::GetState(Hsmn hsmn) {
     return hsm->GetState();
 }
 
+uint32_t Log::GetTruncCount(Hsmn infHsmn) {
+    FW_ASSERT(infHsmn < ARRAY_COUNT(m_truncCount));
+    return m_truncCount[infHsmn];
+}
+
+void Log::ResetTruncCount() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    memset(m_truncCount, 0, sizeof(m_truncCount));
+#ifdef ENABLE_LOG_BATCH
+    m_batchDropCount = 0;
+#endif
+#ifdef ENABLE_LOG_DEFER
+    m_deferDropCount = 0;
+#endif
+    QF_CRIT_EXIT(crit);
+}
+
+#ifdef ENABLE_LOG_DRAIN
+
+void Log::SetDrain(Hsmn drainHsmn, QSignal sig) {
+    FW_ASSERT((drainHsmn == HSM_UNDEF) || sig);
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    m_drainHsmn = drainHsmn;
+    m_drainSig = sig;
+    bool pending = false;
+#ifdef ENABLE_LOG_DEFER
+    pending |= (m_deferFifo.GetUsedCountNoCrit() != 0);
+#endif
+#ifdef ENABLE_LOG_BATCH
+    pending |= (m_batchFifo.GetUsedCountNoCrit() != 0);
+#endif
+    QF_CRIT_EXIT(crit);
+    if (drainHsmn == HSM_UNDEF) {
+#ifdef ENABLE_LOG_BATCH
+        // Staged output goes first to keep the order. Records drained below are written directly.
+        Flush();
+#endif
+#ifdef ENABLE_LOG_DEFER
+        while (Drain()) {}
+#endif
+    } else if (pending) {
+        Fw::Post(new Evt(sig, drainHsmn));
+    }
+}
+
+#endif // ENABLE_LOG_DRAIN
+
+#ifdef ENABLE_LOG_BATCH
+
+// Writes a whole message to the staging buffer or discards it if the buffer is full. The drain HSM is notified
+// when the buffer becomes non-empty, which starts a batch interval, and when it rises to BATCH_THRESHOLD.
+void Log::BatchWrite(char const *buf, uint32_t len) {
+    bool status = false;
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    uint32_t used = m_batchFifo.GetUsedCountNoCrit();
+    if ((m_batchFifo.WriteNoCrit(reinterpret_cast<uint8_t const *>(buf), len, &status) == 0) && len) {
+        m_batchDropCount++;
+    } else if ((used < BATCH_THRESHOLD) && ((used + len) >= BATCH_THRESHOLD)) {
+        status = true;
+    }
+    Hsmn drainHsmn = m_drainHsmn;
+    QSignal drainSig = m_drainSig;
+    QF_CRIT_EXIT(crit);
+    // Post MUST be outside critical section.
+    if (status && (drainHsmn != HSM_UNDEF)) {
+        Fw::Post(new Evt(drainSig, drainHsmn));
+    }
+}
+
+// Room and truncation are handled per interface. Each interface takes as much of the batch as fits in its FIFO
+// and the rest is discarded for that interface only and counted in its truncation count (see GetTruncCount()).
+// The whole batch is consumed, so an interface that is not draining does not hold back the others.
+bool Log::Flush() {
+    PipeSpan<uint8_t> span;
+    // The drain HSM is the only consumer, so peeked data stays valid until consumed.
+    uint32_t count = m_batchFifo.Peek(span, m_batchFifo.GetUsedCount());
+    if (count == 0) {
+        return true;
+    }
+    uint32_t infCount = 0;
+    // Posts at most one notification per interface for the whole batch.
+    uint32_t writtenStor[ROUND_UP_DIV(MAX_HSM_COUNT, 32)];
+    Bitset written(writtenStor, ARRAY_COUNT(writtenStor), MAX_HSM_COUNT);
+    uint32_t index = m_hsmnInfMap.GetTotalCount();
+    while (index--) {
+        HsmnInf *kv = m_hsmnInfMap.GetByIndex(index);
+        QF_CRIT_STAT_TYPE crit;
+        QF_CRIT_ENTRY(crit);
+        Hsmn infHsmn = kv->GetKey();
+        if ((infHsmn != HSM_UNDEF) && (kv->GetValue().IsDefault()) && !WrittenBefore(written, infHsmn)) {
+            Fifo *fifo = kv->GetValue().GetFifo();
+            FW_ASSERT(fifo);
+            QSignal sig = kv->GetValue().GetSig();
+            bool status = false;
+            uint32_t infLen = LESS(count, fifo->GetAvailCountNoCrit());
+            if (infLen < count) {
+                m_truncCount[infHsmn]++;
+            }
+            uint32_t len0 = LESS(infLen, span.GetCount(0));
+            if (len0) {
+                fifo->WriteNoCrit(span.GetPtr(0), len0, &status);
+            }
+            if (infLen > len0) {
+                fifo->WriteNoCrit(span.GetPtr(1), infLen - len0);
+            }
+            QF_CRIT_EXIT(crit);
+            // Post MUST be outside critical section.
+            if (status) {
+                FW_ASSERT(sig);
+                Fw::Post(new Evt(sig, infHsmn));
+            }
+            infCount++;
+        } else {
+            QF_CRIT_EXIT(crit);
+        }
+    }
+    if (infCount == 0) {
+        // Gallium - If no FIFO has been setup, write to BSP usart directly.
+        for (uint32_t i = 0; i < span.GetBlockCount(); i++) {
+            BspWrite(reinterpret_cast<char const *>(span.GetPtr(i)), span.GetCount(i));
+        }
+    }
+    m_batchFifo.Consume(count);
+    return m_batchFifo.GetUsedCount() == 0;
+}
+
+#endif // ENABLE_LOG_BATCH
+
+#ifdef ENABLE_LOG_DEFER
+
+// Writes a whole record or discards it if the ring buffer is full.
+void Log::DeferWrite(uint8_t const *rec, uint32_t len) {
+    bool status = false;
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    if (m_deferFifo.WriteNoCrit(rec, len, &status) == 0) {
+        m_deferDropCount++;
+    }
+    Hsmn drainHsmn = m_drainHsmn;
+    QSignal drainSig = m_drainSig;
+    QF_CRIT_EXIT(crit);
+    // Post MUST be outside critical section.
+    if (status && (drainHsmn != HSM_UNDEF)) {
+        Fw::Post(new Evt(drainSig, drainHsmn));
+    }
+}
+
+// Stores the raw arguments as indicated by the conversions in format. Strings are copied (up to DEFER_STR_LEN - 1
+// characters) since they may not outlive the call. The format string itself must be static (e.g. a literal).
+void Log::DeferDebug(Type type, Hsmn hsmn, char const *format, va_list arg) {
+    FW_ASSERT(format);
+    uint8_t rec[DEFER_REC_LEN];
+    uint32_t len = sizeof(DeferHdr);
+    bool full = false;
+    char const *p = format;
+    while (!full && (p = strchr(p, '%'))) {
+        DeferArg argType;
+        uint32_t starCount;
+        p = ParseSpec(p + 1, argType, starCount);
+        while (starCount--) {
+            full |= !DeferPut(rec, len, sizeof(rec), va_arg(arg, int));
+        }
+        switch (argType) {
+            case DEFER_ARG_INT: full |= !DeferPut(rec, len, sizeof(rec), va_arg(arg, int)); break;
+            case DEFER_ARG_LONG: full |= !DeferPut(rec, len, sizeof(rec), va_arg(arg, long)); break;
+            case DEFER_ARG_LLONG: full |= !DeferPut(rec, len, sizeof(rec), va_arg(arg, long long)); break;
+            case DEFER_ARG_SIZE: full |= !DeferPut(rec, len, sizeof(rec), va_arg(arg, size_t)); break;
+            case DEFER_ARG_DOUBLE: full |= !DeferPut(rec, len, sizeof(rec), va_arg(arg, double)); break;
+            case DEFER_ARG_LDOUBLE: full |= !DeferPut(rec, len, sizeof(rec), va_arg(arg, long double)); break;
+            case DEFER_ARG_PTR: full |= !DeferPut(rec, len, sizeof(rec), va_arg(arg, void *)); break;
+            case DEFER_ARG_STR: {
+                char const *str = va_arg(arg, char const *);
+                str = str ? str : "(null)";
+                uint8_t strLen = 0;
+                while ((strLen < (DEFER_STR_LEN - 1)) && str[strLen]) {
+                    strLen++;
+                }
+                full |= !DeferPut(rec, len, sizeof(rec), strLen);
+                if (!full) {
+                    strLen = LESS(strLen, sizeof(rec) - len);
+                    memcpy(&rec[len], str, strLen);
+                    len += strLen;
+                }
+                break;
+            }
+            default: break;
+        }
+    }
+    DeferHdr hdr = { static_cast<uint16_t>(len), DEFER_DEBUG, static_cast<uint8_t>(type), hsmn, GetSystemMs(), format };
+    memcpy(rec, &hdr, sizeof(hdr));
+    DeferWrite(rec, len);
+}
+
+// Formats a DEFER_DEBUG record. Each conversion is formatted separately with its stored argument.
+// If the record was cut short by DEFER_REC_LEN, output stops with the truncation marker.
+uint32_t Log::FormatDebug(char *buf, uint32_t bufLen, char const *format, uint8_t const *arg, uint32_t argLen) {
+    FW_ASSERT(buf && (bufLen > 0) && format && arg);
+    uint32_t len = 0;
+    uint32_t index = 0;
+    char const *p = format;
+    while (*p && (len < (bufLen - 1))) {
+        if (*p != '%') {
+            buf[len++] = *p++;
+            continue;
+        }
+        char const *start = p;
+        DeferArg argType;
+        uint32_t starCount;
+        p = ParseSpec(p + 1, argType, starCount);
+        if (argType == DEFER_ARG_NONE) {
+            // "%%" or an unsupported conversion.
+            char const *text = ((p - start) == 2) && (start[1] == '%') ? (start + 1) : start;
+            while ((text < p) && (len < (bufLen - 1))) {
+                buf[len++] = *text++;
+            }
+            continue;
+        }
+        // Rebuilds the conversion with '*' replaced by the stored width or precision.
+        char spec[32];
+        uint32_t specLen = 0;
+        bool ok = true;
+        for (char const *s = start; (s < p) && (specLen < (sizeof(spec) - 12)); s++) {
+            if (*s == '*') {
+                int v;
+                ok = ok && DeferGet(arg, argLen, index, v);
+                specLen += Format::Print(&spec[specLen], sizeof(spec) - specLen, "%d", ok ? v : 0);
+            } else {
+                spec[specLen++] = *s;
+            }
+        }
+        spec[specLen] = 0;
+        uint32_t avail = bufLen - len;
+        int n = 0;
+        switch (argType) {
+            case DEFER_ARG_INT: { int v; if ((ok = ok && DeferGet(arg, argLen, index, v))) { n = Format::Print(&buf[len], avail, spec, v); } break; }
+            case DEFER_ARG_LONG: { long v; if ((ok = ok && DeferGet(arg, argLen, index, v))) { n = Format::Print(&buf[len], avail, spec, v); } break; }
+            case DEFER_ARG_LLONG: { long long v; if ((ok = ok && DeferGet(arg, argLen, index, v))) { n = Format::Print(&buf[len], avail, spec, v); } break; }
+            case DEFER_ARG_SIZE: { size_t v; if ((ok = ok && DeferGet(arg, argLen, index, v))) { n = Format::Print(&buf[len], avail, spec, v); } break; }
+            case DEFER_ARG_DOUBLE: { double v; if ((ok = ok && DeferGet(arg, argLen, index, v))) { n = Format::Print(&buf[len], avail, spec, v); } break; }
+            case DEFER_ARG_LDOUBLE: { long double v; if ((ok = ok && DeferGet(arg, argLen, index, v))) { n = Format::Print(&buf[len], avail, spec, v); } break; }
+            case DEFER_ARG_PTR: { void *v; if ((ok = ok && DeferGet(arg, argLen, index, v))) { n = Format::Print(&buf[len], avail, spec, v); } break; }
+            case DEFER_ARG_STR: {
+                uint8_t strLen;
+                char str[DEFER_STR_LEN];
+                if ((ok = ok && DeferGet(arg, argLen, index, strLen))) {
+                    strLen = LESS(strLen, LESS(sizeof(str) - 1, argLen - index));
+                    memcpy(str, &arg[index], strLen);
+                    str[strLen] = 0;
+                    index += strLen;
+                    n = Format::Print(&buf[len], avail, spec, str);
+                }
+                break;
+            }
+            default: break;
+        }
+        if (!ok) {
+            n = Format::Print(&buf[len], avail, "%s", m_truncatedError);
+        }
+        len += LESS(static_cast<uint32_t>(GREATER(n, 0)), avail - 1);
+        if (!ok) {
+            break;
+        }
+    }
+    buf[len] = 0;
+    return len;
+}
+
+bool Log::Drain() {
+    uint8_t rec[DEFER_REC_LEN];
+    DeferHdr hdr;
+    // There is a single consumer and a record is written as a whole, so a header implies the whole record.
+    if (m_deferFifo.Read(rec, sizeof(hdr)) == 0) {
+        return false;
+    }
+    memcpy(&hdr, rec, sizeof(hdr));
+    FW_ASSERT((hdr.len >= sizeof(hdr)) && (hdr.len <= sizeof(rec)));
+    uint32_t bodyLen = hdr.len - sizeof(hdr);
+    uint32_t readLen = m_deferFifo.Read(&rec[sizeof(hdr)], bodyLen);
+    FW_ASSERT(readLen == bodyLen);
+    uint8_t const *body = &rec[sizeof(hdr)];
+    Type type = static_cast<Type>(hdr.type);
+    if (hdr.kind == DEFER_DEBUG) {
+        char buf[BUF_LEN];
+        // Reserve 2 bytes for newline.
+        const uint32_t MAX_LEN = sizeof(buf) - 2;
+        uint32_t len = Format::Print(buf, MAX_LEN, "%lu %s(%u): %s", hdr.time, GetHsmName(hdr.hsmn), hdr.hsmn, GetTypeName(type));
+        len = LESS(len, (MAX_LEN - 1));
+        if (len < (MAX_LEN - 1)) {
+            len += FormatDebug(&buf[len], MAX_LEN - len, hdr.str, body, bodyLen);
+        }
+        FW_ASSERT(len <= (sizeof(buf) - 3));
+        buf[len++] = '\n';
+        buf[len++] = '\r';
+        buf[len] = 0;
+        Write(HSM_UNDEF, buf, len);
+    } else {
+        DeferEvt evt;
+        FW_ASSERT(bodyLen == sizeof(evt));
+        memcpy(&evt, body, sizeof(evt));
+        if (hdr.kind == DEFER_ERROR_EVENT) {
+            Print(HSM_UNDEF, "%lu %s(%u): %s %s from %s(%d) seq=%d error=%d origin=%s(%d) reason=%d\n\r",
+                  hdr.time, GetHsmName(hdr.hsmn), hdr.hsmn, hdr.str, GetEvtName(evt.sig), GetHsmName(evt.from), evt.from,
+                  evt.seq, evt.error, GetHsmName(evt.origin), evt.origin, evt.reason);
+        } else if (evt.hasFrom) {
+            Print(HSM_UNDEF, "%lu %s(%u): %s %s from %s(%d) seq=%d\n\r",
+                  hdr.time, GetHsmName(hdr.hsmn), hdr.hsmn, hdr.str, GetEvtName(evt.sig), GetHsmName(evt.from), evt.from, evt.seq);
+        } else {
+            Print(HSM_UNDEF, "%lu %s(%u): %s %s\n\r", hdr.time, GetHsmName(hdr.hsmn), hdr.hsmn, hdr.str, GetEvtName(evt.sig));
+        }
+    }
+    return true;
+}
+
+#endif // ENABLE_LOG_DEFER
+
 } // namespace FW
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#include "qpcpp.h"
+#include "fw.h"
+#include "fw_payload.h"
+#include "fw_assert.h"
+
+FW_DEFINE_THIS_FILE("fw_payload.cpp")
+
+using namespace QP;
+
+namespace FW {
+
+Payload Payload::m_pool[BUF_COUNT];
+Payload *Payload::m_freeList = NULL;
+uint32_t Payload::m_freeCount = 0;
+uint32_t Payload::m_minFree = 0;
+uint32_t Payload::m_allocCount = 0;
+uint32_t Payload::m_failCount = 0;
+
+// Called by Fw::Init().
+void Payload::Init() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    m_freeList = NULL;
+    for (uint32_t i = BUF_COUNT; i > 0; i--) {
+        m_pool[i - 1].m_refCount = 0;
+        m_pool[i - 1].m_next = m_freeList;
+        m_freeList = &m_pool[i - 1];
+    }
+    m_freeCount = BUF_COUNT;
+    m_minFree = BUF_COUNT;
+    m_allocCount = 0;
+    m_failCount = 0;
+    QF_CRIT_EXIT(crit);
+}
+
+Payload *Payload::New() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    Payload *p = m_freeList;
+    if (p) {
+        m_freeList = p->m_next;
+        p->m_next = NULL;
+        p->m_refCount = 1;
+        if (--m_freeCount < m_minFree) {
+            m_minFree = m_freeCount;
+        }
+        m_allocCount++;
+    } else {
+        m_failCount++;
+    }
+    QF_CRIT_EXIT(crit);
+    FW_ASSERT(p);
+    return p;
+}
+
+void Payload::Ref() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    FW_ASSERT(m_refCount > 0);
+    m_refCount++;
+    QF_CRIT_EXIT(crit);
+}
+
+void Payload::Release() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    FW_ASSERT(m_refCount > 0);
+    if (--m_refCount == 0) {
+        m_next = m_freeList;
+        m_freeList = this;
+        m_freeCount++;
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+void Payload::AttachTo(QEvt const *e) {
+    Ref();
+    Fw::AttachPayload(e, this);
+}
+
+void Payload::GetUsage(Usage &usage) {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    usage.freeCount = m_freeCount;
+    usage.minFree = m_minFree;
+    usage.allocCount = m_allocCount;
+    usage.failCount = m_failCount;
+    QF_CRIT_EXIT(crit);
+}
+
+void Payload::ResetUsage() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    m_allocCount = 0;
+    m_failCount = 0;
+    QF_CRIT_EXIT(crit);
+}
+
+} // namespace FW
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#include "qpcpp.h"
+#include "fw_prof.h"
+#include "fw_assert.h"
+
+FW_DEFINE_THIS_FILE("fw_prof.cpp")
+
+using namespace QP;
+
+namespace FW {
+
+#ifdef ENABLE_FW_PROF
+
+Prof::ProfKV Prof::m_stor[ENTRY_COUNT];
+// Key 0 is unused since HSM_UNDEF is 0 and signal 0 is reserved.
+HashMap<uint32_t, Prof::Stat> Prof::m_map(m_stor, ARRAY_COUNT(m_stor), ProfKV(0, Stat()));
+uint32_t Prof::m_dropCount = 0;
+
+void Prof::Record(Hsmn hsmn, QSignal sig, uint32_t cycles) {
+    uint32_t key = GetKey(hsmn, sig);
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    ProfKV *kv = m_map.GetByKey(key);
+    if (kv) {
+        Stat stat = kv->GetValue();
+        stat.Add(cycles);
+        kv->SetValue(stat);
+    } else if (m_map.GetUsedCount() < MAX_USED_COUNT) {
+        Stat stat;
+        stat.Add(cycles);
+        m_map.Save(ProfKV(key, stat));
+    } else {
+        m_dropCount++;
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+void Prof::Reset() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    m_map.Reset();
+    m_dropCount = 0;
+    QF_CRIT_EXIT(crit);
+}
+
+bool Prof::Get(uint32_t index, Hsmn &hsmn, QSignal &sig, Stat &stat) {
+    FW_ASSERT(index < ENTRY_COUNT);
+    bool used = false;
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    ProfKV *kv = m_map.GetByIndex(index);
+    if (kv->GetKey() != m_map.GetUnusedKey()) {
+        hsmn = static_cast<Hsmn>(kv->GetKey() >> 16);
+        sig = static_cast<QSignal>(kv->GetKey() & 0xFFFF);
+        stat = kv->GetValue();
+        used = true;
+    }
+    QF_CRIT_EXIT(crit);
+    return used;
+}
+
+#endif // ENABLE_FW_PROF
+
+} // namespace FW
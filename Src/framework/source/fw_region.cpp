@@ -40,6 +40,8 @@
 #include "fw_region.h"
 #include "fw_active.h"
 #include "fw_xthread.h"
+#include "fw.h"
+#include "fw_prof.h"
 #include "fw_assert.h"
 
 FW_DEFINE_THIS_FILE("fw_region.cpp")
@@ -48,7 +50,7 @@ using namespace QP;
 
 namespace FW {
 
-void Region::Init(Active *container) {
+void RegionBase::Init(ActiveBase *container) {
     FW_ASSERT(container);
     m_container = container;
     container->Add(this);
@@ -56,7 +58,7 @@ void Region::Init(Active *container) {
     QHsm::init(0);
 }
 
-void Region::Init(XThread *container) {
+void RegionBase::Init(XThread *container) {
     FW_ASSERT(container);
     m_container = container;
     container->Add(this);
@@ -64,17 +66,21 @@ void Region::Init(XThread *container) {
     QHsm::init(0);
 }
 
-void Region::Dispatch(QEvt const * const e) {
+void RegionBase::Dispatch(QEvt const * const e) {
     // For region, e can be from the container active object's event queue (dynamic or static/timer),
     // or be a static event on the stack of the container active object.
     // Garbage collection, if needed, is done by the caller.
+    m_hsm.OnDispatch(e);
+    FW_PROF_START();
     QHsm::dispatch(e, 0);
+    FW_PROF_END(m_hsm.GetHsmn(), e->sig);
     // Handle all reminder events generated as a result of e.
     m_hsm.DispatchReminder();
 }
 
-void Region::PostSync(Evt const *e) {
+void RegionBase::PostSync(Evt const *e) {
     FW_ASSERT(e && m_container);
+    FW_LAT_POST(e);
     m_container->postLIFO(e);
 }
 
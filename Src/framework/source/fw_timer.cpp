@@ -54,21 +54,51 @@ namespace FW {
 // The signal is set to Q_USER_SIG in case the QTimeEvt constructor asserts (signal >= Q_USER_SIG).
 Timer const CANCELED_TIMER(HSM_UNDEF, Q_USER_SIG);
 
+#ifdef ENABLE_FW_TIMER_WHEEL
+TimerWheel Timer::m_wheel[QF_MAX_TICK_RATE];
+#endif
+
 // Allow hsmn == HSM_UNDEF. In that case GetContainer() returns NULL.
-Timer::Timer(Hsmn hsmn, QP::QSignal signal, uint8_t tickRate, uint32_t msPerTick) :
+Timer::Timer(Hsmn hsmn, QP::QSignal signal, uint8_t tickRate) :
     // QP requires an active object to be provided along with tickRate, which is not available during construction.
     // A placeholder is used here and it will be set in Start().
-    QTimeEvt(NULL, signal, tickRate), m_hsmn(hsmn), m_msPerTick(msPerTick) {}
+    QTimeEvt(NULL, signal, tickRate), m_hsmn(hsmn), m_usPerTick(BSP_USEC_PER_TICK(tickRate)), m_tickRate(tickRate),
+    m_tickPerMs((m_usPerTick && ((1000 % m_usPerTick) == 0)) ? (1000 / m_usPerTick) : 0) {
+#ifdef ENABLE_FW_TIMER_WHEEL
+    m_entry.evt = this;
+#endif
+}
 
+// Cortex-M4 has no 64-bit divide instruction, so 64-bit math is only used when a millisecond is not a whole number
+// of ticks.
 void Timer::Start(uint32_t timeoutMs, Type type) {
+    if (m_tickPerMs) {
+        StartTick(timeoutMs * m_tickPerMs, type);
+    } else {
+        StartTick(ROUND_UP_DIV(static_cast<uint64_t>(timeoutMs) * 1000, m_usPerTick), type);
+    }
+}
+
+void Timer::StartUs(uint32_t timeoutUs, Type type) {
+    // Rounds up without the overflow of ROUND_UP_DIV() near UINT32_MAX.
+    StartTick((timeoutUs / m_usPerTick) + ((timeoutUs % m_usPerTick) ? 1 : 0), type);
+}
+
+void Timer::StartTick(uint32_t timeoutTick, Type type) {
     QActive *act = Fw::GetContainer(m_hsmn);
-    FW_ASSERT(act && (type < INVALID) && (m_msPerTick > 0));
-    QTimeEvtCtr timeoutTick = ROUND_UP_DIV(timeoutMs, m_msPerTick);
+    FW_ASSERT(act && (type < INVALID) && (m_usPerTick > 0));
+#ifdef ENABLE_FW_TIMER_WHEEL
+    m_entry.act = act;
+    m_wheel[m_tickRate].Arm(m_entry, timeoutTick, (type == ONCE) ? 0 : timeoutTick);
+#else
     if (type == ONCE) {
         QTimeEvt::postIn(act, timeoutTick);
     } else {
         QTimeEvt::postEvery(act, timeoutTick);
     }
+#endif
+    // Armed first, so the tick source cannot stop itself after being started here.
+    BspStartTick(m_tickRate);
 }
 
 void Timer::Restart(uint32_t timeoutMs, Type type) {
@@ -80,7 +110,11 @@ void Timer::Stop() {
     // Doesn't care what disarm returns. For a periodic timer, even when it is still armed
     // a previous timeout event might still be in event queue and must be removed.
     // In any cases we need to purge residue timer events in event queue.
+#ifdef ENABLE_FW_TIMER_WHEEL
+    m_wheel[m_tickRate].Disarm(m_entry);
+#else
     QTimeEvt::disarm();
+#endif
     QActive *act = Fw::GetContainer(m_hsmn);
     FW_ASSERT(act);
     QEQueue *queue = &act->m_eQueue;
@@ -116,5 +150,31 @@ void Timer::Stop() {
     QF_CRIT_EXIT(crit);
 }
 
+bool Timer::IsIdle(uint8_t tickRate) {
+    FW_ASSERT(tickRate < QF_MAX_TICK_RATE);
+#ifdef ENABLE_FW_TIMER_WHEEL
+    if (!m_wheel[tickRate].IsEmpty()) {
+        return false;
+    }
+#endif
+    return QF::noTimeEvtsActiveX(tickRate);
+}
+
+#ifdef ENABLE_FW_TIMER_WHEEL
+void Timer::Tick(uint8_t tickRate) {
+    FW_ASSERT(tickRate < QF_MAX_TICK_RATE);
+    m_wheel[tickRate].Tick();
+}
+
+uint32_t Timer::NextTick(uint8_t tickRate) {
+    FW_ASSERT(tickRate < QF_MAX_TICK_RATE);
+    return m_wheel[tickRate].NextTick();
+}
+
+void Timer::SkipTick(uint8_t tickRate, uint32_t nTicks) {
+    FW_ASSERT(tickRate < QF_MAX_TICK_RATE);
+    m_wheel[tickRate].SkipTick(nTicks);
+}
+#endif
 
 } // namespace FW
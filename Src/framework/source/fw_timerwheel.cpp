@@ -0,0 +1,200 @@
+/*******************************************************************************
+ * Copyright (C) 2018 Gallium Studio LLC (Lawrence Lo). All rights reserved.
+ *
+ * This program is open source software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * Alternatively, this program may be distributed and modified under the
+ * terms of Gallium Studio LLC commercial licenses, which expressly supersede
+ * the GNU General Public License and are specifically designed for licensees
+ * interested in retaining the proprietary status of their code.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ * Contact information:
+ * Website - https://www.galliumstudio.com
+ * Source repository - https://github.com/galliumstudio
+ * Email - admin@galliumstudio.com
+ ******************************************************************************/
+
+#include <string.h>
+#include "fw_timerwheel.h"
+#include "fw_assert.h"
+
+FW_DEFINE_THIS_FILE("fw_timerwheel.cpp")
+
+using namespace QP;
+
+namespace FW {
+
+TimerWheel::TimerWheel() : m_now(0), m_armedCount(0) {
+    memset(m_slot, 0, sizeof(m_slot));
+}
+
+void TimerWheel::Arm(Entry &entry, uint32_t nTicks, uint32_t interval) {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    FW_ASSERT(!entry.IsArmed() && (nTicks > 0) && entry.act && entry.evt);
+    entry.expire = m_now + nTicks;
+    entry.interval = interval;
+    Insert(entry);
+    m_armedCount++;
+    QF_CRIT_EXIT(crit);
+}
+
+bool TimerWheel::Disarm(Entry &entry) {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    bool armed = entry.IsArmed();
+    if (armed) {
+        Remove(entry);
+        m_armedCount--;
+    }
+    QF_CRIT_EXIT(crit);
+    return armed;
+}
+
+void TimerWheel::Tick() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    ++m_now;
+    CascadeDue();
+    // Every entry in the current slot of level 0 expires on this tick.
+    Entry **head = &m_slot[0][m_now & SLOT_MASK];
+    Entry *entry;
+    while ((entry = *head) != NULL) {
+        FW_ASSERT(entry->expire == m_now);
+        Remove(*entry);
+        if (entry->interval) {
+            entry->expire += entry->interval;
+            Insert(*entry);
+        } else {
+            m_armedCount--;
+        }
+        QActive *act = entry->act;
+        QEvt const *evt = entry->evt;
+        // Exits the critical section before posting, as QF::tickX_() does.
+        QF_CRIT_EXIT(crit);
+        act->POST(evt, this);
+        QF_CRIT_ENTRY(crit);
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+// Slots of a level are in order of expiry starting from the one after the current slot, so only the entries of
+// the first non-empty slot of each level are visited. That does not hold for the top level, where timeouts beyond
+// the wheel range are parked, so all its slots are visited.
+uint32_t TimerWheel::NextTick() {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    uint32_t next = 0;
+    for (uint8_t level = 0; level < LEVEL_COUNT; level++) {
+        uint32_t index = m_now >> (SLOT_BITS * level);
+        for (uint32_t i = 1; i <= SLOT_COUNT; i++) {
+            Entry const *entry = m_slot[level][(index + i) & SLOT_MASK];
+            if (entry) {
+                for (; entry; entry = entry->next) {
+                    uint32_t delta = entry->expire - m_now;
+                    if ((next == 0) || (delta < next)) {
+                        next = delta;
+                    }
+                }
+                if (level < (LEVEL_COUNT - 1)) {
+                    break;
+                }
+            }
+        }
+    }
+    QF_CRIT_EXIT(crit);
+    return next;
+}
+
+// Jumps from one wrap-around of level 0 to the next, since the slots in between are empty.
+void TimerWheel::SkipTick(uint32_t nTicks) {
+    QF_CRIT_STAT_TYPE crit;
+    QF_CRIT_ENTRY(crit);
+    uint32_t target = m_now + nTicks;
+    while (m_now != target) {
+        uint32_t step = SLOT_COUNT - (m_now & SLOT_MASK);
+        if (step > (target - m_now)) {
+            m_now = target;
+            break;
+        }
+        m_now += step;
+        CascadeDue();
+    }
+    QF_CRIT_EXIT(crit);
+}
+
+void TimerWheel::Insert(Entry &entry) {
+    uint32_t expire = entry.expire;
+    uint32_t delta = expire - m_now;
+    if (delta > MAX_DELTA) {
+        delta = MAX_DELTA;
+        expire = m_now + MAX_DELTA;
+    }
+    uint8_t level = 0;
+    while (delta >= (1UL << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    Entry **head = &m_slot[level][(expire >> (SLOT_BITS * level)) & SLOT_MASK];
+    entry.next = *head;
+    if (entry.next) {
+        entry.next->pprev = &entry.next;
+    }
+    entry.pprev = head;
+    *head = &entry;
+}
+
+void TimerWheel::Remove(Entry &entry) {
+    *entry.pprev = entry.next;
+    if (entry.next) {
+        entry.next->pprev = entry.pprev;
+    }
+    entry.next = NULL;
+    entry.pprev = NULL;
+}
+
+// A level cascades when the slot index of the level below wraps around.
+void TimerWheel::CascadeDue() {
+    for (uint8_t level = 1; level < LEVEL_COUNT; level++) {
+        if ((m_now >> (SLOT_BITS * (level - 1))) & SLOT_MASK) {
+            break;
+        }
+        Cascade(level);
+    }
+}
+
+// Moves the entries of the current slot of level to lower levels. Entries parked in the top level may be
+// re-inserted into it.
+void TimerWheel::Cascade(uint8_t level) {
+    Entry **head = &m_slot[level][(m_now >> (SLOT_BITS * level)) & SLOT_MASK];
+    Entry *entry = *head;
+    *head = NULL;
+    while (entry) {
+        Entry *next = entry->next;
+        Insert(*entry);
+        entry = next;
+    }
+}
+
+} // namespace FW
@@ -50,7 +50,11 @@ using namespace QP;
 
 namespace FW {
 
+XThread *XThread::m_xthread[QF_MAX_ACTIVE + 1];
+
 void XThread::Start(uint8_t prio) {
+    FW_ASSERT((prio > 0) && (prio <= QF_MAX_ACTIVE) && !m_xthread[prio]);
+    m_xthread[prio] = this;
     m_tlsNewLib = _REENT_INIT(m_tlsNewLib);
     m_thread = &m_tlsNewLib;
     // OnRun() needs to be called here instead of at the beginning of the thread (started by start()).
@@ -60,17 +64,21 @@ void XThread::Start(uint8_t prio) {
     start(prio, m_evtQueueStor, ARRAY_COUNT(m_evtQueueStor), m_stackSto, sizeof(m_stackSto));
 }
 
-void XThread::Add(Region *reg) {
+XThread *XThread::Get(uint8_t prio) {
+    FW_ASSERT(prio <= QF_MAX_ACTIVE);
+    return m_xthread[prio];
+}
+
+void XThread::Add(RegionBase *reg) {
     FW_ASSERT(reg);
     Hsmn regHsmn = reg->GetHsmn();
     FW_ASSERT(regHsmn != HSM_UNDEF);
-    HsmnReg *existing = m_hsmnRegMap.GetByKey(regHsmn);
-    FW_ASSERT(existing == NULL);
-    m_hsmnRegMap.Save(HsmnReg(regHsmn, reg));
+    m_hsmnRegTable.Add(regHsmn, reg);
     Fw::Add(regHsmn, &reg->GetHsm(), this);
 }
 
 void XThread::Dispatch(QEvt const * const e) {
+    FW_LAT_DISPATCH(this, e);
     Hsmn hsmn;
     // Discard event if it is sent to an undefined HSM.
     // This happens when a timer event already posted is canceled.
@@ -84,9 +92,9 @@ void XThread::Dispatch(QEvt const * const e) {
         Evt const *evt = static_cast<Evt const *>(e);
         hsmn = evt->GetTo();
     }
-    HsmnReg *hsmnReg = m_hsmnRegMap.GetByKey(hsmn);
-    if (hsmnReg && hsmnReg->GetValue()) {
-        hsmnReg->GetValue()->Dispatch(e);
+    RegionBase *reg = m_hsmnRegTable.Get(hsmn);
+    if (reg) {
+        reg->Dispatch(e);
     }
 }
 
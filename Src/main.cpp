@@ -132,6 +132,28 @@ static SensorThread sensorThread;
 static WifiThread wifiThread;
 static Node node;
 
+// Event names of all HSMs in flash, indexed by HSMN (see fw_evtSet.h). Each HSM in APP_HSM defines its event set
+// via DEFINE_EVT_NAME() or DEFINE_NO_EVT_NAME(). A missing or duplicate definition is a link error.
+Q_ASSERT_COMPILE(static_cast<uint32_t>(HSM_COUNT) <= MAX_HSM_COUNT);
+
+#undef ADD_HSM
+#define ADD_HSM(hsmn_, count_) extern EvtSet const EVT_SET(hsmn_);
+namespace APP {
+APP_HSM
+}
+
+#undef ADD_HSM
+#define ADD_HSM(hsmn_, count_) table.Add(hsmn_, &EVT_SET(hsmn_));
+static constexpr EvtSetTable MakeEvtSetTable() {
+    EvtSetTable table;
+    APP_HSM
+    return table;
+}
+
+namespace FW {
+extern constexpr EvtSetTable evtSetTable = MakeEvtSetTable();
+}
+
 /* Private function prototypes -----------------------------------------------*/
 static void SystemClock_Config(void);
 static void Error_Handler(void);
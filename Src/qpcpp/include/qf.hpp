@@ -536,6 +536,18 @@ public:
     //! Cleanup QF callback.
     static void onCleanup(void);
 
+    // Gallium - Callback invoked by gc() before a dynamic event is recycled,
+    //           outside critical section. Returns true if it has recycled
+    //           the event, which it must do for events from pools managed
+    //           by the application (see initDynEvt()). See fw.cpp.
+    static bool onGc(QEvt const * const e) noexcept;
+
+    // Gallium - Marks a block from a pool managed by the application as a
+    //           dynamic event. poolId must be above the pools registered
+    //           with poolInit(). It is recycled by onGc().
+    static void initDynEvt(QEvt * const e,
+                           std::uint_fast8_t const poolId) noexcept;
+
     //! Function invoked by the application layer to stop the QF
     //! application and return control to the OS/Kernel.
     static void stop(void);
@@ -558,6 +570,18 @@ public:
     //! any time event is active.
     static bool noTimeEvtsActiveX(std::uint_fast8_t const tickRate) noexcept;
 
+    // Gallium - Returns the number of ticks until the earliest armed time
+    //           event at tickRate expires, or 0 if none is armed. For
+    //           tickless idle (see bsp.cpp). Must be called in critical
+    //           section.
+    static QTimeEvtCtr nextTickX(std::uint_fast8_t const tickRate) noexcept;
+
+    // Gallium - Accounts for nTicks ticks of tickRate that were skipped
+    //           while idle. nTicks must be less than nextTickX(), so no
+    //           time event expires. Must be called in critical section.
+    static void skipTickX(std::uint_fast8_t const tickRate,
+                          QTimeEvtCtr const nTicks) noexcept;
+
     //! This function returns the minimum of free entries of the given
     //! event pool.
     static std::uint_fast16_t getPoolMin(std::uint_fast8_t const poolId)
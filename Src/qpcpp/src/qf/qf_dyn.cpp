@@ -111,6 +111,18 @@ void QF::poolInit(void * const poolSto,
 #endif // Q_SPY
 }
 
+//****************************************************************************
+// Gallium - See qf.hpp.
+void QF::initDynEvt(QEvt * const e,
+                    std::uint_fast8_t const poolId) noexcept
+{
+    /// @pre the pool ID must not be used by a QF pool
+    Q_REQUIRE_ID(350, (e != nullptr) && (poolId > QF_maxPool_)
+                      && (poolId <= 0xFFU));
+    e->poolId_ = static_cast<std::uint8_t>(poolId);
+    e->refCtr_ = 0U;
+}
+
 //****************************************************************************
 /// @description
 /// Allocates an event dynamically from one of the QF event pools.
@@ -252,6 +264,12 @@ void QF::gc(QEvt const * const e) noexcept {
 
             QF_CRIT_X_();
 
+            // Gallium - Releases resources held by the event (e.g. payload),
+            //           and recycles events from application pools.
+            if (onGc(e)) {
+                return;
+            }
+
             // pool ID must be in range
             Q_ASSERT_ID(410, idx < QF_maxPool_);
 
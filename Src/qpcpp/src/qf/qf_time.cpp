@@ -217,6 +217,45 @@ bool QF::noTimeEvtsActiveX(std::uint_fast8_t const tickRate) noexcept {
     return inactive;
 }
 
+//****************************************************************************
+// Gallium - See qf.hpp. Both the main list and the list of time events armed
+//           since the last tick are visited. Disarmed time events that are
+//           still linked have a counter of 0 and are skipped.
+QTimeEvtCtr QF::nextTickX(std::uint_fast8_t const tickRate) noexcept {
+    Q_REQUIRE_ID(250, tickRate < QF_MAX_TICK_RATE);
+    QTimeEvtCtr next = 0U;
+    QTimeEvt const * const list[2] = { timeEvtHead_[tickRate].m_next,
+                                       timeEvtHead_[tickRate].toTimeEvt() };
+    for (std::uint_fast8_t i = 0U; i < 2U; ++i) {
+        for (QTimeEvt const *t = list[i]; t != nullptr; t = t->m_next) {
+            QTimeEvtCtr const ctr = t->m_ctr;
+            if ((ctr != 0U) && ((next == 0U) || (ctr < next))) {
+                next = ctr;
+            }
+        }
+    }
+    return next;
+}
+
+//****************************************************************************
+// Gallium - See qf.hpp.
+void QF::skipTickX(std::uint_fast8_t const tickRate,
+                   QTimeEvtCtr const nTicks) noexcept
+{
+    Q_REQUIRE_ID(260, tickRate < QF_MAX_TICK_RATE);
+    QTimeEvt * const list[2] = { timeEvtHead_[tickRate].m_next,
+                                 timeEvtHead_[tickRate].toTimeEvt() };
+    for (std::uint_fast8_t i = 0U; i < 2U; ++i) {
+        for (QTimeEvt *t = list[i]; t != nullptr; t = t->m_next) {
+            QTimeEvtCtr const ctr = t->m_ctr;
+            if (ctr != 0U) {
+                Q_ASSERT_ID(270, ctr > nTicks);
+                t->m_ctr = ctr - nTicks;
+            }
+        }
+    }
+}
+
 //****************************************************************************
 /// @description
 /// When creating a time event, you must commit it to a specific active object
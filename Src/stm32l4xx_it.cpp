@@ -78,6 +78,7 @@
 #include "Sensor.h"
 #include "Wifi.h"
 #include "fw_log.h"
+#include "fw_timer.h"
 
 /* USER CODE BEGIN 0 */
 
@@ -105,10 +106,30 @@ extern "C" void SysTick_Handler(void){
   /* USER CODE BEGIN SysTick_IRQn 1 */
   QXK_ISR_ENTRY();
   QP::QF::tickX_(TICK_RATE_BSP);
+  FW_TIMER_TICK(TICK_RATE_BSP);
   QXK_ISR_EXIT();
   /* USER CODE END SysTick_IRQn 1 */
 }
 
+// TICK_RATE_FAST. TIM6 only runs while timers are armed at this rate (see BspStartTick() in bsp.cpp).
+extern "C" void TIM6_DAC_IRQHandler(void) {
+  uint32_t entryCycle = GetCycleCount();
+  QXK_ISR_ENTRY();
+  TIM6->SR = ~TIM_SR_UIF;
+  QP::QF::tickX_(TICK_RATE_FAST);
+  FW_TIMER_TICK(TICK_RATE_FAST);
+  BspFastTickDone(entryCycle);
+  QXK_ISR_EXIT();
+}
+
+#ifdef ENABLE_BSP_TICKLESS
+// The LPTIM1 interrupt only wakes up the CPU from tickless idle, which clears it before interrupts are re-enabled
+// (see TicklessIdle() in bsp.cpp). This is a fallback.
+extern "C" void LPTIM1_IRQHandler(void) {
+  LPTIM1->ICR = LPTIM_ICR_ARRMCF;
+}
+#endif
+
 /******************************************************************************/
 /* STM32F7xx Peripheral Interrupt Handlers                                    */
 /* Add here the Interrupt Handlers for the used peripherals.                  */
@@ -125,6 +146,16 @@ void HandleUartIrq(Hsmn hsmn) {
     UartIn::HwError error = UartIn::HW_ERROR_NONE;
     UART_HandleTypeDef *hal = UartAct::GetHal(hsmn);
     volatile uint32_t isrflags   = READ_REG(hal->Instance->ISR);
+#ifdef ENABLE_BSP_TICKLESS
+    if (isrflags & USART_ISR_WUF) {
+        // Wakeup from STOP1 on a received byte (see UartIn::EnableStopWakeup()). DMA reads it from RDR.
+        __HAL_UART_CLEAR_FLAG(hal, UART_CLEAR_WUF);
+        if (!(isrflags & (USART_ISR_NE | USART_ISR_FE | USART_ISR_ORE)) &&
+            !READ_BIT(hal->Instance->CR1, USART_CR1_RXNEIE)) {
+            return;
+        }
+    }
+#endif
     if (isrflags & USART_ISR_NE) {
         // START bit Noise detection flag. Must clear it or it will cause ISR to be re-entered.
         __HAL_UART_CLEAR_NEFLAG(hal);